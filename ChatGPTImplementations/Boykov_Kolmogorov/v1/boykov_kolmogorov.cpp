@@ -1,11 +1,14 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include <queue>
 #include <limits>
 #include <chrono>
 #include <fstream>
 #include <algorithm> 
 
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
@@ -192,24 +195,30 @@ long long boykovKolmogorovMaxFlow(Graph& graph, int source, int sink) {
     return maxFlow;
 }
 
-void readDIMACS(ifstream& file, Graph& graph, int& nodes, int& edges) {
-    file >> ws;
-    while (file.peek() == 'c' || file.peek() == 'n')
-        file.ignore(numeric_limits<streamsize>::max(), '\n'); 
+// Nach dem Maximalfluss: cut[v] = 1, wenn v im Restgraphen von der Quelle aus erreichbar ist,
+// also auf der Quellseite des minimalen Schnitts liegt
+void getCut(Graph& graph, int source, vector<uint8_t>& cut) {
+    cut.assign(graph.size(), 0);
+    vector<int> queue{source};
+    cut[source] = 1;
+    for (size_t i = 0; i < queue.size(); ++i) {
+        for (const Edge& edge : graph[queue[i]]) {
+            if (!cut[edge.to] && edge.capacity > 0) {
+                cut[edge.to] = 1;
+                queue.push_back(edge.to);
+            }
+        }
+    }
+}
 
-    string p, max;
-    file >> p >> max >> nodes >> edges;
+void readDIMACS(const string& fname, Graph& graph, int& nodes, int& edges) {
+    DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+    nodes = dimacs.num_nodes;
+    edges = dimacs.num_arcs;
 
     graph = Graph(nodes);
-
-    int u, v;
-    long long capacity;
-    for (int i = 0; i < edges; ++i) {
-        file >> ws;
-        while (file.peek() == 'c' || file.peek() == 'n')
-            file.ignore(numeric_limits<streamsize>::max(), '\n'); 
-        file >> p >> u >> v >> capacity;
-        graph.addEdge(u - 1, v - 1, capacity); 
+    for (const auto& arc : dimacs.arcs) {
+        graph.addEdge(arc.from - 1, arc.to - 1, arc.cap);
     }
 }
 
@@ -219,19 +228,18 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream inputFile(argv[1]);
-    if (!inputFile.is_open()) {
-        cerr << "Error: Could not open file " << argv[1] << endl;
-        return 1;
-    }
-
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
     int nodes, edges;
 
     Graph graph(0);
-    readDIMACS(inputFile, graph, nodes, edges);
+    try {
+        readDIMACS(argv[1], graph, nodes, edges);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
 
     int source = 0; 
     int sink = 1;   
@@ -243,8 +251,18 @@ int main(int argc, char* argv[]) {
     auto duration = duration_cast<microseconds>(stop - start);
     double seconds = duration.count() / 1e6;
 
+    vector<uint8_t> cut;
+    auto cutStart = high_resolution_clock::now();
+    getCut(graph, source, cut);
+    auto cutStop = high_resolution_clock::now();
+    double cutSeconds = duration_cast<microseconds>(cutStop - cutStart).count() / 1e6;
+
     cout << "Maximaler Fluss: " << maxFlow << endl;
     cout << "Berechnungsdauer: " << seconds << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cutSeconds << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -1,81 +1,96 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <cstdint>
 #include <queue>
 #include <climits>
 #include <chrono>
 #include <stack>
 #include <memory>
+#include <algorithm>
+
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
 
 using namespace std;
 using namespace std::chrono;
 
 struct Edge {
-    int to, rev;
+    int to, rev; // rev is the index of the reverse edge in the edge array
     long long cap, flow;
 };
 
-class EdgePool {
-public:
-    EdgePool() : pool_size(1000), pool_position(0), current_pool_index(-1) {}
-
-    Edge* allocate(size_t size) {
-        if (current_pool_index == -1 || pool_position + size > pool_size) {
-            expand_pool(size);
-        }
-        Edge* ptr = pools[current_pool_index].get() + pool_position;
-        pool_position += size;
-        return ptr;
-    }
-
-private:
-    void expand_pool(size_t size) {
-        pool_size = max(size, pool_size * 2);
-        current_pool_index++;
-        pool_position = 0;
-        pools.push_back(make_unique<Edge[]>(pool_size));
-    }
-
-    vector<unique_ptr<Edge[]>> pools;
-    size_t pool_size;
-    size_t pool_position;
-    int current_pool_index;
+struct Arc {
+    int u, v;
+    long long cap;
 };
 
 class Dinic {
 public:
-    Dinic(int n, int m) : n(n), adj(n), level(n), ptr(n), edge_pool() {
-        for (auto &vec : adj) {
-            vec.reserve(m / n); // Reserve space based on average number of edges per node
-        }
+    Dinic(int n, int m) : n(n), first(n + 1), level(n), ptr(n) {
+        arcs.reserve(m);
     }
 
+    // Arcs are only collected here, the edges are laid out by build
     void add_edge(int u, int v, long long cap) {
-        Edge* e1 = edge_pool.allocate(1);
-        Edge* e2 = edge_pool.allocate(1);
-        *e1 = {v, static_cast<int>(adj[v].size()), cap, 0};
-        *e2 = {u, static_cast<int>(adj[u].size()), 0, 0};
-        adj[u].push_back(*e1);
-        adj[v].push_back(*e2);
+        arcs.push_back({u, v, cap});
+    }
+
+    // Lay out the edges of all arcs in one block, grouped by node: the first
+    // pass counts the edges of each node, the second places every arc and its
+    // reverse edge at the next free slot of their nodes
+    void build() {
+        fill(first.begin(), first.end(), 0);
+        for (const auto& a : arcs) {
+            first[a.u + 1]++;
+            first[a.v + 1]++;
+        }
+        for (int u = 0; u < n; ++u) {
+            first[u + 1] += first[u];
+        }
+        edges = make_unique<Edge[]>(first[n]);
+        vector<int> pos(first.begin(), first.end() - 1);
+        for (const auto& a : arcs) {
+            int i = pos[a.u]++;
+            int j = pos[a.v]++;
+            edges[i] = {a.v, j, a.cap, 0};
+            edges[j] = {a.u, i, 0, 0};
+        }
+        vector<Arc>().swap(arcs);
     }
 
     long long max_flow(int s, int t) {
         long long flow = 0;
         while (bfs(s, t)) {
-            fill(ptr.begin(), ptr.end(), 0);
-            long long pushed;
-            while ((pushed = dfs(s, t, LLONG_MAX)) != 0) {
-                flow += pushed;
-            }
+            copy(first.begin(), first.end() - 1, ptr.begin());
+            flow += blocking_flow(s, t);
         }
         return flow;
     }
 
+    // After max_flow: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        cut.assign(n, 0);
+        vector<int> q{s};
+        cut[s] = 1;
+        for (size_t i = 0; i < q.size(); ++i) {
+            for (int k = first[q[i]]; k < first[q[i] + 1]; ++k) {
+                const Edge& e = edges[k];
+                if (!cut[e.to] && e.flow < e.cap) {
+                    cut[e.to] = 1;
+                    q.push_back(e.to);
+                }
+            }
+        }
+    }
+
 private:
     int n;
-    vector<vector<Edge>> adj;
-    vector<int> level, ptr;
-    EdgePool edge_pool;
+    vector<Arc> arcs; // Arcs added since the last build
+    unique_ptr<Edge[]> edges; // All edges, those of node u in [first[u], first[u + 1])
+    vector<int> first;
+    vector<int> level, ptr; // ptr[u] is the current arc of u, an index into edges
+    vector<int> path; // Nodes on the current path of blocking_flow
 
     bool bfs(int s, int t) {
         queue<int> q;
@@ -85,7 +100,8 @@ private:
         while (!q.empty() && level[t] == -1) {
             int u = q.front();
             q.pop();
-            for (const auto& e : adj[u]) {
+            for (int k = first[u]; k < first[u + 1]; ++k) {
+                const Edge& e = edges[k];
                 if (level[e.to] == -1 && e.flow < e.cap) {
                     level[e.to] = level[u] + 1;
                     q.push(e.to);
@@ -95,36 +111,53 @@ private:
         return level[t] != -1;
     }
 
-    long long dfs(int u, int t, long long flow) {
-        if (flow == 0) return 0;
-        if (u == t) return flow;
-
-        for (int& i = ptr[u]; i < adj[u].size(); ++i) {
-            Edge& e = adj[u][i];
-            if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
-                long long pushed = dfs(e.to, t, min(flow, e.cap - e.flow));
-                if (pushed > 0) {
+    // Blocking flow of one phase, found with an explicit stack instead of
+    // recursion. path holds the nodes from s to u, each leaving over its
+    // current arc ptr[x]. After an augmentation the search retreats only to
+    // the tail of the first saturated arc, and a node is a dead end once its
+    // current arc has passed its last edge
+    long long blocking_flow(int s, int t) {
+        long long total = 0;
+        path.clear();
+        int u = s;
+        while (true) {
+            if (u == t) {
+                long long pushed = LLONG_MAX;
+                for (int x : path) {
+                    const Edge& e = edges[ptr[x]];
+                    pushed = min(pushed, e.cap - e.flow);
+                }
+                size_t bottleneck = path.size();
+                for (size_t k = 0; k < path.size(); ++k) {
+                    Edge& e = edges[ptr[path[k]]];
                     e.flow += pushed;
-                    adj[e.to][e.rev].flow -= pushed;
-                    return pushed;
+                    edges[e.rev].flow -= pushed;
+                    if (bottleneck == path.size() && e.flow == e.cap) {
+                        bottleneck = k;
+                    }
                 }
-            }
-        }
-
-        // Only mark the node as non-productive if all outgoing edges are fully utilized
-        bool productive = false;
-        for (const auto& e : adj[u]) {
-            if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
-                productive = true;
+                total += pushed;
+                u = path[bottleneck];
+                path.resize(bottleneck);
+            } else if (ptr[u] < first[u + 1]) {
+                const Edge& e = edges[ptr[u]];
+                if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
+                    path.push_back(u);
+                    u = e.to;
+                } else {
+                    ++ptr[u];
+                }
+            } else if (u == s) {
                 break;
+            } else {
+                // Dynamic level graph update: no arc can reach u any more
+                level[u] = -1;
+                u = path.back();
+                path.pop_back();
+                ++ptr[u];
             }
         }
-
-        if (!productive) {
-            level[u] = -1;
-        }
-
-        return 0;
+        return total;
     }
 };
 
@@ -134,39 +167,23 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Could not open file " << argv[1] << endl;
+    DimacsGraph<long long> graph;
+    try {
+        graph = read_dimacs_arcs<long long>(argv[1]);
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
         return 1;
     }
 
-    int n, m;
-    infile >> ws;
-    string line;
-    while (getline(infile, line)) {
-        if (line[0] == 'p') {
-            if (sscanf(line.c_str(), "p max %d %d", &n, &m) != 2) {
-                cerr << "Error reading problem line." << endl;
-                return 1;
-            }
-            break;
-        }
+    Dinic dinic(graph.num_nodes, graph.num_arcs);
+    for (const auto& arc : graph.arcs) {
+        dinic.add_edge(arc.from - 1, arc.to - 1, arc.cap); // Convert to 0-indexed
     }
 
-    Dinic dinic(n, m);
-    while (getline(infile, line)) {
-        if (line[0] == 'a') {
-            int u, v;
-            long long cap;
-            if (sscanf(line.c_str(), "a %d %d %lld", &u, &v, &cap) != 3) {
-                cerr << "Error reading edge line." << endl;
-                return 1;
-            }
-            dinic.add_edge(u - 1, v - 1, cap); // Convert to 0-indexed
-        }
-    }
-
-    infile.close();
+    auto build_start = high_resolution_clock::now();
+    dinic.build();
+    auto build_stop = high_resolution_clock::now();
+    auto build_duration = duration_cast<chrono::duration<double>>(build_stop - build_start);
 
     int source = 0; // 1 in DIMACS format
     int sink = 1;   // 2 in DIMACS format
@@ -177,8 +194,19 @@ int main(int argc, char* argv[]) {
 
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    dinic.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << maxFlow << endl;
+    cout << "Aufbaudauer: " << build_duration.count() << " Sekunden" << endl;
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -1,10 +1,13 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <cstdint>
 #include <queue>
 #include <climits>
 #include <chrono>
 
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
@@ -30,18 +33,32 @@ public:
         long long flow = 0;
         while (bfs(s, t)) {
             fill(ptr.begin(), ptr.end(), 0);
-            while (long long pushed = dfs_with_layer_skipping(s, t, LLONG_MAX)) {
-                if (pushed == 0) break; 
-                flow += pushed;
-            }
+            flow += blocking_flow(s, t);
         }
         return flow;
     }
 
+    // After max_flow: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        cut.assign(n, 0);
+        vector<int> q{s};
+        cut[s] = 1;
+        for (size_t i = 0; i < q.size(); ++i) {
+            for (const auto& e : adj[q[i]]) {
+                if (!cut[e.to] && e.flow < e.cap) {
+                    cut[e.to] = 1;
+                    q.push_back(e.to);
+                }
+            }
+        }
+    }
+
 private:
     int n;
     vector<vector<Edge>> adj;
     vector<int> level, ptr;
+    vector<int> path; // Nodes on the current path of blocking_flow
 
     bool bfs(int s, int t) {
         queue<int> q;
@@ -61,22 +78,51 @@ private:
         return level[t] != -1;
     }
 
-    long long dfs_with_layer_skipping(int u, int t, long long flow) {
-        if (flow == 0) return 0;
-        if (u == t) return flow;
-
-        for (; ptr[u] < adj[u].size(); ++ptr[u]) {
-            Edge& e = adj[u][ptr[u]];
-            if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
-                long long pushed = dfs_with_layer_skipping(e.to, t, min(flow, e.cap - e.flow));
-                if (pushed > 0) {
+    // Blocking flow of one phase, found with an explicit stack instead of
+    // recursion. path holds the nodes from s to u, each leaving over its
+    // current arc ptr[x]. After an augmentation the search retreats only to
+    // the tail of the first saturated arc, and a node is a dead end once its
+    // current arc has passed its last edge
+    long long blocking_flow(int s, int t) {
+        long long total = 0;
+        path.clear();
+        int u = s;
+        while (true) {
+            if (u == t) {
+                long long pushed = LLONG_MAX;
+                for (int x : path) {
+                    const Edge& e = adj[x][ptr[x]];
+                    pushed = min(pushed, e.cap - e.flow);
+                }
+                size_t bottleneck = path.size();
+                for (size_t k = 0; k < path.size(); ++k) {
+                    Edge& e = adj[path[k]][ptr[path[k]]];
                     e.flow += pushed;
                     adj[e.to][e.rev].flow -= pushed;
-                    return pushed;
+                    if (bottleneck == path.size() && e.flow == e.cap) {
+                        bottleneck = k;
+                    }
                 }
+                total += pushed;
+                u = path[bottleneck];
+                path.resize(bottleneck);
+            } else if (ptr[u] < adj[u].size()) {
+                const Edge& e = adj[u][ptr[u]];
+                if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
+                    path.push_back(u);
+                    u = e.to;
+                } else {
+                    ++ptr[u];
+                }
+            } else if (u == s) {
+                break;
+            } else {
+                u = path.back();
+                path.pop_back();
+                ++ptr[u];
             }
         }
-        return 0;
+        return total;
     }
 };
 
@@ -86,40 +132,19 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Could not open file " << argv[1] << endl;
+    DimacsGraph<long long> graph;
+    try {
+        graph = read_dimacs_arcs<long long>(argv[1]);
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
         return 1;
     }
 
-    int n, m;
-    infile >> ws;
-    string line;
-    while (getline(infile, line)) {
-        if (line[0] == 'p') {
-            if (sscanf(line.c_str(), "p max %d %d", &n, &m) != 2) {
-                cerr << "Error reading problem line." << endl;
-                return 1;
-            }
-            break;
-        }
+    Dinic dinic(graph.num_nodes, graph.num_arcs);
+    for (const auto& arc : graph.arcs) {
+        dinic.add_edge(arc.from - 1, arc.to - 1, arc.cap);
     }
 
-    Dinic dinic(n, m);
-    while (getline(infile, line)) {
-        if (line[0] == 'a') {
-            int u, v;
-            long long cap;
-            if (sscanf(line.c_str(), "a %d %d %lld", &u, &v, &cap) != 3) {
-                cerr << "Error reading edge line." << endl;
-                return 1;
-            }
-            dinic.add_edge(u - 1, v - 1, cap); 
-        }
-    }
-
-    infile.close();
-
     int source = 0; 
     int sink = 1;   
 
@@ -129,8 +154,18 @@ int main(int argc, char* argv[]) {
 
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    dinic.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << maxFlow << endl;
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -1,11 +1,14 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <queue>
 #include <climits>
 #include <chrono>
 #include <tbb/tbb.h>
-#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
 
 using namespace std;
 using namespace tbb;
@@ -33,83 +36,172 @@ public:
         long long flow = 0;
         while (bfs(s, t)) {
             fill(ptr.begin(), ptr.end(), 0);
-            long long pushed;
-            while ((pushed = dfs(s, t, LLONG_MAX)) != 0) {
-                flow += pushed;
-            }
+            flow += blocking_flow(s, t);
         }
         return flow;
     }
 
+    // After max_flow: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph. Each BFS level is expanded in parallel
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        vector<atomic<uint8_t>> reached(n);
+        reached[s] = 1;
+        vector<int> frontier{s};
+        while (!frontier.empty()) {
+            enumerable_thread_specific<vector<int>> next;
+            parallel_for(blocked_range<size_t>(0, frontier.size()), [&](const blocked_range<size_t>& r) {
+                auto& local = next.local();
+                for (size_t i = r.begin(); i != r.end(); ++i) {
+                    for (const auto& e : adj[frontier[i]]) {
+                        if (e.flow < e.cap && !reached[e.to].load(memory_order_relaxed) &&
+                            !reached[e.to].exchange(1, memory_order_relaxed)) {
+                            local.push_back(e.to);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for (const auto& local : next) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+            }
+        }
+        cut.resize(n);
+        parallel_for(0, n, [&](int v) { cut[v] = reached[v].load(memory_order_relaxed); });
+    }
+
 private:
     int n;
     vector<vector<Edge>> adj;
     vector<int> level, ptr;
-    std::mutex q_mtx; // Mutex to protect queue operations
+    vector<int> path; // Nodes on the current path of blocking_flow
+    vector<int> frontier; // Nodes of the BFS level being expanded
+    enumerable_thread_specific<vector<int>> next; // Nodes of the next level found by each thread
+
+    // A frontier holding more than 1/bottom_up_ratio of the unvisited nodes is
+    // expanded bottom-up
+    static constexpr size_t bottom_up_ratio = 14;
+
+    // Several BFS threads can reach the same node, so its level is read and
+    // set atomically and only the first thread claims it
+    static int load_level(const int& slot) {
+        return __atomic_load_n(&slot, __ATOMIC_RELAXED);
+    }
+
+    static bool claim_level(int& slot, int lvl) {
+        int unvisited = -1;
+        return __atomic_compare_exchange_n(&slot, &unvisited, lvl, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
 
+    // Level-synchronous parallel BFS without locks. Top-down, the frontier
+    // nodes claim their unvisited neighbors with a CAS on level[], so each node
+    // joins the next frontier exactly once. Once the frontier is large, it is
+    // cheaper to go bottom-up: every unvisited node looks for a parent in the
+    // frontier and stops at the first one. Both gather the next frontier in
+    // thread-local buffers, which are copied together at prefix sum offsets
     bool bfs(int s, int t) {
-        concurrent_queue<int> q;
-        q.push(s);
         fill(level.begin(), level.end(), -1);
         level[s] = 0;
-        bool found_sink = false;
-
-        while (!q.empty() && !found_sink) {
-            size_t queue_size = q.unsafe_size();
-            vector<int> nodes(queue_size);
-            for (size_t i = 0; i < queue_size; ++i) {
-                q.try_pop(nodes[i]);
+        frontier.assign(1, s);
+        size_t unvisited = n - 1;
+        for (int lvl = 0; !frontier.empty() && level[t] == -1; ++lvl) {
+            for (auto& local : next) {
+                local.clear();
             }
-
-            parallel_for_each(nodes.begin(), nodes.end(), [&](int u) {
-                for (const auto& e : adj[u]) {
-                    if (level[e.to] == -1 && e.flow < e.cap) {
-                        {
-                            lock_guard<std::mutex> lock(q_mtx);
-                            level[e.to] = level[u] + 1;
-                            q.push(e.to);
+            const bool bottom_up = frontier.size() * bottom_up_ratio > unvisited;
+            if (bottom_up) {
+                parallel_for(blocked_range<int>(0, n), [&](const blocked_range<int>& r) {
+                    auto& local = next.local();
+                    for (int v = r.begin(); v != r.end(); ++v) {
+                        if (level[v] != -1) continue;
+                        for (const auto& e : adj[v]) {
+                            // The arc from the neighbor into v is the reverse of e
+                            const Edge& in = adj[e.to][e.rev];
+                            if (level[e.to] == lvl && in.flow < in.cap) {
+                                local.push_back(v);
+                                break;
+                            }
                         }
-                        if (e.to == t) {
-                            found_sink = true;
+                    }
+                });
+            } else {
+                parallel_for(blocked_range<size_t>(0, frontier.size()), [&](const blocked_range<size_t>& r) {
+                    auto& local = next.local();
+                    for (size_t i = r.begin(); i != r.end(); ++i) {
+                        for (const auto& e : adj[frontier[i]]) {
+                            if (e.flow < e.cap && load_level(level[e.to]) == -1 && claim_level(level[e.to], lvl + 1)) {
+                                local.push_back(e.to);
+                            }
                         }
                     }
-                }
+                });
+            }
+
+            vector<const vector<int>*> parts;
+            vector<size_t> offset{0};
+            for (const auto& local : next) {
+                parts.push_back(&local);
+                offset.push_back(offset.back() + local.size());
+            }
+            frontier.resize(offset.back());
+            parallel_for(size_t(0), parts.size(), [&](size_t i) {
+                copy(parts[i]->begin(), parts[i]->end(), frontier.begin() + offset[i]);
             });
+            if (bottom_up) {
+                // Set only now, so that no node found in this level looked like a parent during the sweep
+                parallel_for(size_t(0), frontier.size(), [&](size_t i) { level[frontier[i]] = lvl + 1; });
+            }
+            unvisited -= frontier.size();
         }
-
         return level[t] != -1;
     }
 
-    long long dfs(int u, int t, long long flow) {
-        if (flow == 0) return 0;
-        if (u == t) return flow;
-
-        for (; ptr[u] < adj[u].size(); ++ptr[u]) {
-            Edge& e = adj[u][ptr[u]];
-            if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
-                long long pushed = dfs(e.to, t, min(flow, e.cap - e.flow));
-                if (pushed > 0) {
+    // Blocking flow of one phase, found with an explicit stack instead of
+    // recursion. path holds the nodes from s to u, each leaving over its
+    // current arc ptr[x]. After an augmentation the search retreats only to
+    // the tail of the first saturated arc, and a node is a dead end once its
+    // current arc has passed its last edge
+    long long blocking_flow(int s, int t) {
+        long long total = 0;
+        path.clear();
+        int u = s;
+        while (true) {
+            if (u == t) {
+                long long pushed = LLONG_MAX;
+                for (int x : path) {
+                    const Edge& e = adj[x][ptr[x]];
+                    pushed = min(pushed, e.cap - e.flow);
+                }
+                size_t bottleneck = path.size();
+                for (size_t k = 0; k < path.size(); ++k) {
+                    Edge& e = adj[path[k]][ptr[path[k]]];
                     e.flow += pushed;
                     adj[e.to][e.rev].flow -= pushed;
-                    return pushed;
+                    if (bottleneck == path.size() && e.flow == e.cap) {
+                        bottleneck = k;
+                    }
                 }
-            }
-        }
-
-        
-        bool productive = false;
-        for (const auto& e : adj[u]) {
-            if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
-                productive = true;
+                total += pushed;
+                u = path[bottleneck];
+                path.resize(bottleneck);
+            } else if (ptr[u] < adj[u].size()) {
+                const Edge& e = adj[u][ptr[u]];
+                if (level[e.to] == level[u] + 1 && e.flow < e.cap) {
+                    path.push_back(u);
+                    u = e.to;
+                } else {
+                    ++ptr[u];
+                }
+            } else if (u == s) {
                 break;
+            } else {
+                // Dynamic level graph update: no arc can reach u any more
+                level[u] = -1;
+                u = path.back();
+                path.pop_back();
+                ++ptr[u];
             }
         }
-
-        if (!productive) {
-            level[u] = -1;
-        }
-
-        return 0;
+        return total;
     }
 };
 
@@ -119,40 +211,19 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Could not open file " << argv[1] << endl;
+    DimacsGraph<long long> graph;
+    try {
+        graph = read_dimacs_arcs<long long>(argv[1]);
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
         return 1;
     }
 
-    int n, m;
-    infile >> ws;
-    string line;
-    while (getline(infile, line)) {
-        if (line[0] == 'p') {
-            if (sscanf(line.c_str(), "p max %d %d", &n, &m) != 2) {
-                cerr << "Error reading problem line." << endl;
-                return 1;
-            }
-            break;
-        }
-    }
-
-    Dinic dinic(n, m);
-    while (getline(infile, line)) {
-        if (line[0] == 'a') {
-            int u, v;
-            long long cap;
-            if (sscanf(line.c_str(), "a %d %d %lld", &u, &v, &cap) != 3) {
-                cerr << "Error reading edge line." << endl;
-                return 1;
-            }
-            dinic.add_edge(u - 1, v - 1, cap); 
-        }
+    Dinic dinic(graph.num_nodes, graph.num_arcs);
+    for (const auto& arc : graph.arcs) {
+        dinic.add_edge(arc.from - 1, arc.to - 1, arc.cap);
     }
 
-    infile.close();
-
     int source = 0; 
     int sink = 1;   
 
@@ -162,8 +233,18 @@ int main(int argc, char* argv[]) {
 
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    dinic.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << maxFlow << endl;
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
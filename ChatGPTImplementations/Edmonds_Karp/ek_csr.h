@@ -0,0 +1,111 @@
+#ifndef EK_CSR_H
+#define EK_CSR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Residual graph in compressed sparse row form, shared by the Edmonds-Karp
+// variants. The arcs leaving node u are [first[u], first[u + 1]), with their
+// head node in head, their residual capacity in res and the index of their
+// reverse arc in rev. Every input arc u->v gets a reverse arc v->u with no
+// capacity, so parallel and anti-parallel input arcs all keep their capacity.
+//
+// A BFS records in parent_arc[v] the arc it reached v over, so an augmenting
+// path is walked back from the sink by arc index, without any lookups.
+class ResidualGraph {
+public:
+    int n;
+    std::vector<int> first;
+    std::vector<int> head;
+    std::vector<int> rev;
+    std::vector<long long> res;
+
+    explicit ResidualGraph(int n = 0) : n(n), first(n + 1, 0) {}
+
+    // Arcs are only collected here, they are laid out by build
+    void add_arc(int u, int v, long long cap) {
+        pending.push_back({u, v, cap});
+    }
+
+    // Lay out all collected arcs in two passes: count the arcs of each node,
+    // then place every arc and its reverse arc at the next free slot of their
+    // tail nodes
+    void build() {
+        std::fill(first.begin(), first.end(), 0);
+        for (const auto& a : pending) {
+            first[a.u + 1]++;
+            first[a.v + 1]++;
+        }
+        for (int u = 0; u < n; ++u) {
+            first[u + 1] += first[u];
+        }
+        head.resize(first[n]);
+        rev.resize(first[n]);
+        res.resize(first[n]);
+        std::vector<int> pos(first.begin(), first.end() - 1);
+        for (const auto& a : pending) {
+            int fwd = pos[a.u]++;
+            int bwd = pos[a.v]++;
+            head[fwd] = a.v;
+            rev[fwd] = bwd;
+            res[fwd] = a.cap;
+            head[bwd] = a.u;
+            rev[bwd] = fwd;
+            res[bwd] = 0;
+        }
+        std::vector<PendingArc>().swap(pending);
+    }
+
+    int tail(int a) const {
+        return head[rev[a]];
+    }
+
+    long long max_capacity() const {
+        long long out = 0;
+        for (long long r : res) {
+            out = std::max(out, r);
+        }
+        return out;
+    }
+
+    // Move delta units of flow over arc a
+    void push(int a, long long delta) {
+        res[a] -= delta;
+        res[rev[a]] += delta;
+    }
+
+    // Move delta units of flow along the path from s to v given by parent_arc
+    void augment(int s, int v, const std::vector<int>& parent_arc, long long delta) {
+        while (v != s) {
+            int a = parent_arc[v];
+            push(a, delta);
+            v = tail(a);
+        }
+    }
+
+    // After the flow is maximal: cut[v] = 1 if v is on the source side of the
+    // minimum cut, i.e. v is reachable from s in the residual graph
+    void get_cut(int s, std::vector<uint8_t>& cut) const {
+        cut.assign(n, 0);
+        std::vector<int> q{s};
+        cut[s] = 1;
+        for (size_t i = 0; i < q.size(); ++i) {
+            for (int a = first[q[i]]; a < first[q[i] + 1]; ++a) {
+                if (!cut[head[a]] && res[a] > 0) {
+                    cut[head[a]] = 1;
+                    q.push_back(head[a]);
+                }
+            }
+        }
+    }
+
+private:
+    struct PendingArc {
+        int u, v;
+        long long cap;
+    };
+    std::vector<PendingArc> pending;
+};
+
+#endif // EK_CSR_H
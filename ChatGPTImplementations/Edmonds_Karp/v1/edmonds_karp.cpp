@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include <queue>
 #include <climits>
 #include <cstring>
@@ -8,6 +9,8 @@
 #include <sstream> 
 #include <iomanip> 
 
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
@@ -69,32 +72,32 @@ public:
         return flow;
     }
 
-    static Graph readDIMACS(istream& in, int& source, int& sink) {
-        string line;
-        int V = 0, E = 0;
-        Graph g(0);
-
-        while (getline(in, line)) {
-            if (line[0] == 'c') continue; 
-
-            istringstream iss(line);
-            char type;
-            iss >> type;
-
-            if (type == 'p') {
-                string temp;
-                iss >> temp >> V >> E; 
-                g = Graph(V); 
-            } else if (type == 'a') {
-                int u, v;
-                long long cap;
-                iss >> u >> v >> cap;
-                g.addEdge(u - 1, v - 1, cap);
+    // After edmondsKarp: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        cut.assign(V, 0);
+        vector<int> q{s};
+        cut[s] = 1;
+        for (size_t i = 0; i < q.size(); ++i) {
+            int cur = q[i];
+            for (int next : adj[cur]) {
+                if (!cut[next] && capacity[cur][next] > 0) {
+                    cut[next] = 1;
+                    q.push_back(next);
+                }
             }
         }
+    }
+
+    static Graph readDIMACS(const string& fname, int& source, int& sink) {
+        DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+        Graph g(dimacs.num_nodes);
+        for (const auto& arc : dimacs.arcs) {
+            g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
+        }
 
-        source = 0; 
-        sink = 1; 
+        source = 0;
+        sink = 1;
         return g;
     }
 };
@@ -105,15 +108,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Fehler beim Öffnen der Datei" << endl;
+    int source = 0, sink = 1;
+    Graph g(0);
+    try {
+        g = Graph::readDIMACS(argv[1], source, sink);
+    } catch (const exception& e) {
+        cerr << "Fehler beim Lesen der Datei: " << e.what() << endl;
         return 1;
     }
 
-    int source = 0, sink = 1;
-    Graph g = Graph::readDIMACS(infile, source, sink);
-
     auto start = high_resolution_clock::now(); 
 
     long long max_flow = g.edmondsKarp(source, sink);
@@ -121,8 +124,18 @@ int main(int argc, char* argv[]) {
     auto stop = high_resolution_clock::now(); 
     auto duration = duration_cast<chrono::duration<double>>(stop - start); 
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6) << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -1,7 +1,7 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include <queue>
-#include <unordered_map>
 #include <climits>
 #include <cstring>
 #include <chrono> 
@@ -9,24 +9,25 @@
 #include <sstream> 
 #include <iomanip> 
 
+#include "../ek_csr.h"
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
 class Graph {
-    int V; 
-    vector<unordered_map<int, long long>> adj; 
+    int V;
+    ResidualGraph residual;
 
 public:
-    Graph(int V) : V(V), adj(V) {}
+    Graph(int V) : V(V), residual(V) {}
 
     void addEdge(int u, int v, long long cap) {
-        adj[u][v] = cap; 
-        (void)adj[v]; 
+        residual.add_arc(u, v, cap);
     }
 
-    long long bfs(int s, int t, vector<int>& parent) {
-        fill(parent.begin(), parent.end(), -1); 
-        parent[s] = s;
+    long long bfs(int s, int t, vector<int>& parent_arc) {
+        fill(parent_arc.begin(), parent_arc.end(), -1);
         queue<pair<int, long long>> q;
         q.push({s, LLONG_MAX});
 
@@ -35,65 +36,50 @@ public:
             long long flow = q.front().second;
             q.pop();
 
-            for (const auto& next : adj[cur]) {
-                if (parent[next.first] == -1 && next.second) { 
-                    parent[next.first] = cur;
-                    long long new_flow = min(flow, next.second);
-                    if (next.first == t) return new_flow; 
-                    q.push({next.first, new_flow});
+            for (int a = residual.first[cur]; a < residual.first[cur + 1]; ++a) {
+                int next = residual.head[a];
+                if (parent_arc[next] == -1 && next != s && residual.res[a] > 0) {
+                    parent_arc[next] = a;
+                    long long new_flow = min(flow, residual.res[a]);
+                    if (next == t) return new_flow;
+                    q.push({next, new_flow});
                 }
             }
         }
 
-        return 0; 
+        return 0;
     }
 
     long long edmondsKarp(int s, int t) {
         long long flow = 0;
-        vector<int> parent(V);
+        vector<int> parent_arc(V);
         long long new_flow;
 
-        while ((new_flow = bfs(s, t, parent)) != 0) {
+        while ((new_flow = bfs(s, t, parent_arc)) != 0) {
             flow += new_flow;
-            int cur = t;
-
-            while (cur != s) {
-                int prev = parent[cur];
-                adj[prev][cur] -= new_flow;
-                adj[cur][prev] += new_flow;
-                cur = prev;
-            }
+            residual.augment(s, t, parent_arc, new_flow);
         }
 
         return flow;
     }
 
-    static Graph readDIMACS(istream& in, int& source, int& sink) {
-        string line;
-        int V = 0, E = 0;
-        Graph g(0); 
-
-        while (getline(in, line)) {
-            if (line[0] == 'c') continue; 
-
-            istringstream iss(line);
-            char type;
-            iss >> type;
-
-            if (type == 'p') {
-                string temp;
-                iss >> temp >> V >> E; 
-                g = Graph(V); 
-            } else if (type == 'a') {
-                int u, v;
-                long long cap;
-                iss >> u >> v >> cap; 
-                g.addEdge(u - 1, v - 1, cap);
-            }
+    // After edmondsKarp: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        residual.get_cut(s, cut);
+    }
+
+    static Graph readDIMACS(const string& fname, int& source, int& sink) {
+        DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+        Graph g(dimacs.num_nodes);
+        for (const auto& arc : dimacs.arcs) {
+            g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
         }
 
-        source = 0; 
-        sink = 1; 
+        g.residual.build();
+
+        source = 0;
+        sink = 1;
         return g;
     }
 };
@@ -104,15 +90,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Fehler beim Öffnen der Datei" << endl;
+    int source = 0, sink = 1;
+    Graph g(0);
+    try {
+        g = Graph::readDIMACS(argv[1], source, sink);
+    } catch (const exception& e) {
+        cerr << "Fehler beim Lesen der Datei: " << e.what() << endl;
         return 1;
     }
 
-    int source = 0, sink = 1;
-    Graph g = Graph::readDIMACS(infile, source, sink);
-
     auto start = high_resolution_clock::now(); 
 
     long long max_flow = g.edmondsKarp(source, sink);
@@ -120,9 +106,19 @@ int main(int argc, char* argv[]) {
     auto stop = high_resolution_clock::now(); 
     auto duration = duration_cast<chrono::duration<double>>(stop - start); 
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6);
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
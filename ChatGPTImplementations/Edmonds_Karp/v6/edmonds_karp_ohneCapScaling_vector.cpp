@@ -1,14 +1,15 @@
 #include <iostream>
 #include <vector>
-#include <queue>
+#include <cstdint>
 #include <climits>
 #include <chrono>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <unordered_map>
 #include <algorithm>
 
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
@@ -16,6 +17,13 @@ class Graph {
     int V;
     vector<vector<pair<int, long long>>> adj;
 
+    // Search state of bidirectionalBFS, allocated once and reused by every search
+    vector<int> parentS, parentT;
+    vector<unsigned> stampS, stampT;
+    vector<long long> flowS, flowT;
+    vector<pair<long long, int>> pqS, pqT;
+    unsigned epoch = 0;
+
 public:
     Graph(int V) : V(V), adj(V) {}
 
@@ -24,67 +32,76 @@ public:
         adj[v].emplace_back(u, 0);
     }
 
-    bool bidirectionalBFS(int s, int t, vector<int>& parentS, vector<int>& parentT, int& meetNode, long long& flow) {
-        fill(parentS.begin(), parentS.end(), -1);
-        fill(parentT.begin(), parentT.end(), -1);
+    // Widest-first search from both ends which stops as soon as the two searches
+    // meet. Each step expands the side with the smaller frontier. A node counts as
+    // reached only if its stamp equals the epoch of the current search, so nothing
+    // has to be reset between searches.
+    bool bidirectionalBFS(int s, int t, int& meetNode, long long& flow) {
+        if (++epoch == 0) {
+            // The stamps wrapped around, old stamps could match again
+            fill(stampS.begin(), stampS.end(), 0);
+            fill(stampT.begin(), stampT.end(), 0);
+            epoch = 1;
+        }
+
+        pqS.clear();
+        pqT.clear();
+        pqS.push_back({LLONG_MAX, s});
+        pqT.push_back({LLONG_MAX, t});
+        stampS[s] = epoch;
+        stampT[t] = epoch;
         parentS[s] = s;
         parentT[t] = t;
-
-        priority_queue<pair<long long, int>, vector<pair<long long, int>>, less<pair<long long, int>>> pqS;
-        priority_queue<pair<long long, int>, vector<pair<long long, int>>, less<pair<long long, int>>> pqT;
-        pqS.push({LLONG_MAX, s});
-        pqT.push({LLONG_MAX, t});
-
-        unordered_map<int, long long> visitedFromS, visitedFromT;
-        visitedFromS[s] = LLONG_MAX;
-        visitedFromT[t] = LLONG_MAX;
+        flowS[s] = LLONG_MAX;
+        flowT[t] = LLONG_MAX;
 
         while (!pqS.empty() && !pqT.empty()) {
-            if (!pqS.empty()) {
-                int curS = pqS.top().second;
-                long long flowS = pqS.top().first;
-                pqS.pop();
+            if (pqS.size() <= pqT.size()) {
+                pop_heap(pqS.begin(), pqS.end());
+                int curS = pqS.back().second;
+                long long curFlow = pqS.back().first;
+                pqS.pop_back();
 
                 for (const auto& next : adj[curS]) {
                     int nextNode = next.first;
                     long long capacity = next.second;
 
-                    if (parentS[nextNode] == -1 && capacity > 0) {
+                    if (stampS[nextNode] != epoch && capacity > 0) {
+                        stampS[nextNode] = epoch;
                         parentS[nextNode] = curS;
-                        long long newFlow = min(flowS, capacity);
-                        if (visitedFromT.count(nextNode)) {
+                        long long newFlow = min(curFlow, capacity);
+                        if (stampT[nextNode] == epoch) {
                             meetNode = nextNode;
-                            flow = min(newFlow, visitedFromT[nextNode]);
+                            flow = min(newFlow, flowT[nextNode]);
                             return true;
                         }
-                        pqS.push({newFlow, nextNode});
-                        visitedFromS[nextNode] = newFlow;
+                        flowS[nextNode] = newFlow;
+                        pqS.push_back({newFlow, nextNode});
+                        push_heap(pqS.begin(), pqS.end());
                     }
                 }
-            }
-
-            if (!pqT.empty()) {
-                int curT = pqT.top().second;
-                long long flowT = pqT.top().first;
-                pqT.pop();
+            } else {
+                pop_heap(pqT.begin(), pqT.end());
+                int curT = pqT.back().second;
+                long long curFlow = pqT.back().first;
+                pqT.pop_back();
 
                 for (const auto& next : adj[curT]) {
                     int nextNode = next.first;
-                    long long capacity = next.second;
 
                     for (const auto& rev : adj[nextNode]) {
-                        if (rev.first == curT && rev.second > 0) {
-                            if (parentT[nextNode] == -1 && rev.second > 0) {
-                                parentT[nextNode] = curT;
-                                long long newFlow = min(flowT, rev.second);
-                                if (visitedFromS.count(nextNode)) {
-                                    meetNode = nextNode;
-                                    flow = min(newFlow, visitedFromS[nextNode]);
-                                    return true;
-                                }
-                                pqT.push({newFlow, nextNode});
-                                visitedFromT[nextNode] = newFlow;
+                        if (rev.first == curT && stampT[nextNode] != epoch && rev.second > 0) {
+                            stampT[nextNode] = epoch;
+                            parentT[nextNode] = curT;
+                            long long newFlow = min(curFlow, rev.second);
+                            if (stampS[nextNode] == epoch) {
+                                meetNode = nextNode;
+                                flow = min(newFlow, flowS[nextNode]);
+                                return true;
                             }
+                            flowT[nextNode] = newFlow;
+                            pqT.push_back({newFlow, nextNode});
+                            push_heap(pqT.begin(), pqT.end());
                         }
                     }
                 }
@@ -96,11 +113,17 @@ public:
 
     long long edmondsKarp(int s, int t) {
         long long flow = 0;
-        vector<int> parentS(V), parentT(V);
+        parentS.assign(V, -1);
+        parentT.assign(V, -1);
+        stampS.assign(V, 0);
+        stampT.assign(V, 0);
+        flowS.assign(V, 0);
+        flowT.assign(V, 0);
+        epoch = 0;
         int meetNode;
         long long new_flow;
 
-        while (bidirectionalBFS(s, t, parentS, parentT, meetNode, new_flow)) {
+        while (bidirectionalBFS(s, t, meetNode, new_flow)) {
             flow += new_flow;
             int cur = meetNode;
 
@@ -150,29 +173,28 @@ public:
         return flow;
     }
 
-    static Graph readDIMACS(istream& in, int& source, int& sink) {
-        string line;
-        int V = 0, E = 0;
-        Graph g(0);
-
-        while (getline(in, line)) {
-            if (line[0] == 'c') continue;
-
-            istringstream iss(line);
-            char type;
-            iss >> type;
-
-            if (type == 'p') {
-                string temp;
-                iss >> temp >> V >> E;
-                g = Graph(V);
-            } else if (type == 'a') {
-                int u, v;
-                long long cap;
-                iss >> u >> v >> cap;
-                g.addEdge(u - 1, v - 1, cap);
+    // After edmondsKarp: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        cut.assign(V, 0);
+        vector<int> q{s};
+        cut[s] = 1;
+        for (size_t i = 0; i < q.size(); ++i) {
+            for (const auto& next : adj[q[i]]) {
+                if (!cut[next.first] && next.second > 0) {
+                    cut[next.first] = 1;
+                    q.push_back(next.first);
+                }
             }
         }
+    }
+
+    static Graph readDIMACS(const string& fname, int& source, int& sink) {
+        DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+        Graph g(dimacs.num_nodes);
+        for (const auto& arc : dimacs.arcs) {
+            g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
+        }
 
         source = 0;
         sink = 1;
@@ -186,15 +208,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Fehler beim Öffnen der Datei" << endl;
+    int source = 0, sink = 1;
+    Graph g(0);
+    try {
+        g = Graph::readDIMACS(argv[1], source, sink);
+    } catch (const exception& e) {
+        cerr << "Fehler beim Lesen der Datei: " << e.what() << endl;
         return 1;
     }
 
-    int source = 0, sink = 1;
-    Graph g = Graph::readDIMACS(infile, source, sink);
-
     auto start = high_resolution_clock::now();
 
     long long max_flow = g.edmondsKarp(source, sink);
@@ -202,9 +224,19 @@ int main(int argc, char* argv[]) {
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6);
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
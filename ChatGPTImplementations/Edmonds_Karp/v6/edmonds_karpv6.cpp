@@ -1,87 +1,109 @@
 #include <iostream>
 #include <vector>
-#include <queue>
-#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
 #include <climits>
 #include <chrono>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 
+#include "../ek_csr.h"
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
 class Graph {
     int V;
-    vector<unordered_map<int, long long>> adj;
+    ResidualGraph residual;
+
+    // Search state of bidirectionalBFS, allocated once and reused by every search
+    vector<int> parentS, parentT;
+    vector<unsigned> stampS, stampT;
+    vector<long long> flowS, flowT;
+    vector<pair<long long, int>> pqS, pqT;
+    unsigned epoch = 0;
 
 public:
-    Graph(int V) : V(V), adj(V) {}
+    Graph(int V) : V(V), residual(V) {}
 
     void addEdge(int u, int v, long long cap) {
-        adj[u][v] = cap;
-        if (adj[v].find(u) == adj[v].end()) {
-            adj[v][u] = 0;  // Ensure v is in the adjacency list with a reverse edge initialized to 0
-        }
+        residual.add_arc(u, v, cap);
     }
 
-    bool bidirectionalBFS(int s, int t, vector<int>& parentS, vector<int>& parentT, long long scale, int& meetNode, long long& flow) {
-        fill(parentS.begin(), parentS.end(), -1);
-        fill(parentT.begin(), parentT.end(), -1);
-        parentS[s] = s;
-        parentT[t] = t;
-
-        priority_queue<pair<long long, int>, vector<pair<long long, int>>, less<pair<long long, int>>> pqS, pqT;
-        pqS.push({LLONG_MAX, s});
-        pqT.push({LLONG_MAX, t});
+    // Widest-first search from both ends which stops as soon as the two searches
+    // meet. Each step expands the side with the smaller frontier.
+    // parentS[v] is the arc the search from s reached v over, parentT[v] the arc
+    // from v towards t over which the search from t reached it. A node counts as
+    // reached only if its stamp equals the epoch of the current search, so nothing
+    // has to be reset between searches.
+    bool bidirectionalBFS(int s, int t, long long scale, int& meetNode, long long& flow) {
+        if (++epoch == 0) {
+            // The stamps wrapped around, old stamps could match again
+            fill(stampS.begin(), stampS.end(), 0);
+            fill(stampT.begin(), stampT.end(), 0);
+            epoch = 1;
+        }
 
-        unordered_map<int, long long> visitedFromS, visitedFromT;
-        visitedFromS[s] = LLONG_MAX;
-        visitedFromT[t] = LLONG_MAX;
+        pqS.clear();
+        pqT.clear();
+        pqS.push_back({LLONG_MAX, s});
+        pqT.push_back({LLONG_MAX, t});
+        stampS[s] = epoch;
+        stampT[t] = epoch;
+        flowS[s] = LLONG_MAX;
+        flowT[t] = LLONG_MAX;
 
         while (!pqS.empty() && !pqT.empty()) {
-            if (!pqS.empty()) {
-                int curS = pqS.top().second;
-                long long flowS = pqS.top().first;
-                pqS.pop();
-
-                for (const auto& next : adj[curS]) {
-                    int nextNode = next.first;
-                    long long capacity = next.second;
-
-                    if (parentS[nextNode] == -1 && capacity >= scale) {
-                        parentS[nextNode] = curS;
-                        long long newFlow = min(flowS, capacity);
-                        if (visitedFromT.count(nextNode)) {
+            if (pqS.size() <= pqT.size()) {
+                pop_heap(pqS.begin(), pqS.end());
+                int curS = pqS.back().second;
+                long long curFlow = pqS.back().first;
+                pqS.pop_back();
+
+                for (int a = residual.first[curS]; a < residual.first[curS + 1]; ++a) {
+                    int nextNode = residual.head[a];
+                    long long capacity = residual.res[a];
+
+                    if (stampS[nextNode] != epoch && capacity >= scale) {
+                        stampS[nextNode] = epoch;
+                        parentS[nextNode] = a;
+                        long long newFlow = min(curFlow, capacity);
+                        if (stampT[nextNode] == epoch) {
                             meetNode = nextNode;
-                            flow = min(newFlow, visitedFromT[nextNode]);
+                            flow = min(newFlow, flowT[nextNode]);
                             return true;
                         }
-                        pqS.push({newFlow, nextNode});
-                        visitedFromS[nextNode] = newFlow;
+                        flowS[nextNode] = newFlow;
+                        pqS.push_back({newFlow, nextNode});
+                        push_heap(pqS.begin(), pqS.end());
                     }
                 }
-            }
-
-            if (!pqT.empty()) {
-                int curT = pqT.top().second;
-                long long flowT = pqT.top().first;
-                pqT.pop();
-
-                for (const auto& next : adj[curT]) {
-                    int nextNode = next.first;
-                    long long capacity = next.second;
-
-                    if (parentT[nextNode] == -1 && adj[nextNode][curT] >= scale) {
-                        parentT[nextNode] = curT;
-                        long long newFlow = min(flowT, adj[nextNode][curT]);
-                        if (visitedFromS.count(nextNode)) {
+            } else {
+                pop_heap(pqT.begin(), pqT.end());
+                int curT = pqT.back().second;
+                long long curFlow = pqT.back().first;
+                pqT.pop_back();
+
+                for (int a = residual.first[curT]; a < residual.first[curT + 1]; ++a) {
+                    int nextNode = residual.head[a];
+                    // The search from t follows arcs backwards, i.e. the reverse of a into curT
+                    int in = residual.rev[a];
+                    long long capacity = residual.res[in];
+
+                    if (stampT[nextNode] != epoch && capacity >= scale) {
+                        stampT[nextNode] = epoch;
+                        parentT[nextNode] = in;
+                        long long newFlow = min(curFlow, capacity);
+                        if (stampS[nextNode] == epoch) {
                             meetNode = nextNode;
-                            flow = min(newFlow, visitedFromS[nextNode]);
+                            flow = min(newFlow, flowS[nextNode]);
                             return true;
                         }
-                        pqT.push({newFlow, nextNode});
-                        visitedFromT[nextNode] = newFlow;
+                        flowT[nextNode] = newFlow;
+                        pqT.push_back({newFlow, nextNode});
+                        push_heap(pqT.begin(), pqT.end());
                     }
                 }
             }
@@ -93,40 +115,28 @@ public:
     long long edmondsKarp(int s, int t) {
         long long flow = 0;
 
-        long long max_capacity = 0;
-        for (int u = 0; u < V; ++u) {
-            for (const auto& edge : adj[u]) {
-                max_capacity = max(max_capacity, edge.second);
-            }
-        }
-
+        long long max_capacity = residual.max_capacity();
         long long scale = 1;
         while (scale <= max_capacity) {
             scale <<= 1;
         }
 
-        vector<int> parentS(V), parentT(V);
+        parentS.assign(V, -1);
+        parentT.assign(V, -1);
+        stampS.assign(V, 0);
+        stampT.assign(V, 0);
+        flowS.assign(V, 0);
+        flowT.assign(V, 0);
+        epoch = 0;
         int meetNode;
         long long new_flow;
 
         while (scale >= 1) {
-            while (bidirectionalBFS(s, t, parentS, parentT, scale, meetNode, new_flow)) {
+            while (bidirectionalBFS(s, t, scale, meetNode, new_flow)) {
                 flow += new_flow;
-                int cur = meetNode;
-
-                while (cur != s) {
-                    int prev = parentS[cur];
-                    adj[prev][cur] -= new_flow;
-                    adj[cur][prev] += new_flow;
-                    cur = prev;
-                }
-
-                cur = meetNode;
-                while (cur != t) {
-                    int prev = parentT[cur];
-                    adj[prev][cur] += new_flow;
-                    adj[cur][prev] -= new_flow;
-                    cur = prev;
+                residual.augment(s, meetNode, parentS, new_flow);
+                for (int cur = meetNode; cur != t; cur = residual.head[parentT[cur]]) {
+                    residual.push(parentT[cur], new_flow);
                 }
             }
             scale >>= 1;
@@ -135,30 +145,21 @@ public:
         return flow;
     }
 
-    static Graph readDIMACS(istream& in, int& source, int& sink) {
-        string line;
-        int V = 0, E = 0;
-        Graph g(0);
-
-        while (getline(in, line)) {
-            if (line[0] == 'c') continue;
-
-            istringstream iss(line);
-            char type;
-            iss >> type;
-
-            if (type == 'p') {
-                string temp;
-                iss >> temp >> V >> E;
-                g = Graph(V);
-            } else if (type == 'a') {
-                int u, v;
-                long long cap;
-                iss >> u >> v >> cap;
-                g.addEdge(u - 1, v - 1, cap);
-            }
+    // After edmondsKarp: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        residual.get_cut(s, cut);
+    }
+
+    static Graph readDIMACS(const string& fname, int& source, int& sink) {
+        DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+        Graph g(dimacs.num_nodes);
+        for (const auto& arc : dimacs.arcs) {
+            g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
         }
 
+        g.residual.build();
+
         source = 0;
         sink = 1;
         return g;
@@ -171,15 +172,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Fehler beim Öffnen der Datei" << endl;
+    int source = 0, sink = 1;
+    Graph g(0);
+    try {
+        g = Graph::readDIMACS(argv[1], source, sink);
+    } catch (const exception& e) {
+        cerr << "Fehler beim Lesen der Datei: " << e.what() << endl;
         return 1;
     }
 
-    int source = 0, sink = 1;
-    Graph g = Graph::readDIMACS(infile, source, sink);
-
     auto start = high_resolution_clock::now();
 
     long long max_flow = g.edmondsKarp(source, sink);
@@ -187,9 +188,19 @@ int main(int argc, char* argv[]) {
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6);
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
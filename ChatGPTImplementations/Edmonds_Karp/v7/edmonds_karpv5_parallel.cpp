@@ -1,7 +1,7 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include <queue>
-#include <unordered_map>
 #include <climits>
 #include <cstring>
 #include <chrono>
@@ -10,24 +10,25 @@
 #include <iomanip>
 #include <omp.h>
 
+#include "../ek_csr.h"
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 using namespace std::chrono;
 
 class Graph {
     int V;
-    vector<unordered_map<int, long long>> adj;
+    ResidualGraph residual;
 
 public:
-    Graph(int V) : V(V), adj(V) {}
+    Graph(int V) : V(V), residual(V) {}
 
     void addEdge(int u, int v, long long cap) {
-        adj[u][v] = cap;
-        (void)adj[v];
+        residual.add_arc(u, v, cap);
     }
 
-    long long bfs(int s, int t, vector<int>& parent, long long scale) {
-        fill(parent.begin(), parent.end(), -1);
-        parent[s] = s;
+    long long bfs(int s, int t, vector<int>& parent_arc, long long scale) {
+        fill(parent_arc.begin(), parent_arc.end(), -1);
 
         priority_queue<pair<long long, int>, vector<pair<long long, int>>, less<pair<long long, int>>> pq;
         pq.push({LLONG_MAX, s});
@@ -37,12 +38,13 @@ public:
             long long flow = pq.top().first;
             pq.pop();
 
-            for (const auto& next : adj[cur]) {
-                if (parent[next.first] == -1 && next.second >= scale) {
-                    parent[next.first] = cur;
-                    long long new_flow = min(flow, next.second);
-                    if (next.first == t) return new_flow;
-                    pq.push({new_flow, next.first});
+            for (int a = residual.first[cur]; a < residual.first[cur + 1]; ++a) {
+                int next = residual.head[a];
+                if (parent_arc[next] == -1 && next != s && residual.res[a] >= scale) {
+                    parent_arc[next] = a;
+                    long long new_flow = min(flow, residual.res[a]);
+                    if (next == t) return new_flow;
+                    pq.push({new_flow, next});
                 }
             }
         }
@@ -52,14 +54,13 @@ public:
 
     long long edmondsKarp(int s, int t) {
         long long flow = 0;
-        vector<int> parent(V);
+        vector<int> parent_arc(V);
 
         long long max_capacity = 0;
+        int num_arcs = residual.res.size();
         #pragma omp parallel for reduction(max:max_capacity)
-        for (int u = 0; u < V; ++u) {
-            for (const auto& edge : adj[u]) {
-                max_capacity = max(max_capacity, edge.second);
-            }
+        for (int a = 0; a < num_arcs; ++a) {
+            max_capacity = max(max_capacity, residual.res[a]);
         }
 
         long long scale = 1;
@@ -70,7 +71,7 @@ public:
         while (scale >= 1) {
             long long new_flow;
             do {
-                new_flow = bfs(s, t, parent, scale);
+                new_flow = bfs(s, t, parent_arc, scale);
                 if (new_flow) {
                     flow += new_flow;
                     int cur = t;
@@ -79,15 +80,15 @@ public:
                         #pragma omp single nowait
                         {
                             while (cur != s) {
-                                int prev = parent[cur];
-                                #pragma omp task firstprivate(prev, cur)
+                                int a = parent_arc[cur];
+                                #pragma omp task firstprivate(a)
                                 {
                                     #pragma omp atomic
-                                    adj[prev][cur] -= new_flow;
+                                    residual.res[a] -= new_flow;
                                     #pragma omp atomic
-                                    adj[cur][prev] += new_flow;
+                                    residual.res[residual.rev[a]] += new_flow;
                                 }
-                                cur = prev;
+                                cur = residual.tail(a);
                             }
                         }
                     }
@@ -99,30 +100,45 @@ public:
         return flow;
     }
 
-    static Graph readDIMACS(istream& in, int& source, int& sink) {
-        string line;
-        int V = 0, E = 0;
-        Graph g(0);
-
-        while (getline(in, line)) {
-            if (line[0] == 'c') continue;
-
-            istringstream iss(line);
-            char type;
-            iss >> type;
-
-            if (type == 'p') {
-                string temp;
-                iss >> temp >> V >> E;
-                g = Graph(V);
-            } else if (type == 'a') {
-                int u, v;
-                long long cap;
-                iss >> u >> v >> cap;
-                g.addEdge(u - 1, v - 1, cap);
+    // After edmondsKarp: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v is reachable from s in the residual graph. The BFS is level-synchronous,
+    // every level is expanded in parallel.
+    void get_cut(int s, vector<uint8_t>& cut) const {
+        cut.assign(V, 0);
+        vector<int> frontier{s}, next_frontier;
+        cut[s] = 1;
+        while (!frontier.empty()) {
+            next_frontier.clear();
+            #pragma omp parallel
+            {
+                vector<int> local_next;
+                #pragma omp for schedule(dynamic, 64) nowait
+                for (size_t i = 0; i < frontier.size(); ++i) {
+                    for (int a = residual.first[frontier[i]]; a < residual.first[frontier[i] + 1]; ++a) {
+                        if (residual.res[a] <= 0) continue;
+                        int next = residual.head[a];
+                        uint8_t was_reached;
+                        #pragma omp atomic capture
+                        { was_reached = cut[next]; cut[next] = 1; }
+                        if (!was_reached) local_next.push_back(next);
+                    }
+                }
+                #pragma omp critical
+                next_frontier.insert(next_frontier.end(), local_next.begin(), local_next.end());
             }
+            swap(frontier, next_frontier);
+        }
+    }
+
+    static Graph readDIMACS(const string& fname, int& source, int& sink) {
+        DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+        Graph g(dimacs.num_nodes);
+        for (const auto& arc : dimacs.arcs) {
+            g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
         }
 
+        g.residual.build();
+
         source = 0;
         sink = 1;
         return g;
@@ -135,15 +151,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Fehler beim Öffnen der Datei" << endl;
+    int source = 0, sink = 1;
+    Graph g(0);
+    try {
+        g = Graph::readDIMACS(argv[1], source, sink);
+    } catch (const exception& e) {
+        cerr << "Fehler beim Lesen der Datei: " << e.what() << endl;
         return 1;
     }
 
-    int source = 0, sink = 1;
-    Graph g = Graph::readDIMACS(infile, source, sink);
-
     auto start = high_resolution_clock::now();
 
     long long max_flow = g.edmondsKarp(source, sink);
@@ -151,9 +167,19 @@ int main(int argc, char* argv[]) {
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(source, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6);
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
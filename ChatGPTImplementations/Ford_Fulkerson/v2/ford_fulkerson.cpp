@@ -1,10 +1,13 @@
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include <cstring>
 #include <climits>
 #include <ctime>
 #include <algorithm>
 
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
+
 using namespace std;
 
 struct Edge {
@@ -54,36 +57,46 @@ int ford_fulkerson(vector<vector<int>>& adj, vector<Edge>& edges, int source, in
     return max_flow;
 }
 
+// After ford_fulkerson: cut[v] = 1 if v is on the source side of the minimum cut,
+// i.e. v is reachable from source in the residual graph
+void get_cut(const vector<vector<int>>& adj, const vector<Edge>& edges, int source, vector<uint8_t>& cut) {
+    cut.assign(adj.size(), 0);
+    vector<int> q{source};
+    cut[source] = 1;
+    for (size_t i = 0; i < q.size(); ++i) {
+        for (int edge_index : adj[q[i]]) {
+            const Edge& edge = edges[edge_index];
+            if (!cut[edge.to] && edge.capacity > edge.flow) {
+                cut[edge.to] = 1;
+                q.push_back(edge.to);
+            }
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     if (argc != 2) {
         cerr << "Usage: " << argv[0] << " input.max" << endl;
         return 1;
     }
 
-    if (!freopen(argv[1], "r", stdin)) {
-        cerr << "Error: Unable to open input file " << argv[1] << endl;
+    DimacsGraph<int> dimacs;
+    try {
+        dimacs = read_dimacs_arcs<int>(argv[1]);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
         return 1;
     }
 
-    int num_nodes, num_edges;
     vector<Edge> edges;
-    vector<vector<int>> adj;
-
-    string line;
-    while (getline(cin, line)) {
-        if (line[0] == 'c') {
-            continue; 
-        } else if (line[0] == 'p') {
-            sscanf(line.c_str(), "p max %d %d", &num_nodes, &num_edges);
-            adj.resize(num_nodes + 1);
-        } else if (line[0] == 'a') {
-            int from, to, capacity;
-            sscanf(line.c_str(), "a %d %d %d", &from, &to, &capacity);
-            edges.push_back({from, to, capacity, 0});
-            edges.push_back({to, from, 0, 0}); 
-            adj[from].push_back(edges.size() - 2);
-            adj[to].push_back(edges.size() - 1);
-        }
+    vector<vector<int>> adj(dimacs.num_nodes + 1);
+    edges.reserve(2 * dimacs.arcs.size());
+    for (const auto& arc : dimacs.arcs) {
+        int from = arc.from, to = arc.to;
+        edges.push_back({from, to, arc.cap, 0});
+        edges.push_back({to, from, 0, 0});
+        adj[from].push_back(edges.size() - 2);
+        adj[to].push_back(edges.size() - 1);
     }
 
     int source = 1, sink = 2;
@@ -94,8 +107,19 @@ int main(int argc, char* argv[]) {
 
     double duration = double(end - start) / CLOCKS_PER_SEC;
 
+    vector<uint8_t> cut;
+    clock_t cut_start = clock();
+    get_cut(adj, edges, source, cut);
+    clock_t cut_end = clock();
+
+    double cut_duration = double(cut_end - cut_start) / CLOCKS_PER_SEC;
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << "Berechnungsdauer: " << duration << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -8,6 +8,9 @@
 #include <chrono>
 #include <iomanip>
 #include <queue>
+#include <cstdint>
+
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -75,6 +78,23 @@ public:
         return excess[t];
     }
 
+    // After maxFlow: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v can no longer reach t in the residual graph. Searching backwards from t
+    // only needs a maximum preflow, so the excess left in the graph does not matter
+    void get_cut(int t, vector<uint8_t>& cut) const {
+        cut.assign(adj.size(), 1);
+        vector<int> q{t};
+        cut[t] = 0;
+        for (size_t i = 0; i < q.size(); ++i) {
+            for (const Edge &edge : adj[q[i]]) {
+                if (cut[edge.to] && adj[edge.to][edge.reverse_index].capacity > 0) {
+                    cut[edge.to] = 0;
+                    q.push_back(edge.to);
+                }
+            }
+        }
+    }
+
 private:
     vector<vector<Edge>> adj;
     vector<int> height;
@@ -191,31 +211,13 @@ private:
     }
 };
 
-void parseDIMACSInput(Graph &g, int &source, int &sink, istream &input) {
-    string line;
-    int num_nodes = 0, num_edges = 0;
-
-    while (getline(input, line)) {
-        if (line.empty() || line[0] == 'c') {
-            continue; 
-        }
-
-        istringstream iss(line);
-        char type;
-        iss >> type;
-
-        if (type == 'p') {
-            string problem_type;
-            iss >> problem_type >> num_nodes >> num_edges;
-            g = Graph(num_nodes); 
-            source = 0;
-            sink = 1;
-        } else if (type == 'a') {
-            int u, v;
-            long long capacity;
-            iss >> u >> v >> capacity;
-            g.addEdge(u - 1, v - 1, capacity);
-        }
+void parseDIMACSInput(Graph &g, int &source, int &sink, const string &fname) {
+    DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+    g = Graph(dimacs.num_nodes);
+    source = 0;
+    sink = 1;
+    for (const auto &arc : dimacs.arcs) {
+        g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
     }
 }
 
@@ -227,15 +229,14 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    ifstream input_file(argv[1]);
-    if (!input_file.is_open()) {
-        cerr << "Error opening file: " << argv[1] << endl;
-        return 1;
-    }
-
     Graph g(0); 
 
-    parseDIMACSInput(g, source, sink, input_file);
+    try {
+        parseDIMACSInput(g, source, sink, argv[1]);
+    } catch (const exception &e) {
+        cerr << "Error reading file: " << e.what() << endl;
+        return 1;
+    }
 
     auto start = high_resolution_clock::now(); 
 
@@ -244,8 +245,18 @@ int main(int argc, char *argv[]) {
     auto end = high_resolution_clock::now(); 
     duration<double> duration = end - start;
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(sink, cut);
+    auto cut_end = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_end - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6) << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -10,6 +10,10 @@
 #include <queue>
 #include <tbb/tbb.h>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "../../../Compare_implementations/maxflow_algorithms-master/dimacs_reader.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -78,6 +82,36 @@ public:
         return excess[t];
     }
 
+    // After maxFlow: cut[v] = 1 if v is on the source side of the minimum cut,
+    // i.e. v can no longer reach t in the residual graph. Searching backwards from t
+    // only needs a maximum preflow. Each BFS level is expanded in parallel
+    void get_cut(int t, vector<uint8_t>& cut) const {
+        int n = adj.size();
+        vector<atomic<uint8_t>> reached(n);
+        reached[t] = 1;
+        vector<int> frontier{t};
+        while (!frontier.empty()) {
+            tbb::enumerable_thread_specific<vector<int>> next;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, frontier.size()), [&](const tbb::blocked_range<size_t> &r) {
+                auto &local = next.local();
+                for (size_t i = r.begin(); i != r.end(); ++i) {
+                    for (const Edge &edge : adj[frontier[i]]) {
+                        if (adj[edge.to][edge.reverse_index].capacity > 0 && !reached[edge.to].load(memory_order_relaxed) &&
+                            !reached[edge.to].exchange(1, memory_order_relaxed)) {
+                            local.push_back(edge.to);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for (const auto &local : next) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+            }
+        }
+        cut.resize(n);
+        tbb::parallel_for(0, n, [&](int v) { cut[v] = !reached[v].load(memory_order_relaxed); });
+    }
+
 private:
     vector<vector<Edge>> adj;
     vector<int> height;
@@ -199,31 +233,13 @@ private:
     }
 };
 
-void parseDIMACSInput(Graph &g, int &source, int &sink, istream &input) {
-    string line;
-    int num_nodes = 0, num_edges = 0;
-
-    while (getline(input, line)) {
-        if (line.empty() || line[0] == 'c') {
-            continue; 
-        }
-
-        istringstream iss(line);
-        char type;
-        iss >> type;
-
-        if (type == 'p') {
-            string problem_type;
-            iss >> problem_type >> num_nodes >> num_edges;
-            g = Graph(num_nodes, num_nodes); 
-            source = 0;
-            sink = 1;
-        } else if (type == 'a') {
-            int u, v;
-            long long capacity;
-            iss >> u >> v >> capacity;
-            g.addEdge(u - 1, v - 1, capacity);
-        }
+void parseDIMACSInput(Graph &g, int &source, int &sink, const string &fname) {
+    DimacsGraph<long long> dimacs = read_dimacs_arcs<long long>(fname);
+    g = Graph(dimacs.num_nodes, dimacs.num_nodes);
+    source = 0;
+    sink = 1;
+    for (const auto &arc : dimacs.arcs) {
+        g.addEdge(arc.from - 1, arc.to - 1, arc.cap);
     }
 }
 
@@ -235,17 +251,16 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    ifstream input_file(argv[1]);
-    if (!input_file.is_open()) {
-        cerr << "Error opening file: " << argv[1] << endl;
-        return 1;
-    }
-
     int global_relabel_freq = 2000; 
     int num_threads = tbb::this_task_arena::max_concurrency(); 
     Graph g(0, global_relabel_freq);
-    
-    parseDIMACSInput(g, source, sink, input_file);
+
+    try {
+        parseDIMACSInput(g, source, sink, argv[1]);
+    } catch (const exception &e) {
+        cerr << "Error reading file: " << e.what() << endl;
+        return 1;
+    }
 
     auto start = high_resolution_clock::now(); 
 
@@ -254,8 +269,18 @@ int main(int argc, char *argv[]) {
     auto end = high_resolution_clock::now(); 
     duration<double> duration = end - start;
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(sink, cut);
+    auto cut_end = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_end - cut_start);
+
     cout << "Maximaler Fluss: " << max_flow << endl;
     cout << fixed << setprecision(6) << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -98,12 +98,31 @@ double Dinics<BI, STAMPS, RESET, SKIP, ADJREV>::maxFlow(int s, int t, bool colle
         if(collectStats) gatherStatsBFS(static_cast<long long>(flow),found);
         if(!found) break;
         double aug;
-        while((aug = dfs(s, t, INF))>0) flow += aug;
+        while((aug = dfs(s, t, INF))>0) {
+            flow += aug;
+            if(collectStats) m_stats.back().augmentations++;
+        }
         if(collectStats) gatherStatsDFS();
     }
     return flow;
 }
 
+template<bool BI, bool STAMPS, bool RESET, bool SKIP, bool ADJREV>
+void Dinics<BI, STAMPS, RESET, SKIP, ADJREV>::getCut(int s, std::vector<uint8_t>& cut) const {
+    // source side = nodes reachable from s over unsaturated edges
+    cut.assign(m_n, 0);
+    std::vector<int> mem(m_n);
+    QueueWrapper<int> q(mem); q.push(s);
+    cut[s] = 1;
+    while(q.size()) {
+        for(const auto& e : m_graph[q.pop()].edges) {
+            if(e.isSaturated() || cut[e.to]) continue;
+            cut[e.to] = 1;
+            q.push(e.to);
+        }
+    }
+}
+
 template<bool BI, bool STAMPS, bool RESET, bool SKIP, bool ADJREV>
 void Dinics<BI, STAMPS, RESET, SKIP, ADJREV>::clearNodeData() {
     if constexpr (!STAMPS) {
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <array>
+#include <cstdint>
 
 #include "utils.h"
 #include "DinicsStats.h"
@@ -56,6 +57,8 @@ public:
 
     void resetFlow();
     double maxFlow(int s, int t, bool collectStats = false);
+    // after maxFlow(s, t): cut[v] = 1 if v is on the source side of the minimum cut
+    void getCut(int s, std::vector<uint8_t>& cut) const;
 
     const auto& graph() const { return m_graph; };
     const auto& stats() const { return m_stats; };
@@ -3,7 +3,7 @@
 namespace Dinics {
 
 std::ostream &operator<<(std::ostream& os, const RoundStatistics &s) {
-    os << s.distOfSink << ',' << s.flowBefore << ',';
+    os << s.distOfSink << ',' << s.flowBefore << ',' << s.augmentations << ',';
     for(auto& search : {s.fromS, s.fromT}) {
         os << search.lastLayer            << ','
            << search.nodesBeforeLastLayer << ','
@@ -17,4 +17,19 @@ std::ostream &operator<<(std::ostream& os, const RoundStatistics &s) {
     return os;
 }
 
+OpStats toOpStats(const std::vector<RoundStatistics>& rounds) {
+    OpStats ops;
+    for(auto& s : rounds) {
+        ops.phases++;
+        ops.augmentations += s.augmentations;
+        ops.path_length += s.augmentations * s.distOfSink;
+        for(auto& search : {s.fromS, s.fromT}) {
+            ops.growth_steps += search.nodesBeforeLastLayer;
+            ops.arcs_scanned += search.edgesBeforeLastLayer;
+        }
+        ops.arcs_scanned += s.dfsSpace.edgesFromS + s.dfsSpace.edgesFromSlast + s.dfsSpace.edgesFromInter + s.dfsSpace.edgesFromT;
+    }
+    return ops;
+}
+
 } // end namespace Dinics
@@ -1,10 +1,12 @@
 #pragma once
 #include <iostream>
+#include <vector>
+#include "../maxflow_algorithms-master/op_stats.h"
 
 namespace Dinics {
 
     struct RoundStatistics {
-        static constexpr auto CSVHEADER = "distOfSink,flowBefore," // general
+        static constexpr auto CSVHEADER = "distOfSink,flowBefore,augmentations," // general
                 "lastLayerS,nodesBeforeLastLayerS,nodesInLastLayerS,edgesBeforeLastLayerS,edgesInLastLayerS," // forward BFS
                 "lastLayerT,nodesBeforeLastLayerT,nodesInLastLayerT,edgesBeforeLastLayerT,edgesInLastLayerT," // backward BFS
                 "nodesInInter,edgesInInter," // BFS intersection
@@ -14,6 +16,7 @@ namespace Dinics {
         // general stuff
         long long distOfSink = 0; // dist from s to t
         long long flowBefore = 0;
+        long long augmentations = 0; // augmenting paths found by the DFS, each has distOfSink edges
 
         // BFS search space
         struct SearchSpaceBFS {
@@ -46,4 +49,9 @@ namespace Dinics {
     // writes all values comma separated to os according to RoundStatistics::CSVHEADER
     std::ostream& operator<<(std::ostream& os, const RoundStatistics& s);
 
+    // sums the rounds of one maxFlow up into the operation counts of maxflow_algorithms-master
+    // phases = BFS rounds, growth_steps = nodes whose edges the BFS fully explored,
+    // arcs_scanned = edges explored by BFS and DFS, path_length = edges of the augmenting paths
+    OpStats toOpStats(const std::vector<RoundStatistics>& rounds);
+
 } // end namespace Dinics
@@ -1,13 +1,17 @@
 #include <iostream> 
 #include <iomanip> 
 #include <chrono>
+#include <cstring>
 #include "Dinics.h" 
 #include "DinicsStats.h" 
 #include "utils.h" 
 
 int main(int argc, char** argv) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <DIMACS file path>" << std::endl;
+    // --ops collects the RoundStatistics and prints them as operation counts. Collecting them walks over all nodes
+    // after every BFS and DFS phase, which is included in the computation time.
+    bool count_ops = argc == 3 && std::strcmp(argv[2], "--ops") == 0;
+    if (argc < 2 || (argc > 2 && !count_ops)) {
+        std::cerr << "Usage: " << argv[0] << " <DIMACS file path> [--ops]" << std::endl;
         return 1;
     }
 
@@ -17,13 +21,31 @@ int main(int argc, char** argv) {
 
     auto start = std::chrono::high_resolution_clock::now();
     Dinics::Dinics4Skip alg(graph);
-    auto max_flow = alg.maxFlow(s, t);
+    auto max_flow = alg.maxFlow(s, t, count_ops);
     auto end = std::chrono::high_resolution_clock::now();
 
     std::chrono::duration<double> duration = end - start;
 
+    std::vector<uint8_t> cut;
+    auto cut_start = std::chrono::high_resolution_clock::now();
+    alg.getCut(s, cut);
+    auto cut_end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> cut_duration = cut_end - cut_start;
+
     std::cout << "Maximaler Fluss: " << std::fixed << std::setprecision(0) << max_flow << std::endl; 
     std::cout << std::fixed << std::setprecision(6) << "Berechnungsdauer: " << duration.count() << " Sekunden" << std::endl;
+    std::cout << std::fixed << std::setprecision(6) << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << std::endl;
+    std::size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    std::cout << "Knoten auf der Quellseite: " << source_side << std::endl;
+
+    // same names as maxflow_algorithms-master, the values stay empty without --ops
+    auto op_values = op_stats_values(Dinics::toOpStats(alg.stats()));
+    for (size_t i = 0; i < op_stats_names.size(); ++i) {
+        std::cout << op_stats_names[i] << ":";
+        if (count_ops) std::cout << " " << op_values[i];
+        std::cout << std::endl;
+    }
 
     return 0;
 }
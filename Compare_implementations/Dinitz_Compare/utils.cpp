@@ -10,65 +10,37 @@
 #include <sstream> 
 #include "common.h"
 #include "ScopedTimer.hpp"
+#include "../maxflow_algorithms-master/dimacs_reader.h"
 
 using namespace std;
 
 tuple<EdgeList, int, int> importDIMACS(const string& file) {
     ScopedTimer timer("import DIMACS " + file);
-    int n, m, s = -1, t = -1;
-    EdgeList g;
-    g.isDirected = true;
-    g.hasWeights = true;
-
-    ifstream f(file);  
-    if (!f) {
-        cout << "cannot open file " << file << endl;
+    DimacsGraph<double> dimacs;
+    try {
+        dimacs = read_dimacs_arcs<double>(file);
+    } catch (const runtime_error& e) {
+        cout << e.what() << endl;
         exit(0);
     }
 
-    string line;
-    bool problem_line_found = false;
-
-    while (getline(f, line)) {
-        if (line.empty() || line[0] == 'c') continue;
-
-        if (line[0] == 'p' && !problem_line_found) {
-            stringstream ss(line);
-            char p;
-            string max;
-            ss >> p >> max >> n >> m;
-            assert(p == 'p' && max == "max");
-            g.n = n;
-            g.edges.resize(m);
-            g.weights.resize(m);
-            problem_line_found = true;
-        } else if (line[0] == 'n') {
-            stringstream ss(line);
-            char n;
-            int temp;
-            string type;
-            ss >> n >> temp >> type;
-            --temp;
-            if (type == "s") s = temp;
-            if (type == "t") t = temp;
-        } else if (line[0] == 'a') {
-            stringstream ss(line);
-            char a;
-            int u, v;
-            double cap;
-            ss >> a >> u >> v >> cap;
-            --u;
-            --v;
-            assert(0 <= u && u < n);
-            assert(0 <= v && v < n);
-            static int i = 0;
-            g.edges[i] = {u, v};
-            g.weights[i] = cap;
-            ++i;
-        }
+    EdgeList g;
+    g.isDirected = true;
+    g.hasWeights = true;
+    g.n = dimacs.num_nodes;
+    g.edges.resize(dimacs.arcs.size());
+    g.weights.resize(dimacs.arcs.size());
+    for (size_t i = 0; i < dimacs.arcs.size(); ++i) {
+        const auto& arc = dimacs.arcs[i];
+        assert(1 <= arc.from && arc.from <= g.n);
+        assert(1 <= arc.to && arc.to <= g.n);
+        g.edges[i] = {int(arc.from) - 1, int(arc.to) - 1};
+        g.weights[i] = arc.cap;
     }
 
-    assert(problem_line_found);
+    // a -1 for s or t means the file gives no s-t pair
+    int s = int(dimacs.source) - 1;
+    int t = int(dimacs.sink) - 1;
     return {g, s, t};
 }
 
@@ -21,7 +21,7 @@
 
 void print_usage ( std::string_view program_name )
 {
-    std::cerr << "usage: " << program_name << " <solver> [-f <path>] [-p <number>]\n\n";
+    std::cerr << "usage: " << program_name << " <solver> [-f <path>] [-p <number>] [-l <loader>]\n\n";
     std::cerr << "list of possible solvers: [ek, din, prf, prh, ppr, prs, ao, aos]\n\n";
     std::cerr << "ek:\tEdmonds-Karp's algorithm\n" <<
               "din:\tDinic's algorithm\n" <<
@@ -35,6 +35,10 @@ void print_usage ( std::string_view program_name )
             << "[-f <path>]:\tspecify path to a maxflow problem instance in DIMACS format. Reads from stdin if omitted.\n";
     std::cerr
             << "[-p <number>]:\tspecify max number of threads for parallel solvers. Ignored for sequential solvers. Default = number of hw threads.\n";
+    std::cerr
+            << "[-l <loader>]:\tspecify graph loader, hash (per vertex hash maps) or sort (radix sorted arcs, uses -p threads). Default = hash.\n";
+    std::cerr
+            << "\t\tcsr loads like sort and runs the solver on a flat CSR residual network instead of per vertex vectors.\n";
 }
 
 enum class solver
@@ -42,6 +46,11 @@ enum class solver
     ek, din, prf, prh, ppr, prs, ao, aos
 };
 
+enum class loader
+{
+    hash, sort, csr
+};
+
 
 class command_line_parser
 {
@@ -49,6 +58,7 @@ class command_line_parser
     std::string _solver_str;
     std::string _input_filename;
     std::size_t _thread_count = 0;
+    loader _loader = loader::hash;
 
     std::unordered_map<std::string, solver> solver_map = {
             { "ek",  solver::ek },
@@ -61,6 +71,12 @@ class command_line_parser
             { "aos", solver::aos }
     };
 
+    std::unordered_map<std::string, loader> loader_map = {
+            { "hash", loader::hash },
+            { "sort", loader::sort },
+            { "csr",  loader::csr }
+    };
+
 public:
     bool parse_arguments ( int argc, char ** argv )
     {
@@ -71,7 +87,7 @@ public:
             return false;
         }
 
-        if ( argc % 2 || argc > 6 )
+        if ( argc % 2 || argc > 8 )
         {
             std::cerr << argv[0] << ": invalid argument count\n";
             print_usage ( argv[0] );
@@ -111,6 +127,15 @@ public:
                     std::cerr << argv[i + 1] << ": invalid format, expected positive unsigned integer\n";
                     return false;
                 }
+            } else if ( !strcmp ( argv[i], "-l" ) )
+            {
+                auto loader_iter = loader_map . find ( argv[i + 1] );
+                if ( loader_iter == std::end ( loader_map ) )
+                {
+                    std::cerr << argv[i + 1] << ": invalid loader, expected hash, sort or csr\n";
+                    return false;
+                }
+                _loader = loader_iter -> second;
             } else
             {
                 std::cerr << "Unknown option: " << argv[i] << '\n';
@@ -131,6 +156,11 @@ public:
         return _thread_count == 0 ? omp_get_max_threads () : _thread_count;
     }
 
+    loader get_loader ( ) const noexcept
+    {
+        return _loader;
+    }
+
     solver get_solver ( ) const noexcept
     {
         return _solver;
@@ -3,8 +3,8 @@
 //
 
 /*
- * Loads max flow instance in DIMACS format from given input stream.
- * This implementation is not optimised and leaves a lot of space for improvement.
+ * Loads max flow instance in DIMACS format from a file or from given input stream.
+ * Files are read with the memory mapped, parallel reader shared with maxflow_algorithms-master.
  */
 
 #ifndef MAXFLOW_GRAPH_LOADER_H
@@ -19,17 +19,22 @@
 #include <unordered_map>
 #include <cassert>
 #include "common_types.h"
+#include "data_structures/csr.h"
 #include <queue>
 #include <algorithm>
+#include <omp.h>
+#include "../../../maxflow_algorithms-master/dimacs_reader.h"
 
 
-template <typename T, typename U, template <typename, typename> typename EDGE = basic_edge>
-auto load_graph ( std::istream & is )
+/*
+ * Parses DIMACS header and descriptor lines. on_problem ( vertex_cnt, edge_cnt ) is called once the problem line
+ * is read, on_arc ( from, to, cap ) for every arc with zero based vertex indices.
+ */
+template <typename T, typename U, typename P, typename A>
+auto parse_dimacs ( std::istream & is, P && on_problem, A && on_arc )
 {
     char type;
-    T vertex_cnt, source, sink;
-    auto undefined = std::numeric_limits<T>::max ();
-    std::vector<EDGE<T, U>> edges;
+    T vertex_cnt, source = 0, sink = 0;
 
     std::string line;
     std::stringstream sstr;
@@ -46,11 +51,8 @@ auto load_graph ( std::istream & is )
     if ( problem_type != "max" )
         throw std::logic_error ( "Expected max flow problem instance" );
     sstr >> vertex_cnt >> edge_cnt;
-    edges . resize ( edge_cnt * 2 );
-    auto edge_map = std::vector<std::unordered_map<T, T>> ( vertex_cnt ); //to keep track of edge positions
-    std::vector<uint32_t> outgoing_edge_cnt ( vertex_cnt );
+    on_problem ( vertex_cnt, edge_cnt );
 
-    std::size_t pos = 0;
     while ( std::getline ( is, line ) )
     {
         sstr . clear ();
@@ -63,28 +65,7 @@ auto load_graph ( std::istream & is )
                 T from, to;
                 U cap;
                 sstr >> from >> to >> cap;
-                --to;
-                --from; // convert to zero based indexing
-                auto it = edge_map[from] . find ( to );
-                //handle multi edges
-                if ( it != std::end ( edge_map[from] ) )
-                {
-                    edges[it -> second] . r_capacity += cap;
-                    break;
-                }
-                it = edge_map[to] . find ( from );
-                //handle backward edges
-                if ( it != std::end ( edge_map[to] ) )
-                    edges[it -> second + 1] . r_capacity += cap;
-                else
-                {
-                    edges[pos] = EDGE<T, U> { to, cap, undefined };
-                    edges[pos + 1] = EDGE<T, U> { from, 0, undefined };
-                    ++outgoing_edge_cnt[from];
-                    ++outgoing_edge_cnt[to];
-                    edge_map[from] . emplace ( to, pos );
-                    pos += 2;
-                }
+                on_arc ( from - 1, to - 1, cap ); // convert to zero based indexing
                 break;
             }
             case 'n':
@@ -112,6 +93,80 @@ auto load_graph ( std::istream & is )
                 break;
         }
     }
+    return std::make_pair ( source, sink );
+}
+
+
+/*
+ * Input of the loaders, either the path of a DIMACS file or a stream such as stdin if stream is set.
+ */
+struct dimacs_input
+{
+    std::string path;
+    std::istream * stream = nullptr;
+};
+
+/*
+ * Same as above, but files are memory mapped and parsed on all cores by read_dimacs_arcs. Only streams are parsed
+ * line by line.
+ */
+template <typename T, typename U, typename P, typename A>
+auto parse_dimacs ( const dimacs_input & in, P && on_problem, A && on_arc )
+{
+    if ( in . stream )
+        return parse_dimacs<T, U> ( *in . stream, on_problem, on_arc );
+
+    auto dimacs = read_dimacs_arcs<U> ( in . path );
+    on_problem ( T ( dimacs . num_nodes ), T ( dimacs . num_arcs ) );
+    for ( auto & arc : dimacs . arcs )
+        on_arc ( T ( arc . from - 1 ), T ( arc . to - 1 ), arc . cap ); // convert to zero based indexing
+    T source = dimacs . source ? dimacs . source - 1 : 0;
+    T sink = dimacs . sink ? dimacs . sink - 1 : 0;
+    return std::make_pair ( source, sink );
+}
+
+
+template <typename T, typename U, template <typename, typename> typename EDGE = basic_edge>
+auto load_graph ( const dimacs_input & in )
+{
+    T vertex_cnt = 0;
+    auto undefined = std::numeric_limits<T>::max ();
+    std::vector<EDGE<T, U>> edges;
+    std::vector<std::unordered_map<T, T>> edge_map; //to keep track of edge positions
+    std::vector<uint32_t> outgoing_edge_cnt;
+
+    std::size_t pos = 0;
+    auto on_problem = [&] ( T vertices, T edge_cnt )
+    {
+        vertex_cnt = vertices;
+        edges . resize ( edge_cnt * 2 );
+        edge_map . resize ( vertex_cnt );
+        outgoing_edge_cnt . resize ( vertex_cnt );
+    };
+    auto on_arc = [&] ( T from, T to, U cap )
+    {
+        auto it = edge_map[from] . find ( to );
+        //handle multi edges
+        if ( it != std::end ( edge_map[from] ) )
+        {
+            edges[it -> second] . r_capacity += cap;
+            return;
+        }
+        it = edge_map[to] . find ( from );
+        //handle backward edges
+        if ( it != std::end ( edge_map[to] ) )
+            edges[it -> second + 1] . r_capacity += cap;
+        else
+        {
+            edges[pos] = EDGE<T, U> { to, cap, undefined };
+            edges[pos + 1] = EDGE<T, U> { from, 0, undefined };
+            ++outgoing_edge_cnt[from];
+            ++outgoing_edge_cnt[to];
+            edge_map[from] . emplace ( to, pos );
+            pos += 2;
+        }
+    };
+    auto [source, sink] = parse_dimacs<T, U> ( in, on_problem, on_arc );
     edge_map . clear ();
     edge_map . shrink_to_fit ();
 
@@ -148,11 +203,159 @@ auto load_graph ( std::istream & is )
     return std::make_tuple ( std::move ( graph ), source, sink );
 }
 
+
+namespace sorted_loader
+{
+    // Arc read from the input, keyed by its unordered vertex pair ( min << 32 | max ).
+    template <typename U>
+    struct raw_arc
+    {
+        uint64_t key;
+        U capacity;
+        bool reversed; // true if the arc goes from max to min
+    };
+
+    /*
+     * LSD radix sort of arcs by key, 16 bits per pass. Passes above the highest set bit of all keys are skipped.
+     * Each thread histograms and scatters its own contiguous block, so the sort is stable.
+     */
+    template <typename U>
+    void radix_sort ( std::vector<raw_arc<U>> & arcs, std::size_t thread_count )
+    {
+        constexpr std::size_t radix_bits = 16;
+        constexpr std::size_t buckets = std::size_t { 1 } << radix_bits;
+
+        uint64_t all_keys = 0;
+        for ( auto & arc : arcs )
+            all_keys |= arc . key;
+        std::size_t passes = 0;
+        while ( passes * radix_bits < 64 && ( all_keys >> ( passes * radix_bits ) ) != 0 )
+            ++passes;
+
+        thread_count = std::max<std::size_t> ( 1, std::min ( thread_count, arcs . size () / buckets + 1 ) );
+        std::vector<raw_arc<U>> buffer ( arcs . size () );
+        std::vector<std::size_t> counts ( thread_count * buckets );
+        for ( std::size_t pass = 0; pass < passes; ++pass )
+        {
+            auto shift = pass * radix_bits;
+            std::fill ( counts . begin (), counts . end (), 0 );
+            #pragma omp parallel num_threads( thread_count )
+            {
+                std::size_t thr = omp_get_thread_num (), thr_cnt = omp_get_num_threads ();
+                std::size_t begin = arcs . size () * thr / thr_cnt, end = arcs . size () * ( thr + 1 ) / thr_cnt;
+                auto * count = counts . data () + thr * buckets;
+                for ( std::size_t i = begin; i < end; ++i )
+                    ++count[( arcs[i] . key >> shift ) & ( buckets - 1 )];
+                #pragma omp barrier
+                #pragma omp single
+                {
+                    //exclusive prefix sum, bucket major so equal keys keep their thread order
+                    std::size_t sum = 0;
+                    for ( std::size_t b = 0; b < buckets; ++b )
+                        for ( std::size_t t = 0; t < thr_cnt; ++t )
+                        {
+                            auto c = counts[t * buckets + b];
+                            counts[t * buckets + b] = sum;
+                            sum += c;
+                        }
+                }
+                for ( std::size_t i = begin; i < end; ++i )
+                    buffer[count[( arcs[i] . key >> shift ) & ( buckets - 1 )]++] = arcs[i];
+            }
+            arcs . swap ( buffer );
+        }
+    }
+}
+
+/*
+ * Same as load_graph, but without per vertex hash maps: raw arcs are collected, radix sorted by their unordered
+ * vertex pair and multi edges and reverse edges are merged in a single sweep over the sorted arcs. The merged edges
+ * are written into a flat CSR array with reverse indices known up front, so memory use is linear in the number
+ * of arcs. Sorting uses up to thread_count threads.
+ * Adjacency lists are ordered by neighbour index, so they can differ in order from load_graph. Self loops are dropped.
+ */
+template <typename T, typename U, template <typename, typename> typename EDGE = basic_edge>
+auto load_graph_csr ( const dimacs_input & in, std::size_t thread_count = 1 )
+{
+    using sorted_loader::raw_arc;
+
+    T vertex_cnt = 0;
+    std::vector<raw_arc<U>> arcs;
+    auto on_problem = [&] ( T vertices, T edge_cnt )
+    {
+        vertex_cnt = vertices;
+        arcs . reserve ( edge_cnt );
+    };
+    auto on_arc = [&] ( T from, T to, U cap )
+    {
+        if ( from == to )
+            return;
+        auto lo = std::min ( from, to ), hi = std::max ( from, to );
+        arcs . push_back ( raw_arc<U> { uint64_t { lo } << 32 | hi, cap, from != lo } );
+    };
+    auto [source, sink] = parse_dimacs<T, U> ( in, on_problem, on_arc );
+
+    sorted_loader::radix_sort ( arcs, thread_count );
+
+    //merge equal vertex pairs in place, arcs[k] then holds the lo -> hi capacity and reverse_capacity[k] the hi -> lo one
+    std::vector<U> reverse_capacity;
+    reverse_capacity . reserve ( arcs . size () );
+    std::vector<uint32_t> offsets ( vertex_cnt + 1 );
+    std::size_t pair_cnt = 0;
+    for ( std::size_t i = 0; i < arcs . size (); )
+    {
+        auto key = arcs[i] . key;
+        U forward = 0, backward = 0;
+        for ( ; i < arcs . size () && arcs[i] . key == key; ++i )
+            ( arcs[i] . reversed ? backward : forward ) += arcs[i] . capacity;
+        arcs[pair_cnt] = raw_arc<U> { key, forward, false };
+        reverse_capacity . push_back ( backward );
+        ++pair_cnt;
+        ++offsets[( key >> 32 ) + 1];
+        ++offsets[( key & 0xFFFFFFFF ) + 1];
+    }
+    arcs . resize ( pair_cnt );
+    for ( std::size_t i = 0; i < vertex_cnt; ++i )
+        offsets[i + 1] += offsets[i];
+
+    //flat CSR, both directions of a pair are placed at once so the reverse indices are known immediately
+    std::vector<EDGE<T, U>> edges ( offsets[vertex_cnt] );
+    std::vector<uint32_t> fill ( offsets . begin (), offsets . end () - 1 );
+    for ( std::size_t k = 0; k < pair_cnt; ++k )
+    {
+        T lo = arcs[k] . key >> 32, hi = arcs[k] . key & 0xFFFFFFFF;
+        auto lo_pos = fill[lo]++, hi_pos = fill[hi]++;
+        edges[lo_pos] = EDGE<T, U> { hi, arcs[k] . capacity, T ( hi_pos - offsets[hi] ) };
+        edges[hi_pos] = EDGE<T, U> { lo, reverse_capacity[k], T ( lo_pos - offsets[lo] ) };
+    }
+    arcs . clear ();
+    arcs . shrink_to_fit ();
+    reverse_capacity . clear ();
+    reverse_capacity . shrink_to_fit ();
+
+    auto graph = data_structures::csr<data_structures::csr<EDGE<T, U>>> ( std::move ( offsets ), std::move ( edges ) );
+    return std::make_tuple ( std::move ( graph ), source, sink );
+}
+
+// load_graph_csr with the result copied into per vertex vectors, for solvers run on vector<vector<EDGE>>.
+template <typename T, typename U, template <typename, typename> typename EDGE = basic_edge>
+auto load_graph_sorted ( const dimacs_input & in, std::size_t thread_count = 1 )
+{
+    auto [flat, source, sink] = load_graph_csr<T, U, EDGE> ( in, thread_count );
+
+    std::vector<std::vector<EDGE<T, U>>> graph ( flat . size () );
+    #pragma omp parallel for schedule( dynamic, 1024 ) num_threads( std::max<std::size_t> ( thread_count, 1 ) )
+    for ( std::size_t i = 0; i < graph . size (); ++i )
+        graph[i] . assign ( flat[i] . begin (), flat[i] . end () );
+
+    return std::make_tuple ( std::move ( graph ), source, sink );
+}
+
 // Set reverse_r_capacity for cached edges used in push-relabel methods.
-template <typename T, typename U>
-void set_reverse_edge_cap ( std::vector<std::vector<cached_edge<T, U>>> & graph )
+template <template <typename> typename vector, typename T, typename U>
+void set_reverse_edge_cap ( vector<vector<cached_edge<T, U>>> & graph )
 {
-    for ( auto & vec : graph )
+    for ( auto && vec : graph )
         for ( auto & edge : vec )
             edge . reverse_r_capacity = graph[edge . dst_vertex][edge . reverse_edge_index] . r_capacity;
 }
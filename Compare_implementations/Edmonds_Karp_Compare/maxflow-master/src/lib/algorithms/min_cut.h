@@ -0,0 +1,64 @@
+/*
+ * Minimum cut extraction from the residual network left behind by the max flow instances.
+ */
+
+#ifndef MAXFLOW_MIN_CUT_H
+#define MAXFLOW_MIN_CUT_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <omp.h>
+
+namespace min_cut
+{
+    /*
+     * Stores the minimum cut in cut: cut[v] is 1 if v is on the source side and 0 otherwise.
+     * The sink side are the vertices which can still reach the sink, found by a backward BFS from the sink. Every
+     * level of the BFS is expanded in parallel. Only residual capacities are read, so a maximum preflow (after the
+     * first phase of the push-relabel solvers) gives the same cut as the final flow.
+     */
+    template <typename G, typename T>
+    void get_cut ( const G & residual_network, T sink, std::vector<uint8_t> & cut )
+    {
+        const auto n = residual_network . size ();
+        auto reached = std::make_unique<std::atomic<bool>[]> ( n );
+        #pragma omp parallel for schedule(static)
+        for ( std::size_t i = 0; i < n; ++i )
+            reached[i] . store ( false, std::memory_order_relaxed );
+
+        std::vector<T> frontier { sink }, next;
+        reached[sink] . store ( true, std::memory_order_relaxed );
+        while ( !frontier . empty () )
+        {
+            next . clear ();
+            #pragma omp parallel
+            {
+                std::vector<T> local_next;
+                #pragma omp for schedule(dynamic, 64) nowait
+                for ( std::size_t i = 0; i < frontier . size (); ++i )
+                {
+                    for ( auto & edge : residual_network[frontier[i]] )
+                    {
+                        //edge . dst_vertex reaches frontier[i] if the reverse edge has residual capacity
+                        auto & reverse_edge = residual_network[edge . dst_vertex][edge . reverse_edge_index];
+                        if ( reverse_edge . r_capacity > 0 && !reached[edge . dst_vertex] . load ( std::memory_order_relaxed )
+                             && !reached[edge . dst_vertex] . exchange ( true, std::memory_order_relaxed ) )
+                            local_next . push_back ( edge . dst_vertex );
+                    }
+                }
+                #pragma omp critical
+                next . insert ( next . end (), local_next . begin (), local_next . end () );
+            }
+            std::swap ( frontier, next );
+        }
+
+        cut . resize ( n );
+        #pragma omp parallel for schedule(static)
+        for ( std::size_t i = 0; i < n; ++i )
+            cut[i] = !reached[i] . load ( std::memory_order_relaxed );
+    }
+}
+
+#endif //MAXFLOW_MIN_CUT_H
@@ -11,6 +11,7 @@
 
 
 #include "../../common_types.h"
+#include "../min_cut.h"
 #include "../../data_structures/linked_list.h"
 #include "../../data_structures/thread_local_buffer_pool.h"
 #include "partitioning.h"
@@ -121,6 +122,12 @@ namespace ahuja_orlin_segment
             #endif
         }
 
+        //cut[v] is 1 if v is on the source side of the minimum cut, valid after find_max_flow
+        void get_cut ( std::vector<uint8_t> & cut ) const
+        {
+            min_cut::get_cut ( _residual_network, _sink, cut );
+        }
+
         auto steal_network ( )
         {
             return std::move ( _residual_network );
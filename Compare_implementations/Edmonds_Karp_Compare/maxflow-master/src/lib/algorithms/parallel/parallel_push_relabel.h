@@ -20,6 +20,7 @@
 #include <omp.h>
 #include <algorithm>
 #include "../../common_types.h"
+#include "../min_cut.h"
 #include "../../data_structures/queue.h"
 #include "../../data_structures/thread_local_buffer_pool.h"
 
@@ -48,6 +49,9 @@ namespace parallel_push_relabel
         T _source, _sink, _relabel_threshold, _active_cnt;
         std::size_t _relabel_progress;
         const T _thread_count;
+
+        //statistics
+        uint64_t _phase_cnt { 0 }, _push_cnt { 0 }, _relabel_cnt { 0 }, _global_update_cnt { 0 };
     public:
         max_flow_instance ( vector<vector<cached_edge<T, U>>> graph, T source, T sink,
                             std::size_t thread_count = static_cast<size_t>(omp_get_max_threads ()) )
@@ -63,10 +67,6 @@ namespace parallel_push_relabel
             init ();
         }
 
-        uint64_t _phase_cnt = 0;
-        uint64_t _push_cnt = 0;
-        uint64_t _global_update_cnt = 0;
-
         U find_max_flow ( ) noexcept
         {
             find_max_flow_inner ();
@@ -75,6 +75,7 @@ namespace parallel_push_relabel
             std::cout << "global updates:\t" << _global_update_cnt << std::endl;
             std::cout << "phase cnt: " << _phase_cnt << std::endl;
             std::cout << "pushes: " << _push_cnt << std::endl;
+            std::cout << "relabels: " << _relabel_cnt << std::endl;
             #endif
             return _vertices[_sink] . new_excess + _vertices[_sink] . excess;
         }
@@ -92,6 +93,17 @@ namespace parallel_push_relabel
             #endif
         }
 
+        //cut[v] is 1 if v is on the source side of the minimum cut, valid after find_max_flow
+        void get_cut ( std::vector<uint8_t> & cut ) const
+        {
+            min_cut::get_cut ( _residual_network, _sink, cut );
+        }
+
+        solver_statistics get_statistics ( ) const
+        {
+            return { _push_cnt, _relabel_cnt, _global_update_cnt, 0, _phase_cnt };
+        }
+
         auto steal_network ( )
         {
             return std::move ( _residual_network );
@@ -132,7 +144,7 @@ namespace parallel_push_relabel
                     return;
 
                 ++_phase_cnt;
-                uint64_t push_cnt_per_phase = 0;
+                uint64_t push_cnt_per_phase = 0, relabel_cnt_per_phase = 0;
 
                 #pragma omp parallel
                 {
@@ -146,12 +158,12 @@ namespace parallel_push_relabel
                         push ( vertex, _vertices[vertex] . label, thr_id, push_cnt_per_phase );
                     }
                     //stage 2
-                    #pragma omp for schedule(static) reduction(+:_relabel_progress)
+                    #pragma omp for schedule(static) reduction(+:_relabel_progress, relabel_cnt_per_phase)
                     for ( T i = 0; i < _active_cnt; ++i )
                     {
                         auto thr_id = omp_get_thread_num ();
                         auto vertex = _active[i];
-                        relabel ( vertex, thr_id, _relabel_progress );
+                        relabel ( vertex, thr_id, _relabel_progress, relabel_cnt_per_phase );
                     }
                     //stage 3
                     #pragma omp for schedule(static)
@@ -182,6 +194,7 @@ namespace parallel_push_relabel
                 }
 
                 _push_cnt += push_cnt_per_phase;
+                _relabel_cnt += relabel_cnt_per_phase;
             }
         }
 
@@ -209,10 +222,12 @@ namespace parallel_push_relabel
             }
         }
 
-        inline void relabel ( const T vertex, const int thr_id, std::size_t & relabel_progress ) noexcept
+        inline void relabel ( const T vertex, const int thr_id, std::size_t & relabel_progress,
+                              uint64_t & relabel_cnt ) noexcept
         {
             if ( _vertices[vertex] . excess > 0 || _vertices[vertex] . label == _residual_network . size () )
             {
+                ++relabel_cnt;
                 relabel_progress += BETA;
                 _vertices[vertex] . new_label = calculate_new_label ( vertex );
                 relabel_progress += _residual_network[vertex] . size ();
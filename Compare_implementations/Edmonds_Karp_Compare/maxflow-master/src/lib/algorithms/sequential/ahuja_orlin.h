@@ -12,6 +12,7 @@
 
 
 #include "../../common_types.h"
+#include "../min_cut.h"
 #include "../../data_structures/queue.h"
 #include "../../data_structures/linked_list.h"
 #include <memory>
@@ -90,6 +91,17 @@ namespace ahuja_orlin
             #endif
         }
 
+        //cut[v] is 1 if v is on the source side of the minimum cut, valid after find_max_flow
+        void get_cut ( std::vector<uint8_t> & cut ) const
+        {
+            min_cut::get_cut ( _residual_network, _sink, cut );
+        }
+
+        solver_statistics get_statistics ( ) const
+        {
+            return { _push_cnt, _relabel_cnt, _global_relabel_cnt, _gap_cnt, 0 };
+        }
+
         auto steal_network ( )
         {
             return std::move ( _residual_network );
@@ -12,6 +12,7 @@
 #include <memory>
 #include "../../data_structures/queue.h"
 #include "../../common_types.h"
+#include "../min_cut.h"
 
 namespace dinic
 {
@@ -45,6 +46,12 @@ namespace dinic
             return max_flow;
         }
 
+        //cut[v] is 1 if v is on the source side of the minimum cut, valid after find_max_flow
+        void get_cut ( std::vector<uint8_t> & cut ) const
+        {
+            min_cut::get_cut ( _residual_network, _sink, cut );
+        }
+
         auto steal_network ( )
         {
             return std::move ( _residual_network );
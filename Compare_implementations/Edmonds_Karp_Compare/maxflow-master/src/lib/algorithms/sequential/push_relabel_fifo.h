@@ -10,6 +10,7 @@
 #define MAXFLOW_PUSH_RELABEL_FIFO_H
 
 #include "../../common_types.h"
+#include "../min_cut.h"
 #include "../../data_structures/queue.h"
 #include "../../data_structures/linked_list.h"
 #include "../../data_structures/circular_queue.h"
@@ -73,6 +74,17 @@ namespace push_relabel_fifo
             #endif
         }
 
+        //cut[v] is 1 if v is on the source side of the minimum cut, valid after find_max_flow
+        void get_cut ( std::vector<uint8_t> & cut ) const
+        {
+            min_cut::get_cut ( _residual_network, _sink, cut );
+        }
+
+        solver_statistics get_statistics ( ) const
+        {
+            return { _push_cnt, _relabel_cnt, _global_relabel_cnt, 0, 0 };
+        }
+
         auto steal_network ( )
         {
             return std::move ( _residual_network );
@@ -99,7 +111,7 @@ namespace push_relabel_fifo
             }
 
             T m = 0;
-            for ( auto & vec : _residual_network )
+            for ( auto && vec : _residual_network )
                 m += vec . size ();
             _relabel_threshold = _residual_network . size () * ALPHA + m / 2;
         }
@@ -39,5 +39,15 @@ struct cached_edge
     U reverse_r_capacity;
 };
 
+//operation counts of the last find_max_flow, for the solvers which keep statistics
+struct solver_statistics
+{
+    uint64_t pushes = 0;
+    uint64_t relabels = 0;
+    uint64_t global_updates = 0;
+    uint64_t gaps = 0;
+    uint64_t phases = 0;
+};
+
 
 #endif //COMMON_TYPES_H
@@ -0,0 +1,141 @@
+/*
+ * Compressed sparse row (CSR) adjacency structure. Drop-in replacement for vector<vector<EDGE>> as the residual
+ * network of the max flow instances: csr<csr<EDGE>> stores an offset array and one contiguous edge array, indexing it
+ * yields csr<EDGE>, a lightweight view of one vertex's edges.
+ */
+
+#ifndef MAXFLOW_CSR_H
+#define MAXFLOW_CSR_H
+
+#include <cstdint>
+#include <vector>
+#include <cassert>
+#include <type_traits>
+
+namespace data_structures
+{
+
+    /*
+     * View of a contiguous range of edges. Does not own the edges, is only valid as long as the graph it was
+     * obtained from.
+     */
+    template <typename E>
+    class csr
+    {
+        E * _begin { nullptr };
+        E * _end { nullptr };
+    public:
+        csr ( ) = default;
+
+        csr ( E * begin, E * end ) noexcept : _begin ( begin ), _end ( end )
+        { }
+
+        E & operator [] ( std::size_t idx ) const noexcept
+        { return _begin[idx]; }
+
+        std::size_t size ( ) const noexcept
+        { return _end - _begin; }
+
+        bool empty ( ) const noexcept
+        { return _begin == _end; }
+
+        E * begin ( ) const noexcept
+        { return _begin; }
+
+        E * end ( ) const noexcept
+        { return _end; }
+    };
+
+
+    /*
+     * Graph with all edges in one array, edges of vertex v are at [offsets[v], offsets[v + 1]).
+     * Indices are 32 bit, so the graph can hold at most 2^32 - 1 edges.
+     */
+    template <typename E>
+    class csr<csr<E>>
+    {
+        std::vector<uint32_t> _offsets { 0 };
+        std::vector<E> _edges;
+
+        template <typename G, typename R>
+        class row_iterator
+        {
+            G * _graph;
+            std::size_t _vertex;
+        public:
+            row_iterator ( G * graph, std::size_t vertex ) noexcept : _graph ( graph ), _vertex ( vertex )
+            { }
+
+            R operator * ( ) const noexcept
+            { return ( *_graph )[_vertex]; }
+
+            row_iterator & operator ++ ( ) noexcept
+            {
+                ++_vertex;
+                return *this;
+            }
+
+            bool operator != ( const row_iterator & other ) const noexcept
+            { return _vertex != other . _vertex; }
+
+            bool operator == ( const row_iterator & other ) const noexcept
+            { return _vertex == other . _vertex; }
+        };
+
+    public:
+        using iterator = row_iterator<csr<csr<E>>, csr<E>>;
+        using const_iterator = row_iterator<const csr<csr<E>>, csr<const E>>;
+
+        csr ( ) = default;
+
+        csr ( std::vector<uint32_t> offsets, std::vector<E> edges ) :
+                _offsets ( std::move ( offsets ) ), _edges ( std::move ( edges ) )
+        {
+            assert ( !_offsets . empty () && _offsets . back () == _edges . size () );
+        }
+
+        explicit csr ( const std::vector<std::vector<E>> & graph ) : _offsets ( graph . size () + 1 )
+        {
+            for ( std::size_t i = 0; i < graph . size (); ++i )
+                _offsets[i + 1] = _offsets[i] + graph[i] . size ();
+            _edges . reserve ( _offsets . back () );
+            for ( auto & vec : graph )
+                _edges . insert ( _edges . end (), vec . begin (), vec . end () );
+        }
+
+        csr ( csr<csr<E>> && other ) noexcept = default;
+
+        csr<csr<E>> & operator = ( csr<csr<E>> && other ) noexcept = default;
+
+        csr ( const csr<csr<E>> & other ) = default;
+
+        csr<csr<E>> & operator = ( const csr<csr<E>> & other ) = default;
+
+        csr<E> operator [] ( std::size_t vertex ) noexcept
+        { return csr<E> { _edges . data () + _offsets[vertex], _edges . data () + _offsets[vertex + 1] }; }
+
+        csr<const E> operator [] ( std::size_t vertex ) const noexcept
+        { return csr<const E> { _edges . data () + _offsets[vertex], _edges . data () + _offsets[vertex + 1] }; }
+
+        // number of vertices
+        std::size_t size ( ) const noexcept
+        { return _offsets . size () - 1; }
+
+        std::size_t edge_count ( ) const noexcept
+        { return _edges . size (); }
+
+        iterator begin ( ) noexcept
+        { return iterator { this, 0 }; }
+
+        iterator end ( ) noexcept
+        { return iterator { this, size () }; }
+
+        const_iterator begin ( ) const noexcept
+        { return const_iterator { this, 0 }; }
+
+        const_iterator end ( ) const noexcept
+        { return const_iterator { this, size () }; }
+    };
+}
+
+#endif //MAXFLOW_CSR_H
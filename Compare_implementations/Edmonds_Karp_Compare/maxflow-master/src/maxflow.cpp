@@ -19,14 +19,14 @@
 #include "algorithms/parallel/ahuja_orlin_segment.h"
 
 
-std::istream & get_input_stream ( std::ifstream & in_file, std::optional<std::string> & file_path )
+dimacs_input get_input ( std::optional<std::string> & file_path )
 {
+    dimacs_input input;
     if ( file_path . has_value () )
-    {
-        in_file . open ( *file_path );
-        return in_file;
-    }
-    return std::cin;
+        input . path = *file_path;
+    else
+        input . stream = &std::cin;
+    return input;
 }
 
 
@@ -40,26 +40,54 @@ void print_result ( const measurement_result<U> & res, std::string_view solver,
               "time read:\t" << res . time_read . count () << " ms\n" <<
               "time init:\t" << res . time_init . count () << " ms\n" <<
               "time solve:\t" << res . time_solve . count () << " ms\n" <<
+              "time cut:\t" << res . time_cut . count () << " ms\n" <<
               "# of threads:\t" << thr_cnt << "\n";
+
+    //solvers without statistics leave the values empty
+    std::vector<uint64_t> op_values;
+    if ( res . op_stats )
+        op_values = op_stats_values ( *res . op_stats );
+    for ( std::size_t i = 0; i < op_stats_names . size (); ++i )
+    {
+        std::cout << op_stats_names[i] << ":";
+        if ( res . op_stats )
+            std::cout << '\t' << op_values[i];
+        std::cout << '\n';
+    }
+}
+
+template <template <typename> typename vector, typename T, typename U, template <typename, typename> typename EDGE>
+auto load_graph_with ( const dimacs_input & in, loader loader, std::size_t thread_count )
+{
+    if constexpr ( std::is_same_v<vector<int>, data_structures::csr<int>> )
+        return load_graph_csr<T, U, EDGE> ( in, thread_count );
+    else
+    {
+        if ( loader == loader::sort )
+            return load_graph_sorted<T, U, EDGE> ( in, thread_count );
+        return load_graph<T, U, EDGE> ( in );
+    }
 }
 
-auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread_count )
+template <template <typename> typename vector>
+auto load_graph_and_run ( const dimacs_input & in, solver solver, loader loader, std::size_t & thread_count )
 {
     using T = uint32_t;
     using U = uint64_t;
+    const auto load_threads = thread_count;
 
-    auto get_graph = [] ( std::istream & is )
+    auto get_graph = [loader, load_threads] ( const dimacs_input & in )
     {
         auto start = std::chrono::high_resolution_clock::now ();
-        auto[graph, source, sink] = load_graph<T, U, basic_edge> ( is );
+        auto[graph, source, sink] = load_graph_with<vector, T, U, basic_edge> ( in, loader, load_threads );
         auto end = std::chrono::high_resolution_clock::now ();
         return std::make_tuple ( graph, source, sink, std::chrono::duration_cast<std::chrono::milliseconds> ( end - start ) );
     };
 
-    auto get_graph_with_cached_edge = [] ( std::istream & is )
+    auto get_graph_with_cached_edge = [loader, load_threads] ( const dimacs_input & in )
     {
         auto start = std::chrono::high_resolution_clock::now ();
-        auto[graph, source, sink] = load_graph<T, U, cached_edge> ( is );
+        auto[graph, source, sink] = load_graph_with<vector, T, U, cached_edge> ( in, loader, load_threads );
         set_reverse_edge_cap ( graph );
         auto end = std::chrono::high_resolution_clock::now ();
         return std::make_tuple ( graph, source, sink, std::chrono::duration_cast<std::chrono::milliseconds> ( end - start ) );
@@ -71,7 +99,7 @@ auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread
     {
         case solver::ek:
         {
-            auto[graph, source, sink, time_read] = get_graph ( is );
+            auto[graph, source, sink, time_read] = get_graph ( in );
             result = measure_sequential<edmonds_karp::max_flow_instance> ( std::move ( graph ), source, sink );
             result . time_read = time_read;
             thread_count = 1;
@@ -79,7 +107,7 @@ auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread
         }
         case solver::din:
         {
-            auto[graph, source, sink, time_read] = get_graph ( is );
+            auto[graph, source, sink, time_read] = get_graph ( in );
             result = measure_sequential<dinic::max_flow_instance> ( std::move ( graph ), source, sink );
             result . time_read = time_read;
             thread_count = 1;
@@ -88,7 +116,7 @@ auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread
 
         case solver::prf:
         {
-            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( is );
+            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( in );
             result = measure_sequential<push_relabel_fifo::max_flow_instance> ( std::move ( graph ), source, sink );
             result . time_read = time_read;
             thread_count = 1;
@@ -96,7 +124,7 @@ auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread
         }
         case solver::prh:
         {
-            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( is );
+            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( in );
             result = measure_sequential<push_relabel_highest::max_flow_instance> ( std::move ( graph ), source, sink );
             result . time_read = time_read;
             thread_count = 1;
@@ -104,21 +132,21 @@ auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread
         }
         case solver::ppr:
         {
-            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( is );
+            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( in );
             result = measure_parallel<parallel_push_relabel::max_flow_instance> ( std::move ( graph ), source, sink, thread_count );
             result . time_read = time_read;
             break;
         }
         case solver::prs:
         {
-            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( is );
+            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( in );
             result = measure_parallel<push_relabel_segment::max_flow_instance> ( std::move ( graph ), source, sink, thread_count );
             result . time_read = time_read;
             break;
         }
         case solver::ao:
         {
-            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( is );
+            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( in );
             result = measure_sequential<ahuja_orlin::max_flow_instance> ( std::move ( graph ), source, sink );
             result . time_read = time_read;
             thread_count = 1;
@@ -126,7 +154,7 @@ auto load_graph_and_run ( std::istream & is, solver solver, std::size_t & thread
         }
         case solver::aos:
         {
-            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( is );
+            auto[graph, source, sink, time_read] = get_graph_with_cached_edge ( in );
             result = measure_parallel<ahuja_orlin_segment::max_flow_instance> ( std::move ( graph ), source, sink, thread_count );
             result . time_read = time_read;
             break;
@@ -149,13 +177,7 @@ int main ( int argc, char * argv[] )
     auto file_path = parser . get_filename ();
     auto thr_cnt = parser . get_thread_count ();
 
-    std::ifstream in_file;
-    auto & stream = get_input_stream ( in_file, file_path );
-    if ( !stream )
-    {
-        std::cerr << "Unable to open file " << *file_path << '\n';
-        return 1;
-    }
+    auto input = get_input ( file_path );
 
     //get filename without full path, or stdin
     std::string filename = "stdin";
@@ -165,7 +187,19 @@ int main ( int argc, char * argv[] )
     }
 
     //run
-    auto result = load_graph_and_run ( stream, solver, thr_cnt );
+    auto loader = parser . get_loader ();
+    measurement_result<uint64_t> result {};
+    try
+    {
+        result = loader == loader::csr
+                 ? load_graph_and_run<data_structures::csr> ( input, solver, loader, thr_cnt )
+                 : load_graph_and_run<std::vector> ( input, solver, loader, thr_cnt );
+    }
+    catch ( const std::runtime_error & e )
+    {
+        std::cerr << e . what () << '\n';
+        return 1;
+    }
     print_result ( result, solver_str, filename, thr_cnt );
     return 0;
 }
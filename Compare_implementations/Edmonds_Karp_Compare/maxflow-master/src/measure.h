@@ -12,6 +12,8 @@
 #include <omp.h>
 #include <cassert>
 #include <optional>
+#include <type_traits>
+#include "../../../maxflow_algorithms-master/op_stats.h"
 
 template <typename U>
 struct measurement_result
@@ -20,6 +22,19 @@ struct measurement_result
     std::chrono::milliseconds time_read;
     std::chrono::milliseconds time_init;
     std::chrono::milliseconds time_solve;
+    std::chrono::milliseconds time_cut;
+    //operation counts of the solve, with the names used by maxflow_algorithms-master; empty if the solver has none
+    std::optional<OpStats> op_stats;
+};
+
+template <typename S, typename = void>
+struct has_statistics : std::false_type
+{
+};
+
+template <typename S>
+struct has_statistics<S, std::void_t<decltype ( std::declval<const S &> () . get_statistics () )>> : std::true_type
+{
 };
 
 template <typename S, typename U>
@@ -30,6 +45,24 @@ auto measure_single ( S & solver, measurement_result<U> & result )
     auto end = std::chrono::high_resolution_clock::now ();
     result . max_flow = res;
     result . time_solve = std::chrono::duration_cast<std::chrono::milliseconds> ( end - start );
+
+    if constexpr ( has_statistics<S>::value )
+    {
+        auto statistics = solver . get_statistics ();
+        OpStats stats;
+        stats . pushes = statistics . pushes;
+        stats . relabels = statistics . relabels;
+        stats . global_updates = statistics . global_updates;
+        stats . gaps = statistics . gaps;
+        stats . phases = statistics . phases;
+        result . op_stats = stats;
+    }
+
+    std::vector<uint8_t> cut;
+    start = std::chrono::high_resolution_clock::now ();
+    solver . get_cut ( cut );
+    end = std::chrono::high_resolution_clock::now ();
+    result . time_cut = std::chrono::duration_cast<std::chrono::milliseconds> ( end - start );
 }
 
 
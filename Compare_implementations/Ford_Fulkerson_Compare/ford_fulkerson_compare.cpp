@@ -6,6 +6,9 @@
 #include <sstream>
 #include <fstream>
 #include <chrono>
+#include <cstdint>
+
+#include "../maxflow_algorithms-master/dimacs_reader.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -58,6 +61,20 @@ struct graph {
         }
         return flow;
     }
+    // nach max_flow: cut[u] = 1, wenn u auf der Quellseite des minimalen Schnitts liegt
+    void get_cut(int s, vector<uint8_t> &cut) const {
+        cut.assign(n, 0);
+        vector<int> queue{s};
+        cut[s] = 1;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            for (auto &e : adj[queue[i]]) {
+                if (!cut[e.dst] && e.capacity > e.flow) {
+                    cut[e.dst] = 1;
+                    queue.push_back(e.dst);
+                }
+            }
+        }
+    }
 };
 
 int main(int argc, char *argv[]) {
@@ -66,34 +83,17 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    ifstream infile(argv[1]);
-    if (!infile) {
-        cerr << "Error opening file: " << argv[1] << endl;
+    DimacsGraph<graph::flow_type> dimacs;
+    try {
+        dimacs = read_dimacs_arcs<graph::flow_type>(argv[1]);
+    } catch (const exception& e) {
+        cerr << "Error reading file: " << e.what() << endl;
         return 1;
     }
 
-    string line;
-    int n = 0, m = 0;
-    graph g(0); // Initialer leerer Graph
-
-    while (getline(infile, line)) {
-        if (line[0] == 'c') {
-            // Kommentarzeile, überspringen
-            continue;
-        } else if (line[0] == 'p') {
-            // Problemzeile
-            stringstream ss(line);
-            string tmp;
-            ss >> tmp >> tmp >> n >> m;
-            g = graph(n); // Graph mit n Knoten erstellen
-        } else if (line[0] == 'a') {
-            // Kantenzeile
-            stringstream ss(line);
-            string tmp;
-            int u, v, capacity;
-            ss >> tmp >> u >> v >> capacity;
-            g.add_edge(u - 1, v - 1, capacity);  // 1-basiert in 0-basiert umwandeln
-        }
+    graph g(dimacs.num_nodes);
+    for (const auto& a : dimacs.arcs) {
+        g.add_edge(a.from - 1, a.to - 1, a.cap);  // 1-basiert in 0-basiert umwandeln
     }
 
     int s = 0; // Quelle hat Index 1, wird zu 0-basiertem Index 0
@@ -104,8 +104,18 @@ int main(int argc, char *argv[]) {
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<chrono::duration<double>>(stop - start);
 
+    vector<uint8_t> cut;
+    auto cut_start = high_resolution_clock::now();
+    g.get_cut(s, cut);
+    auto cut_stop = high_resolution_clock::now();
+    auto cut_duration = duration_cast<chrono::duration<double>>(cut_stop - cut_start);
+
     cout << "Maximaler Fluss: " << maxFlow << endl;
     cout << "Berechnungsdauer: " << duration.count() << " Sekunden" << endl;
+    cout << "Schnittberechnung: " << cut_duration.count() << " Sekunden" << endl;
+    size_t source_side = 0;
+    for (uint8_t c : cut) source_side += c;
+    cout << "Knoten auf der Quellseite: " << source_side << endl;
 
     return 0;
 }
@@ -5,9 +5,14 @@
 #include <string>
 #include <fstream>
 #include <tuple>
+#include <set>
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <cmath>
+#include <optional>
+#include <sstream>
+#include <iomanip>
 // std::filesystem was added in C++17, but was still experimental in C++14
 #if __cplusplus >= 201700L
 #include <filesystem>
@@ -17,9 +22,21 @@ namespace fs = std::filesystem;
 namespace fs = std::experimental::filesystem;
 #endif
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include "json.hpp"
 
 #include "graph_io.h"
+#include "maxflow_solver.h"
+#include "bench_stats.h"
+#include "bench_compare.h"
+#include "perf_counters.h"
+#include "op_stats.h"
+#include "flow_verify.h"
+#include "mem_stats.h"
+#include "phase_trace.h"
 
 #ifdef GRIDCUT_IS_AVAILABLE
 #include "grid_cut/GridGraph_2D_4C.h"
@@ -60,6 +77,35 @@ static const auto now = std::chrono::steady_clock::now;
 
 using json = nlohmann::json;
 
+// Counters from the "counters" config entry. They are started and stopped around the solve phase only.
+static PerfCounters perf_counters;
+
+// Solvers are instantiated with operation counting only if the maxflow_algos_count_ops CMake option is on, since
+// the counting slows down the solve
+#ifdef BENCH_COUNT_OPS
+static constexpr bool count_ops = true;
+#else
+static constexpr bool count_ops = false;
+#endif
+
+// Operation counts of the last solve. Left empty by solvers which do not count operations.
+static std::optional<OpStats> op_stats;
+
+// Set by the "verify" config entry. Solvers then leave their cut, and their residual arc capacities if they keep the
+// arcs in input order, in certificate after each run, which is checked outside the timed phases.
+static bool verify = false;
+static SolveCertificate certificate;
+// Runs which failed verification, reported in the exit code
+static size_t num_verify_failures = 0;
+
+/** Memory used by one run, in bytes. Values which cannot be measured are -1. */
+struct RunMemory {
+    // Peak resident set size of the process during the run, which includes the loaded graph
+    int64_t peak_rss = -1;
+    // Peak heap bytes allocated by the run on top of what was allocated before it
+    int64_t heap_peak = -1;
+};
+
 struct Vec3i {
     int x;
     int y;
@@ -103,6 +149,9 @@ enum Algorithm {
     ALGO_PEIBFS,
     ALGO_GRIDCUT_MT,
 
+    // Resolved to one of the algorithms above from the graph features before running, see select_solver
+    ALGO_AUTO,
+
     // Dummy just to check loading and output
     ALGO_DUMMY
 };
@@ -133,6 +182,14 @@ struct BenchConfig {
 
     int num_run;
     int num_threads;
+
+    // Runs done before the measured ones, which are not reported
+    int num_warmup;
+    // If larger than num_run, runs are repeated until the relative confidence interval of the mean solve time is
+    // at most target_ci, or max_run runs have been made
+    int max_run;
+    double target_ci;
+    double confidence;
 };
 
 struct DataConfig {
@@ -143,6 +200,14 @@ struct DataConfig {
 
     std::string file_name;
     FileType file_type;
+    // If true, uncompressed binary files are memory mapped and solvers are built directly from the mapping
+    bool mmap;
+    // If true, serial solvers are built while reading the file so the graph is never held in memory twice
+    bool stream;
+    // If not 0 and there is no block file, parallel algorithms get this many blocks of consecutive nodes
+    uint16_t auto_blocks;
+    // As auto_blocks, but the number of blocks is this times the thread count of each run
+    uint16_t auto_blocks_per_thread;
 
     GridType grid_type;
     // These values should only be read if grid_type is not GRID_TYPE_NO_GRID
@@ -191,215 +256,331 @@ FileType ftype_from_string(const std::string& str);
 
 bool algo_is_parallel(Algorithm algo);
 bool algo_requires_grid(Algorithm algo);
+bool algo_is_streamable(Algorithm algo);
+
+template <class Data>
+struct is_graph_stream : std::false_type {};
+
+template <class Cap, class Term>
+struct is_graph_stream<GraphStream<Cap, Term>> : std::true_type {};
 
 std::vector<BenchConfig> gen_bench_configs(json config);
 std::vector<DataConfig> gen_data_configs(json config);
+std::string load_mode(const DataConfig& config);
+
+/** Pass the arcs of data to term_func and nbor_func. Data can be a BkGraph, BkGraphView or GraphStream. */
+template <class Data, class TermFunc, class NborFunc>
+void for_each_arc(const Data& data, TermFunc term_func, NborFunc nbor_func)
+{
+    visit_graph(data, make_visitor([](uint64_t, uint64_t, uint64_t) {}, term_func, nbor_func));
+}
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_bk(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_bk(BenchConfig config, const Data& data)
 {
     // Build graph.
     auto build_begin = now();
-    bk::Graph<Cap, Term, Flow> graph(data.num_nodes, data.neighbor_arcs.size());
+    bk::Graph<Cap, Term, Flow, count_ops> graph(data.num_nodes, neighbor_arc_count(data));
     graph.add_node(data.num_nodes);
-    for (const auto& tarc : data.terminal_arcs) {
+    for_each_arc(data, [&](const auto& tarc) {
         graph.add_tweights(tarc.node, tarc.source_cap, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         graph.add_edge(narc.i, narc.j, narc.cap, narc.rev_cap);
-    }
+    });
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.maxflow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
+
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    Duration extract_dur = now() - extract_begin;
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    if (verify) {
+        certificate.cut = std::move(cut);
+        graph.get_residual_caps(certificate.residuals);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_nbk(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_nbk(BenchConfig config, const Data& data)
 {
 	// Build graph.
 	auto build_begin = now();
-	nbk::Graph<Cap, Term, Flow> graph(data.num_nodes, data.neighbor_arcs.size());
+	nbk::Graph<Cap, Term, Flow, count_ops> graph(data.num_nodes, neighbor_arc_count(data));
 	graph.add_node(data.num_nodes);
-	for (const auto& tarc : data.terminal_arcs) {
+	for_each_arc(data, [&](const auto& tarc) {
 		graph.add_tweights(tarc.node, tarc.source_cap, tarc.sink_cap);
-	}
-	for (const auto& narc : data.neighbor_arcs) {
+	}, [&](const auto& narc) {
 		graph.add_edge(narc.i, narc.j, narc.cap, narc.rev_cap);
-	}
+	});
 	Duration build_dur = now() - build_begin;
 
 	// Solve graph.
+	perf_counters.start();
 	auto solve_begin = now();
 	auto flow = graph.maxflow();
 	Duration solve_dur = now() - solve_begin;
+	perf_counters.stop();
+	op_stats = graph.get_op_stats();
+
+	// Extract cut.
+	std::vector<uint8_t> cut;
+	auto extract_begin = now();
+	graph.get_cut(cut);
+	Duration extract_dur = now() - extract_begin;
+
+	if (verify) {
+		certificate.cut = std::move(cut);
+		graph.get_residual_caps(certificate.residuals);
+	}
 
-	return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+	return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_mbk(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_mbk(BenchConfig config, const Data& data)
 {
     // Build graph.
     auto build_begin = now();
-    reimpls::Graph<Cap, Term, Flow, Index, Index> graph(data.num_nodes, data.neighbor_arcs.size());
+    reimpls::Graph<Cap, Term, Flow, Index, Index, count_ops> graph(data.num_nodes, neighbor_arc_count(data));
     graph.add_node(data.num_nodes);
-    for (const auto& tarc : data.terminal_arcs) {
+    for_each_arc(data, [&](const auto& tarc) {
         graph.add_tweights(tarc.node, tarc.source_cap, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         graph.add_edge(narc.i, narc.j, narc.cap, narc.rev_cap, false);
-    }
+    });
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.maxflow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+        graph.get_residual_caps(certificate.residuals);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_mbk2(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_mbk2(BenchConfig config, const Data& data)
 {
     // Build graph.
     auto build_begin = now();
-    reimpls::Graph2<Cap, Term, Flow, Index, Index> graph(data.num_nodes, data.neighbor_arcs.size());
+    reimpls::Graph2<Cap, Term, Flow, Index, Index, count_ops> graph(data.num_nodes, neighbor_arc_count(data));
     graph.add_node(data.num_nodes);
-    for (const auto& tarc : data.terminal_arcs) {
+    for_each_arc(data, [&](const auto& tarc) {
         graph.add_tweights(tarc.node, tarc.source_cap, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         graph.add_edge(narc.i, narc.j, narc.cap, narc.rev_cap, false);
-    }
+    });
     graph.init_maxflow();
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.maxflow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+        graph.get_residual_caps(certificate.residuals);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_eibfs(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_eibfs(BenchConfig config, const Data& data)
 {
-    using Ibfs = reimpls::IBFSGraph<Cap, Term, Flow, uint32_t, Index>;
+    using Ibfs = reimpls::IBFSGraph<Cap, Term, Flow, uint32_t, Index, count_ops>;
 
     // Build graph.
     auto build_begin = now();
-    Ibfs graph(data.num_nodes, data.neighbor_arcs.size());
-    for (const auto& tarc : data.terminal_arcs) {
+    Ibfs graph(data.num_nodes, neighbor_arc_count(data));
+    for_each_arc(data, [&](const auto& tarc) {
         graph.addNode(tarc.node, tarc.source_cap, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         graph.addEdge(narc.i, narc.j, narc.cap, narc.rev_cap);
-    }
+    });
     graph.initGraph();
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.computeMaxFlow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.getOpStats();
+
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.getCut(cut);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_eibfs2(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_eibfs2(BenchConfig config, const Data& data)
 {
-    using Ibfs = reimpls::IBFSGraph2<Cap, Term, Flow>;
+    using Ibfs = reimpls::IBFSGraph2<Cap, Term, Flow, uint32_t, uint32_t, count_ops>;
 
     // Build graph.
     auto build_begin = now();
-    Ibfs graph(data.num_nodes, data.neighbor_arcs.size());
-    for (const auto& tarc : data.terminal_arcs) {
+    Ibfs graph(data.num_nodes, neighbor_arc_count(data));
+    for_each_arc(data, [&](const auto& tarc) {
         graph.addNode(tarc.node, tarc.source_cap, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         graph.addEdge(narc.i, narc.j, narc.cap, narc.rev_cap);
-    }
+    });
     graph.initGraph();
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.computeMaxFlow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.getOpStats();
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.getCut(cut);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_eibfs_old(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_eibfs_old(BenchConfig config, const Data& data)
 {
     using Ibfs = ibfs::IBFSGraph<Cap, Term, Flow>;
 
     // Build graph.
     auto build_begin = now();
     Ibfs graph(Ibfs::IB_INIT_FAST);
-    graph.initSize(data.num_nodes, data.neighbor_arcs.size());
-    for (const auto& tarc : data.terminal_arcs) {
+    graph.initSize(data.num_nodes, neighbor_arc_count(data));
+    for_each_arc(data, [&](const auto& tarc) {
         graph.addNode(tarc.node, tarc.source_cap, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         graph.addEdge(narc.i, narc.j, narc.cap, narc.rev_cap);
-    }
+    });
     graph.initGraph();
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.computeMaxFlow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.getCut(cut);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data, reimpls::LabelOrder LO, reimpls::RootOrder RO>
-std::tuple<Flow, double, double> bench_hpf(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_hpf(BenchConfig config, const Data& data)
 {
     // Build graph.
     auto build_begin = now();
     // reimpls::Hpf<Cap, mbk::LabelOrder::HIGHEST_FIRST, reimpls::RootOrder::FIFO> graph(
-    reimpls::Hpf<Cap, LO, RO> graph(
-        data.num_nodes + 2, data.neighbor_arcs.size() + data.terminal_arcs.size());;
+    reimpls::Hpf<Cap, LO, RO, count_ops> graph(
+        data.num_nodes + 2, neighbor_arc_count(data) + terminal_arc_count(data));;
     graph.set_source(0);
     graph.set_sink(1);
     graph.add_node(data.num_nodes + 2);
-    for (const auto& tarc : data.terminal_arcs) {
+    for_each_arc(data, [&](const auto& tarc) {
         graph.add_edge(0, tarc.node + 2, tarc.source_cap);
         graph.add_edge(tarc.node + 2, 1, tarc.sink_cap);
-    }
-    for (const auto& narc : data.neighbor_arcs) {
+    }, [&](const auto& narc) {
         if (narc.cap) {
             graph.add_edge(narc.i + 2, narc.j + 2, narc.cap);
         }
         if (narc.rev_cap) {
             graph.add_edge(narc.j + 2, narc.i + 2, narc.rev_cap);
         }
-    }
+    });
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     graph.mincut();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
 
     auto flow = graph.compute_maxflow();
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    // Drop the explicit source and sink.
+    cut.erase(cut.begin(), cut.begin() + 2);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_hi_pr(BenchConfig config, const Data& data)
+std::tuple<Flow, double, double, double> bench_hi_pr(BenchConfig config, const Data& data)
 {
     hi_pr::HiPr graph;
 
@@ -407,6 +588,8 @@ std::tuple<Flow, double, double> bench_hi_pr(BenchConfig config, const Data& dat
     std::vector<int> endpoints; // [from, to, from, to, ...]
     std::vector<int> capacities; // [cap, rev_cap, cap, rev_cap, ...]
     std::vector<int> excesses; // source_cap - sink_cap for all nodes
+    std::vector<int> source_caps(data.num_nodes, 0);
+    std::vector<int> sink_caps(data.num_nodes, 0);
     endpoints.reserve(2 * data.neighbor_arcs.size());
     capacities.reserve(2 * data.neighbor_arcs.size());
     excesses.resize(data.num_nodes, 0);
@@ -418,7 +601,14 @@ std::tuple<Flow, double, double> bench_hi_pr(BenchConfig config, const Data& dat
         capacities.push_back(narc.rev_cap);
     }
     for (const auto& tarc : data.terminal_arcs) {
-        excesses[tarc.node] = tarc.source_cap - tarc.sink_cap;
+        source_caps[tarc.node] += tarc.source_cap;
+        sink_caps[tarc.node] += tarc.sink_cap;
+    }
+    // HI_PR only sees the net excess, so flow going straight from source to sink through a node is added back
+    Flow terminal_flow = 0;
+    for (size_t i = 0; i < data.num_nodes; ++i) {
+        excesses[i] = source_caps[i] - sink_caps[i];
+        terminal_flow += std::min(source_caps[i], sink_caps[i]);
     }
 
     // Build graph.
@@ -428,16 +618,58 @@ std::tuple<Flow, double, double> bench_hi_pr(BenchConfig config, const Data& dat
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     graph.stageOne();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
 
-    auto flow = graph.flow - graph.flow0;
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    auto flow = terminal_flow + graph.flow - graph.flow0;
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    // Drop the explicit source and sink which are stored last.
+    cut.resize(data.num_nodes);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
+}
+
+#ifdef GRIDCUT_IS_AVAILABLE
+/** GridCut stores nodes in its own blocked order, so the cut is read back one grid position at a time. */
+template <class Graph>
+void get_grid_cut_2d(const Graph& graph, size_t width, size_t height, std::vector<uint8_t>& cut)
+{
+    cut.resize(width * height);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            cut[x + y * width] = graph.get_segment(graph.node_id(x, y)) == 0;
+        }
+    }
 }
 
+template <class Graph>
+void get_grid_cut_3d(const Graph& graph, size_t width, size_t height, size_t depth, std::vector<uint8_t>& cut)
+{
+    cut.resize(width * height * depth);
+    for (size_t z = 0; z < depth; ++z) {
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                cut[x + y * width + z * width * height] = graph.get_segment(graph.node_id(x, y, z)) == 0;
+            }
+        }
+    }
+}
+#endif
+
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double> bench_gridcut(
+std::tuple<Flow, double, double, double> bench_gridcut(
     BenchConfig config, const Data& data, const DataConfig& data_config)
 {
 #ifdef GRIDCUT_IS_AVAILABLE
@@ -516,6 +748,8 @@ std::tuple<Flow, double, double> bench_gridcut(
     Flow flow;
     Duration build_dur;
     Duration solve_dur;
+    Duration extract_dur;
+    std::vector<uint8_t> cut;
     if (data_config.grid_type == GRID_TYPE_2D_4C) {
         auto build_begin = now();
         GridGraph_2D_4C<Term, Cap, Flow> graph(width, height);
@@ -529,10 +763,16 @@ std::tuple<Flow, double, double> bench_gridcut(
         );
         build_dur = now() - build_begin;
         
+        perf_counters.start();
         auto solve_begin = now();
         graph.compute_maxflow();
         flow = graph.get_flow();
         solve_dur = now() - solve_begin;
+        perf_counters.stop();
+
+        auto extract_begin = now();
+        get_grid_cut_2d(graph, width, height, cut);
+        extract_dur = now() - extract_begin;
     } else if (data_config.grid_type == GRID_TYPE_2D_8C) {
         auto build_begin = now();
         GridGraph_2D_8C<Term, Cap, Flow> graph(width, height);
@@ -550,10 +790,16 @@ std::tuple<Flow, double, double> bench_gridcut(
         );
         build_dur = now() - build_begin;
 
+        perf_counters.start();
         auto solve_begin = now();
         graph.compute_maxflow();
         flow = graph.get_flow();
         solve_dur = now() - solve_begin;
+        perf_counters.stop();
+
+        auto extract_begin = now();
+        get_grid_cut_2d(graph, width, height, cut);
+        extract_dur = now() - extract_begin;
     } else if (data_config.grid_type == GRID_TYPE_3D_6C) {
         auto build_begin = now();
         GridGraph_3D_6C<Term, Cap, Flow> graph(width, height, depth);
@@ -569,10 +815,16 @@ std::tuple<Flow, double, double> bench_gridcut(
         );
         build_dur = now() - build_begin;
 
+        perf_counters.start();
         auto solve_begin = now();
         graph.compute_maxflow();
         flow = graph.get_flow();
         solve_dur = now() - solve_begin;
+        perf_counters.stop();
+
+        auto extract_begin = now();
+        get_grid_cut_3d(graph, width, height, depth, cut);
+        extract_dur = now() - extract_begin;
     } else if (data_config.grid_type == GRID_TYPE_3D_26C) {
         auto build_begin = now();
         GridGraph_3D_26C<Term, Cap, Flow> graph(width, height, depth);
@@ -612,27 +864,37 @@ std::tuple<Flow, double, double> bench_gridcut(
         );
         build_dur = now() - build_begin;
 
+        perf_counters.start();
         auto solve_begin = now();
         graph.compute_maxflow();
         flow = graph.get_flow();
         solve_dur = now() - solve_begin;
+        perf_counters.stop();
+
+        auto extract_begin = now();
+        get_grid_cut_3d(graph, width, height, depth, cut);
+        extract_dur = now() - extract_begin;
     }
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count());
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count());
 #else
     throw std::runtime_error("GridCut is not available.");
 #endif
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double, uint16_t> bench_parallel_mbk(
+std::tuple<Flow, double, double, double, uint16_t> bench_parallel_mbk(
     BenchConfig config, const Data& data, std::vector<uint16_t> node_blocks, uint16_t num_blocks)
 {
     auto block_intervals = split_block_intervals(node_blocks);
 
     // Build graph.
     auto build_begin = now();
-    reimpls::ParallelGraph<Cap, Term, Flow> graph(data.num_nodes, data.neighbor_arcs.size(), num_blocks);
+    reimpls::ParallelGraph<Cap, Term, Flow, uint32_t, uint32_t, count_ops> graph(data.num_nodes, data.neighbor_arcs.size(), num_blocks);
     graph.set_num_threads(config.num_threads);
 
     Index added_nodes = 0;
@@ -658,15 +920,28 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_mbk(
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.maxflow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
+
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    Duration extract_dur = now() - extract_begin;
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), num_blocks);
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count(), num_blocks);
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double, uint16_t> bench_parallel_pr(
+std::tuple<Flow, double, double, double, uint16_t> bench_parallel_pr(
     BenchConfig config, const Data& data, std::vector<uint16_t> node_blocks, uint16_t num_blocks)
 {
     if (!std::is_same<Cap, int32_t>::value) {
@@ -689,78 +964,83 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_pr(
 
     graph.set_num_threads(config.num_threads);
 
+    perf_counters.start();
     auto solve_begin = now();
     graph.mincut();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
 
     return std::make_tuple(graph.get_flow(), build_dur.count(), solve_dur.count(), data.num_nodes);*/
 
     auto build_begin = now();
 
+    // prepareMaxFlow turns every adjacency entry (i, j, c) into the arc i->j with capacity c and a reverse arc with no
+    // capacity, so each arc is only listed at its tail. Terminal arcs are merged per node first, which leaves the source
+    // and sink with at most one arc per node, as the source saturation in sppr requires.
     size_t num_nodes = data.num_nodes + 2;
-    size_t num_arcs = 2 * (data.terminal_arcs.size() + data.neighbor_arcs.size());
-    std::vector<wghVertex<int>> verts(num_arcs);
-    std::vector<int> neighbors(num_arcs, -1);
-    std::vector<int> arc_weights(num_arcs, 0);
-
     int source = 0;
     int sink = 1;
 
-    wghGraph<int> wg(verts.data(), num_nodes, num_arcs);
-
-    size_t total_arcs = 0;
+    std::vector<int64_t> source_caps(data.num_nodes, 0);
+    std::vector<int64_t> sink_caps(data.num_nodes, 0);
     for (const auto& tarc : data.terminal_arcs) {
-        if (tarc.source_cap > tarc.sink_cap) {
-            wg.V[source].degree++;
-        } else {
-            wg.V[sink].degree++;
+        source_caps[tarc.node] += tarc.source_cap;
+        sink_caps[tarc.node] += tarc.sink_cap;
+    }
+
+    std::vector<wghVertex<int>> verts(num_nodes);
+    for (auto& v : verts) {
+        // wghVertex leaves its members uninitialized
+        v.degree = 0;
+    }
+    int64_t flow = 0;
+    for (size_t i = 0; i < data.num_nodes; ++i) {
+        // Flow which goes straight from the source to the sink
+        flow += std::min(source_caps[i], sink_caps[i]);
+        if (source_caps[i] > sink_caps[i]) {
+            verts[source].degree++;
+        } else if (sink_caps[i] > source_caps[i]) {
+            verts[i + 2].degree++;
         }
-        wg.V[tarc.node].degree++;
     }
     for (const auto& narc : data.neighbor_arcs) {
-        wg.V[narc.i + 2].degree++;
-        wg.V[narc.j + 2].degree++;
+        if (narc.cap != 0) {
+            verts[narc.i + 2].degree++;
+        }
+        if (narc.rev_cap != 0) {
+            verts[narc.j + 2].degree++;
+        }
     }
 
-    std::vector<int> offsets(num_nodes + 2, 0);
+    std::vector<size_t> offsets(num_nodes, 0);
     for (size_t i = 1; i < num_nodes; ++i) {
-        offsets[i] = offsets[i - 1] + wg.V[i - 1].degree;
-    }
-
-    int64_t flow = 0;
-    for (const auto& tarc : data.terminal_arcs) {
-        if (tarc.source_cap > tarc.sink_cap) {
-            neighbors[offsets[source]] = tarc.node + 2;
-            neighbors[offsets[tarc.node + 2]] = source;
-
-            arc_weights[offsets[source]] = tarc.source_cap - tarc.sink_cap;
-            arc_weights[offsets[tarc.node + 2]] = 0;
-
-            flow += tarc.sink_cap;
-            offsets[source]++;
-        } else {
-            neighbors[offsets[sink]] = tarc.node + 2;
-            neighbors[offsets[tarc.node + 2]] = sink;
-
-            arc_weights[offsets[sink]] = 0;
-            arc_weights[offsets[tarc.node + 2]] = tarc.sink_cap - tarc.source_cap;
-
-            flow += tarc.source_cap;
-            offsets[sink]++;
+        offsets[i] = offsets[i - 1] + verts[i - 1].degree;
+    }
+    size_t num_arcs = offsets[num_nodes - 1] + verts[num_nodes - 1].degree;
+    std::vector<int> neighbors(num_arcs);
+    std::vector<int> arc_weights(num_arcs);
+    auto add_arc = [&](int i, int j, int64_t cap) {
+        neighbors[offsets[i]] = j;
+        arc_weights[offsets[i]] = static_cast<int>(cap);
+        offsets[i]++;
+    };
+    for (size_t i = 0; i < data.num_nodes; ++i) {
+        if (source_caps[i] > sink_caps[i]) {
+            add_arc(source, i + 2, source_caps[i] - sink_caps[i]);
+        } else if (sink_caps[i] > source_caps[i]) {
+            add_arc(i + 2, sink, sink_caps[i] - source_caps[i]);
         }
-        offsets[tarc.node + 2]++;
     }
     for (const auto& narc : data.neighbor_arcs) {
-        neighbors[offsets[narc.i + 2]] = narc.j + 2;
-        neighbors[offsets[narc.j + 2]] = narc.i + 2;
-
-        arc_weights[offsets[narc.i + 2]] = narc.cap;
-        arc_weights[offsets[narc.j + 2]] = narc.rev_cap;
-
-        offsets[narc.i + 2]++;
-        offsets[narc.j + 2]++;
+        if (narc.cap != 0) {
+            add_arc(narc.i + 2, narc.j + 2, narc.cap);
+        }
+        if (narc.rev_cap != 0) {
+            add_arc(narc.j + 2, narc.i + 2, narc.rev_cap);
+        }
     }
 
+    wghGraph<int> wg(verts.data(), num_nodes, num_arcs);
     wg.V[0].Neighbors = neighbors.data();
     wg.V[0].nghWeights = arc_weights.data();
     for (size_t i = 1; i < num_nodes; ++i) {
@@ -774,15 +1054,32 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_pr(
 
     Duration build_dur = now() - build_begin;
 
+    perf_counters.start();
     auto solve_begin = now();
-    flow += maxFlow();
+    flow += solveMaxFlow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), data.num_nodes);
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    cut.resize(num_nodes);
+    getMinCut(cut.data());
+    // Drop the explicit source and sink.
+    cut.erase(cut.begin(), cut.begin() + 2);
+    Duration extract_dur = now() - extract_begin;
+
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    freeMaxFlow();
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count(), data.num_nodes);
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double, uint16_t> bench_parallel_sk(
+std::tuple<Flow, double, double, double, uint16_t> bench_parallel_sk(
     BenchConfig config, const Data& data, std::vector<uint16_t> node_blocks, uint16_t num_blocks)
 {
     if (node_blocks.size() < data.num_nodes) {
@@ -823,7 +1120,7 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_sk(
 
     auto build_begin = now();
     size_t edges_per_block = data.neighbor_arcs.size() / config.num_threads;
-    reimpls::ParallelSkGraph<Cap, Term, Flow, typename std::make_signed<Index>::type> graph(
+    reimpls::ParallelSkGraph<Cap, Term, Flow, typename std::make_signed<Index>::type, count_ops> graph(
         data.num_nodes, edges_per_block + edges_per_block / 5);
     graph.add_node(data.num_nodes);
 
@@ -852,15 +1149,28 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_sk(
 
     Duration build_dur = now() - build_begin;
 
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.maxflow() / 2;
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.get_op_stats();
+
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.get_cut(cut);
+    Duration extract_dur = now() - extract_begin;
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), config.num_threads);
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count(), config.num_threads);
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double, uint16_t> bench_parallel_rd(
+std::tuple<Flow, double, double, double, uint16_t> bench_parallel_rd(
     BenchConfig config, const Data& data, std::vector<uint16_t> node_blocks, uint16_t num_blocks)
 {
 #ifdef PARD_IS_AVAILABLE
@@ -935,17 +1245,18 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_rd(
     // the internal timer of the implementation here. For the build time, our external timer seems
     // to give a more fair assessment (although it's longer than needed since it does include some
     // disk I/O).
-    return std::make_tuple(flow, build_dur.count(), pard.info.solve_t.time(), used_blocks);
+    // P-ARD works out of core and is not asked for the cut, so no extract time is reported.
+    return std::make_tuple(flow, build_dur.count(), pard.info.solve_t.time(), 0.0, used_blocks);
 #else
     throw std::runtime_error("P-ARD is not available");
 #endif
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double, uint16_t> bench_parallel_eibfs(
+std::tuple<Flow, double, double, double, uint16_t> bench_parallel_eibfs(
     BenchConfig config, const Data& data, std::vector<uint16_t> node_blocks, uint16_t num_blocks)
 {
-    using Ibfs = reimpls::ParallelIbfs<Cap, Term, Flow>;
+    using Ibfs = reimpls::ParallelIbfs<Cap, Term, Flow, uint32_t, uint32_t, count_ops>;
     auto block_intervals = split_block_intervals(node_blocks);
 
     // Build graph.
@@ -977,15 +1288,28 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_eibfs(
     Duration build_dur = now() - build_begin;
 
     // Solve graph.
+    perf_counters.start();
     auto solve_begin = now();
     auto flow = graph.computeMaxFlow();
     Duration solve_dur = now() - solve_begin;
+    perf_counters.stop();
+    op_stats = graph.getOpStats();
+
+    // Extract cut.
+    std::vector<uint8_t> cut;
+    auto extract_begin = now();
+    graph.getCut(cut);
+    Duration extract_dur = now() - extract_begin;
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), num_blocks);
+    if (verify) {
+        certificate.cut = std::move(cut);
+    }
+
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count(), num_blocks);
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
-std::tuple<Flow, double, double, uint16_t> bench_parallel_gridcut(
+std::tuple<Flow, double, double, double, uint16_t> bench_parallel_gridcut(
     BenchConfig config, const Data& data, const DataConfig& data_config, std::vector<uint16_t> node_blocks, uint16_t num_blocks)
 {
 #ifdef GRIDCUT_IS_AVAILABLE
@@ -1089,6 +1413,8 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_gridcut(
     Flow flow;
     Duration build_dur;
     Duration solve_dur;
+    Duration extract_dur;
+    std::vector<uint8_t> cut;
     if (data_config.grid_type == GRID_TYPE_2D_4C) {
         auto build_begin = now();
         GridGraph_2D_4C_MT<Term, Cap, Flow> graph(width, height, config.num_threads, block_size);
@@ -1102,10 +1428,16 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_gridcut(
         );
         build_dur = now() - build_begin;
 
+        perf_counters.start();
         auto solve_begin = now();
         graph.compute_maxflow();
         flow = graph.get_flow();
         solve_dur = now() - solve_begin;
+        perf_counters.stop();
+
+        auto extract_begin = now();
+        get_grid_cut_2d(graph, width, height, cut);
+        extract_dur = now() - extract_begin;
     } else if (data_config.grid_type == GRID_TYPE_3D_6C) {
         auto build_begin = now();
         GridGraph_3D_6C_MT<Term, Cap, Flow> graph(width, height, depth, config.num_threads, block_size);
@@ -1121,13 +1453,23 @@ std::tuple<Flow, double, double, uint16_t> bench_parallel_gridcut(
         );
         build_dur = now() - build_begin;
 
+        perf_counters.start();
         auto solve_begin = now();
         graph.compute_maxflow();
         flow = graph.get_flow();
         solve_dur = now() - solve_begin;
+        perf_counters.stop();
+
+        auto extract_begin = now();
+        get_grid_cut_3d(graph, width, height, depth, cut);
+        extract_dur = now() - extract_begin;
+    }
+
+    if (verify) {
+        certificate.cut = std::move(cut);
     }
 
-    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), used_blocks);
+    return std::make_tuple(flow, build_dur.count(), solve_dur.count(), extract_dur.count(), used_blocks);
 #else
     throw std::runtime_error("Parallel GridCut is not available");
 #endif
@@ -1138,6 +1480,7 @@ void print_config_header()
 {
     std::cout << "bench_name,";
     std::cout << "file_name,";
+    std::cout << "load,";
     std::cout << "num_nodes,";
     std::cout << "num_term_arcs,";
     std::cout << "num_nbor_arcs,";
@@ -1151,13 +1494,29 @@ void print_config_header()
     std::cout << "num_blocks,";
     std::cout << "build_time,";
     std::cout << "solve_time,";
-    std::cout << "maxflow" << std::endl;
+    std::cout << "maxflow,";
+    std::cout << "extract_time,";
+    std::cout << "peak_rss,";
+    std::cout << "heap_peak";
+    for (const auto& name : perf_counters.names()) {
+        std::cout << "," << name;
+    }
+    if (count_ops) {
+        for (const auto& name : op_stats_names) {
+            std::cout << "," << name;
+        }
+    }
+    if (verify) {
+        std::cout << ",verify";
+    }
+    std::cout << std::endl;
 }
 
 void print_data_config_values(DataConfig config)
 {
     std::cout << config.bench_name << ",";
     std::cout << config.file_name << ",";
+    std::cout << load_mode(config) << ",";
     std::cout << std::flush;
 }
 
@@ -1165,162 +1524,764 @@ template <class Data>
 void print_data_sizes(const Data& data)
 {
     std::cout << data.num_nodes << ",";
-    std::cout << data.terminal_arcs.size() << ",";
-    std::cout << data.neighbor_arcs.size() << ",";
+    std::cout << terminal_arc_count(data) << ",";
+    std::cout << neighbor_arc_count(data) << ",";
     std::cout << std::flush;
 }
 
 template <class Cap, class Term, class Flow, class Index>
-void print_bench_config_values(BenchConfig config)
+void print_bench_config_values(BenchConfig config, int num_runs)
 {
     std::cout << typeid(Cap).name() << ",";
     std::cout << typeid(Term).name() << ",";
     std::cout << typeid(Flow).name() << ",";
     std::cout << typeid(Index).name() << ",";
     std::cout << algo_to_string(config.algo) << ",";
-    std::cout << config.num_run << ",";
+    std::cout << num_runs << ",";
     std::cout << config.num_threads << ",";
     std::cout << std::flush;
 }
 
 template <class Cap, class Term, class Flow>
-void print_results(double build_time, double solve_time, Flow maxflow)
+void print_results(double build_time, double solve_time, Flow maxflow, double extract_time, const RunMemory& memory,
+    const VerifyResult& verified)
 {
     std::cout << build_time << ",";
     std::cout << solve_time << ",";
-    std::cout << maxflow << std::endl;
+    std::cout << maxflow << ",";
+    std::cout << extract_time << ",";
+    // Memory which could not be measured is left empty
+    if (memory.peak_rss >= 0) {
+        std::cout << memory.peak_rss;
+    }
+    std::cout << ",";
+    if (memory.heap_peak >= 0) {
+        std::cout << memory.heap_peak;
+    }
+    // Counters which could not be opened are left empty
+    for (int64_t value : perf_counters.values()) {
+        std::cout << ",";
+        if (value >= 0) {
+            std::cout << value;
+        }
+    }
+    // As are the operation counts of solvers which do not count operations
+    if (count_ops) {
+        for (size_t c = 0; c < op_stats_names.size(); ++c) {
+            std::cout << ",";
+            if (op_stats) {
+                std::cout << op_stats_values(*op_stats)[c];
+            }
+        }
+    }
+    if (verify) {
+        std::cout << "," << verified.status();
+    }
+    std::cout << std::endl;
+}
+
+/** Run a serial algorithm. These only need to see each arc once, so Data may also be a GraphStream. */
+template <class Cap, class Term, class Flow, class Index, class Data>
+std::tuple<Flow, double, double, double> bench_serial(BenchConfig config, const Data& data)
+{
+    switch (config.algo) {
+    case ALGO_BK:
+        return bench_bk<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_NBK:
+        return bench_nbk<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_MBK:
+        return bench_mbk<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_MBK2:
+        return bench_mbk2<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_EIBFS:
+        return bench_eibfs<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_EIBFS2:
+        return bench_eibfs2<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_EIBFS_OLD:
+        return bench_eibfs_old<Cap, Term, Flow, Index, Data>(config, data);
+    case ALGO_HPF: // Fall through to default HPF config
+    case ALGO_HPF_HF:
+        return bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::HIGHEST_FIRST, reimpls::RootOrder::FIFO>(config, data);
+    case ALGO_HPF_HL:
+        return bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::HIGHEST_FIRST, reimpls::RootOrder::LIFO>(config, data);
+    case ALGO_HPF_LF:
+        return bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::LOWEST_FIRST, reimpls::RootOrder::FIFO>(config, data);
+    case ALGO_HPF_LL:
+        return bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::LOWEST_FIRST, reimpls::RootOrder::LIFO>(config, data);
+    case ALGO_DUMMY:
+        return std::make_tuple(Flow(0), 0.0, 0.0, 0.0);
+    default:
+        throw std::runtime_error("Unsupported algorithm.");
+    }
+}
+
+/**
+ * Summary of all measured runs of one algorithm on one data set, written to the optional summary_file. The same
+ * record is used for both formats: a JSON file holds an array of these objects, and a CSV file has one row per
+ * record with the stats objects flattened into <phase>_<stat> columns. The memory use, each counter and each operation
+ * count is a phase of its own, which is null (or empty in CSV) if it could not be measured or the solver does not count
+ * operations.
+ */
+class SummaryWriter {
+public:
+    void open(const std::string& fname, const std::vector<std::string>& counter_names)
+    {
+        fname_ = fname;
+        phases_ = { "build_time", "solve_time", "extract_time", "peak_rss", "heap_peak" };
+        phases_.insert(phases_.end(), counter_names.begin(), counter_names.end());
+        is_json_ = fs::path(fname).extension() == ".json";
+        records_ = json::array();
+        std::ofstream file(fname_, std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Could not open summary file: " + fname_);
+        }
+        if (is_json_) {
+            file << records_.dump(2) << std::endl;
+        } else {
+            write_csv_header(file, phases_);
+        }
+    }
+
+    void write(const json& record)
+    {
+        if (fname_.empty()) {
+            return;
+        }
+        if (is_json_) {
+            // Rewritten every time so the file is valid JSON even if a later benchmark crashes
+            records_.push_back(record);
+            std::ofstream file(fname_, std::ios::trunc);
+            file << records_.dump(2) << std::endl;
+        } else {
+            std::ofstream file(fname_, std::ios::app);
+            write_csv_row(file, record, phases_);
+        }
+    }
+
+private:
+    static constexpr const char *key_columns[] = {
+        "bench_name", "file_name", "load", "algorithm", "num_threads", "num_blocks", "cap_type", "term_type",
+        "flow_type", "index_type", "num_warmup", "num_runs", "confidence", "maxflow", "maxflow_consistent",
+        "verified"
+    };
+    static constexpr const char *stat_columns[] = {
+        "mean", "stddev", "min", "max", "median", "mad", "p5", "p25", "p75", "p95", "ci_half_width"
+    };
+
+    static void write_csv_header(std::ostream& os, const std::vector<std::string>& phases)
+    {
+        const char *sep = "";
+        for (const char *key : key_columns) {
+            os << sep << key;
+            sep = ",";
+        }
+        for (const auto& phase : phases) {
+            for (const char *stat : stat_columns) {
+                os << "," << phase << "_" << stat;
+            }
+        }
+        os << std::endl;
+    }
+
+    static void write_csv_row(std::ostream& os, const json& record, const std::vector<std::string>& phases)
+    {
+        const char *sep = "";
+        for (const char *key : key_columns) {
+            os << sep;
+            sep = ",";
+            // verified is only set if the runs were verified
+            if (!record.contains(key)) {
+                continue;
+            }
+            const json& value = record[key];
+            os << (value.is_string() ? value.get<std::string>() : value.dump());
+        }
+        for (const auto& phase : phases) {
+            for (const char *stat : stat_columns) {
+                os << ",";
+                if (!record[phase].is_null() && !record[phase][stat].is_null()) {
+                    os << record[phase][stat].dump();
+                }
+            }
+        }
+        os << std::endl;
+    }
+
+    std::string fname_;
+    std::vector<std::string> phases_;
+    bool is_json_ = false;
+    json records_;
+};
+
+static SummaryWriter summary_writer;
+
+/**
+ * Phase markers of the measured runs, written to the optional trace_file in the JSON array format of Chrome traces
+ * (chrome://tracing, Perfetto or speedscope). Each run is a process of its own, named after the data set, algorithm
+ * and run, with one track per solver thread. The closing bracket is written at the end, but the viewers also accept
+ * a file without it, e.g. if a later benchmark crashed.
+ */
+class TraceWriter {
+public:
+    void open(const std::string& fname)
+    {
+        file_.open(fname, std::ios::trunc);
+        if (!file_) {
+            throw std::runtime_error("Could not open trace file: " + fname);
+        }
+        file_ << "[\n";
+        first_ = true;
+    }
+
+    bool is_open() const { return file_.is_open(); }
+
+    /** Write the events recorded since the last PhaseTrace::clear() as one run called name. */
+    void write_run(const std::string& name)
+    {
+        if (!is_open()) {
+            return;
+        }
+        const int pid = next_pid_++;
+        json meta = { { "name", "process_name" }, { "ph", "M" }, { "pid", pid }, { "args", { { "name", name } } } };
+        file_ << (first_ ? "" : ",\n") << meta.dump();
+        first_ = false;
+        PhaseTrace::instance().write_chrome_events(file_, pid, first_);
+        file_ << std::flush;
+        const uint64_t dropped = PhaseTrace::instance().dropped();
+        if (dropped > 0) {
+            std::cerr << "    WARNING: " << dropped << " phase events of " << name
+                << " were overwritten, increase trace_events to keep them" << std::endl;
+        }
+    }
+
+    void close()
+    {
+        if (is_open()) {
+            file_ << "\n]" << std::endl;
+            file_.close();
+        }
+    }
+
+private:
+    std::ofstream file_;
+    bool first_ = true;
+    int next_pid_ = 1;
+};
+
+static TraceWriter trace_writer;
+
+// Results of all benchmarks run so far, for comparing against a baseline in compare mode
+static BenchResults current_results;
+// Summary records of all benchmarks run so far, for the scaling report
+static json all_records = json::array();
+
+json stats_to_json(const SampleStats& stats)
+{
+    // JSON has no infinity, so an undefined CI (less than two runs) is written as null
+    json ci = std::isfinite(stats.ci_half_width) ? json(stats.ci_half_width) : json(nullptr);
+    return {
+        { "mean", stats.mean },
+        { "stddev", stats.stddev },
+        { "min", stats.min },
+        { "max", stats.max },
+        { "median", stats.median },
+        { "mad", stats.mad },
+        { "p5", stats.p5 },
+        { "p25", stats.p25 },
+        { "p75", stats.p75 },
+        { "p95", stats.p95 },
+        { "ci_half_width", ci }
+    };
+}
+
+/** Pin the process to the given CPUs. Must be called before any worker threads are started, so they inherit it. */
+void pin_to_cpus(const std::vector<int>& cpus)
+{
+    if (cpus.empty()) {
+        return;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        throw std::runtime_error("Could not pin process to the CPUs in pin_cpus.");
+    }
+#else
+    std::cerr << "pin_cpus is only supported on Linux, running unpinned" << std::endl;
+#endif
 }
 
 template <class Cap, class Term, class Flow, class Index, class Data>
 void bench_data(DataConfig data_config, BenchConfig bench_config, const Data& data)
 {
     Flow flow;
-    double build_time, solve_time;
+    double build_time, solve_time, extract_time;
 
     uint16_t num_blocks = 1;
     std::vector<uint16_t> node_blocks;
     if (algo_is_parallel(bench_config.algo)) {
         // Algorithms is parallel so try to load a block file
-        std::tie(node_blocks, num_blocks) = read_blocks(data_config.file_name + ".blk");
+        const std::string blk_fname = data_config.file_name + ".blk";
+        if (data_config.auto_blocks_per_thread > 0 && !fs::exists(blk_fname)) {
+            // Each point of a thread sweep gets its own partition
+            const uint16_t blocks = data_config.auto_blocks_per_thread * bench_config.num_threads;
+            std::tie(node_blocks, num_blocks) = contiguous_blocks(data.num_nodes, blocks);
+        } else if (data_config.auto_blocks > 0 && !fs::exists(blk_fname)) {
+            std::tie(node_blocks, num_blocks) = contiguous_blocks(data.num_nodes, data_config.auto_blocks);
+        } else {
+            std::tie(node_blocks, num_blocks) = read_blocks(blk_fname);
+        }
     }
 
-    for (size_t i = 0; i < bench_config.num_run; i++) {
+    // Serial algorithms do not report blocks
+    uint16_t used_blocks = 1;
+    auto run_once = [&]() {
+        if (algo_is_streamable(bench_config.algo)) {
+            std::tie(flow, build_time, solve_time, extract_time) = bench_serial<Cap, Term, Flow, Index, Data>(bench_config, data);
+        } else if constexpr (!is_graph_stream<std::decay_t<Data>>::value) {
+            switch (bench_config.algo) {
+            case ALGO_HI_PR:
+                std::tie(flow, build_time, solve_time, extract_time) = bench_hi_pr<Cap, Term, Flow, Index, Data>(bench_config, data);
+                break;
+            case ALGO_GRIDCUT:
+                std::tie(flow, build_time, solve_time, extract_time) = bench_gridcut<Cap, Term, Flow, Index, Data>(bench_config, data, data_config);
+                break;
+            // Parallel algorithms
+            case ALGO_PMBK:
+                std::tie(flow, build_time, solve_time, extract_time, used_blocks) = bench_parallel_mbk<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
+                break;
+            case ALGO_PPR:
+                std::tie(flow, build_time, solve_time, extract_time, used_blocks) = bench_parallel_pr<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
+                break;
+            case ALGO_PSK:
+                std::tie(flow, build_time, solve_time, extract_time, used_blocks) = bench_parallel_sk<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
+                break;
+            case ALGO_PARD:
+                std::tie(flow, build_time, solve_time, extract_time, used_blocks) = bench_parallel_rd<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
+                break;
+            case ALGO_PEIBFS:
+                std::tie(flow, build_time, solve_time, extract_time, used_blocks) = bench_parallel_eibfs<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
+                break;
+            case ALGO_GRIDCUT_MT:
+                std::tie(flow, build_time, solve_time, extract_time, used_blocks) = bench_parallel_gridcut<Cap, Term, Flow, Index, Data>(bench_config, data, data_config, node_blocks, num_blocks);
+                break;
+            default:
+                throw std::runtime_error("Unsupported algorithm.");
+            }
+        } else {
+            throw std::runtime_error("Algorithm cannot be run on a streamed graph.");
+        }
+    };
+
+    for (int i = 0; i < bench_config.num_warmup; i++) {
+        run_once();
+    }
+
+    std::vector<double> build_times, solve_times, extract_times;
+    std::vector<double> peak_rss_samples, heap_peak_samples;
+    std::vector<std::vector<double>> counter_samples(perf_counters.names().size());
+    std::vector<std::vector<double>> op_samples(op_stats_names.size());
+    Flow first_flow = 0;
+    bool flow_consistent = true;
+    bool all_verified = true;
+    SampleStats solve_stats;
+    for (int i = 0; i < bench_config.num_run ||
+        (i < bench_config.max_run && solve_stats.rel_ci() > bench_config.target_ci); i++) {
         print_data_config_values(data_config);
         print_data_sizes(data);
-        print_bench_config_values<Cap, Term, Flow, Index>(bench_config);
-
-        uint16_t used_blocks;
-        switch (bench_config.algo) {
-        // Serial algorithms
-        case ALGO_BK:
-            std::tie(flow, build_time, solve_time) = bench_bk<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-	    case ALGO_NBK:
-	        std::tie(flow, build_time, solve_time) = bench_nbk<Cap, Term, Flow, Index, Data>(bench_config, data);
-	        break;
-        case ALGO_MBK:
-            std::tie(flow, build_time, solve_time) = bench_mbk<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-        case ALGO_MBK2:
-            std::tie(flow, build_time, solve_time) = bench_mbk2<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-        case ALGO_EIBFS:
-            std::tie(flow, build_time, solve_time) = bench_eibfs<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-        case ALGO_EIBFS2:
-            std::tie(flow, build_time, solve_time) = bench_eibfs2<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-        case ALGO_EIBFS_OLD:
-            std::tie(flow, build_time, solve_time) = bench_eibfs_old<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-        case ALGO_HPF: // Fall through to default HPF config
-        case ALGO_HPF_HF:
-            std::tie(flow, build_time, solve_time) = bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::HIGHEST_FIRST, reimpls::RootOrder::FIFO>(bench_config, data);
-            break;
-        case ALGO_HPF_HL:
-            std::tie(flow, build_time, solve_time) = bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::HIGHEST_FIRST, reimpls::RootOrder::LIFO>(bench_config, data);
-            break;
-        case ALGO_HPF_LF:
-            std::tie(flow, build_time, solve_time) = bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::LOWEST_FIRST, reimpls::RootOrder::FIFO>(bench_config, data);
-            break;
-        case ALGO_HPF_LL:
-            std::tie(flow, build_time, solve_time) = bench_hpf<Cap, Term, Flow, Index, Data, reimpls::LabelOrder::LOWEST_FIRST, reimpls::RootOrder::LIFO>(bench_config, data);
-            break;
-        case ALGO_HI_PR:
-            std::tie(flow, build_time, solve_time) = bench_hi_pr<Cap, Term, Flow, Index, Data>(bench_config, data);
-            break;
-        case ALGO_GRIDCUT:
-            std::tie(flow, build_time, solve_time) = bench_gridcut<Cap, Term, Flow, Index, Data>(bench_config, data, data_config);
-            break;
-        // Parallel algorithms
-        case ALGO_PMBK:
-            std::tie(flow, build_time, solve_time, used_blocks) = bench_parallel_mbk<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
-            break;
-        case ALGO_PPR:
-            std::tie(flow, build_time, solve_time, used_blocks) = bench_parallel_pr<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
-            break;
-        case ALGO_PSK:
-            std::tie(flow, build_time, solve_time, used_blocks) = bench_parallel_sk<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
-            break;
-        case ALGO_PARD:
-            std::tie(flow, build_time, solve_time, used_blocks) = bench_parallel_rd<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
-            break;
-        case ALGO_PEIBFS:
-            std::tie(flow, build_time, solve_time, used_blocks) = bench_parallel_eibfs<Cap, Term, Flow, Index, Data>(bench_config, data, node_blocks, num_blocks);
-            break;
-        case ALGO_GRIDCUT_MT:
-            std::tie(flow, build_time, solve_time, used_blocks) = bench_parallel_gridcut<Cap, Term, Flow, Index, Data>(bench_config, data, data_config, node_blocks, num_blocks);
-            break;
-        // Dummy and default
-        case ALGO_DUMMY:
-            flow = 0;
-            build_time = 0;
-            solve_time = 0;
-            break;
-        default:
-            throw std::runtime_error("Unsupported algorithm.");
+        // Adaptive runs only know how many runs they make at the end, so runs past num_run count the runs so far
+        print_bench_config_values<Cap, Term, Flow, Index>(bench_config, std::max(bench_config.num_run, i + 1));
+
+        op_stats.reset();
+        perf_counters.clear();
+        certificate.clear();
+        RunMemory memory;
+        const int64_t heap_before = mem_stats::heap_bytes();
+        mem_stats::reset_heap_peak();
+        // Without the reset the peak would be that of the whole process so far, so it is not reported
+        const bool rss_reset = mem_stats::reset_peak_rss();
+        PhaseTrace::instance().clear();
+        run_once();
+        if (rss_reset) {
+            memory.peak_rss = mem_stats::peak_rss_bytes();
+        }
+        if (mem_stats::heap_tracking_available()) {
+            memory.heap_peak = mem_stats::heap_peak_bytes() - heap_before;
+        }
+
+        VerifyResult verified;
+        if (verify) {
+            verified = verify_solve(data, flow, certificate);
+            if (!verified.ok()) {
+                std::cerr << "    VERIFICATION FAILED in run " << i << ": " << verified.error << std::endl;
+                num_verify_failures++;
+                all_verified = false;
+            }
+            certificate.clear();
         }
 
         std::cout << used_blocks << "," << std::flush;
-	    print_results<Cap, Term, Flow>(build_time, solve_time, flow);
+        print_results<Cap, Term, Flow>(build_time, solve_time, flow, extract_time, memory, verified);
+        trace_writer.write_run(data_config.file_name + " " + algo_to_string(bench_config.algo) + " (" +
+            std::to_string(bench_config.num_threads) + " threads) run " + std::to_string(i));
+
+        if (i == 0) {
+            first_flow = flow;
+        }
+        flow_consistent = flow_consistent && flow == first_flow;
+        build_times.push_back(build_time);
+        solve_times.push_back(solve_time);
+        extract_times.push_back(extract_time);
+        if (memory.peak_rss >= 0) {
+            peak_rss_samples.push_back(static_cast<double>(memory.peak_rss));
+        }
+        if (memory.heap_peak >= 0) {
+            heap_peak_samples.push_back(static_cast<double>(memory.heap_peak));
+        }
+        for (size_t c = 0; c < counter_samples.size(); ++c) {
+            if (perf_counters.values()[c] >= 0) {
+                counter_samples[c].push_back(static_cast<double>(perf_counters.values()[c]));
+            }
+        }
+        if (op_stats) {
+            auto values = op_stats_values(*op_stats);
+            for (size_t c = 0; c < op_samples.size(); ++c) {
+                op_samples[c].push_back(static_cast<double>(values[c]));
+            }
+        }
+        solve_stats = compute_stats(solve_times, bench_config.confidence);
+    }
+    if (solve_times.empty()) {
+        return;
+    }
+
+    std::cerr << "    solve_time median " << solve_stats.median << " s, MAD " << solve_stats.mad
+        << " s, CI +-" << 100 * solve_stats.rel_ci() << "% over " << solve_stats.count << " runs";
+    // The target only applies if runs are repeated adaptively, i.e. max_run is larger than num_run
+    const bool adaptive = bench_config.max_run > bench_config.num_run;
+    if (!adaptive || solve_stats.count < static_cast<size_t>(bench_config.max_run) ||
+        solve_stats.rel_ci() <= bench_config.target_ci) {
+        std::cerr << std::endl;
+    } else {
+        std::cerr << " (target " << 100 * bench_config.target_ci << "% not reached)" << std::endl;
+    }
+    if (!flow_consistent) {
+        std::cerr << "    WARNING: maxflow differs between runs" << std::endl;
+    }
+
+    json record = {
+        { "bench_name", data_config.bench_name },
+        { "file_name", data_config.file_name },
+        { "load", load_mode(data_config) },
+        { "algorithm", algo_to_string(bench_config.algo) },
+        { "num_threads", bench_config.num_threads },
+        { "num_blocks", used_blocks },
+        { "cap_type", typeid(Cap).name() },
+        { "term_type", typeid(Term).name() },
+        { "flow_type", typeid(Flow).name() },
+        { "index_type", typeid(Index).name() },
+        { "num_warmup", bench_config.num_warmup },
+        { "num_runs", solve_stats.count },
+        { "confidence", bench_config.confidence },
+        { "maxflow", first_flow },
+        { "maxflow_consistent", flow_consistent },
+        { "build_time", stats_to_json(compute_stats(build_times, bench_config.confidence)) },
+        { "solve_time", stats_to_json(solve_stats) },
+        { "extract_time", stats_to_json(compute_stats(extract_times, bench_config.confidence)) },
+        { "peak_rss", peak_rss_samples.empty() ? json(nullptr)
+            : stats_to_json(compute_stats(peak_rss_samples, bench_config.confidence)) },
+        { "heap_peak", heap_peak_samples.empty() ? json(nullptr)
+            : stats_to_json(compute_stats(heap_peak_samples, bench_config.confidence)) }
+    };
+    for (size_t c = 0; c < counter_samples.size(); ++c) {
+        record[perf_counters.names()[c]] = counter_samples[c].empty() ? json(nullptr)
+            : stats_to_json(compute_stats(counter_samples[c], bench_config.confidence));
+    }
+    if (count_ops) {
+        for (size_t c = 0; c < op_samples.size(); ++c) {
+            record[op_stats_names[c]] = op_samples[c].empty() ? json(nullptr)
+                : stats_to_json(compute_stats(op_samples[c], bench_config.confidence));
+        }
+    }
+    if (verify) {
+        record["verified"] = all_verified;
+    }
+    summary_writer.write(record);
+    current_results[result_key(record)] = result_from_record(record);
+    all_records.push_back(record);
+}
+
+/** Whether the parallel algorithms can run on a data set, i.e. it has a block file or blocks are made for it. */
+bool has_node_blocks(const DataConfig& config)
+{
+    return config.auto_blocks > 0 || config.auto_blocks_per_thread > 0 || fs::exists(config.file_name + ".blk");
+}
+
+/** How a data set is loaded: "stream", "mmap" or "memory". */
+std::string load_mode(const DataConfig& config)
+{
+    return config.stream ? "stream" : config.mmap ? "mmap" : "memory";
+}
+
+Algorithm resolve_auto_algo(const DataConfig& config, const BenchConfig& bc, const GraphFeatures& features)
+{
+    // The parallel algorithms need node blocks, so without them only serial algorithms are considered
+    unsigned int num_threads = has_node_blocks(config) ? bc.num_threads : 1;
+    // Only solvers which are registered for the types of this run can be picked
+    const SolverRule *rule = nullptr;
+    SWITCH_ON_SIGNED_TYPE(bc.cap_type, CapType,
+        SWITCH_ON_FLOW_TYPE(bc.flow_type, FlowType,
+            rule = &select_solver_rule<CapType, CapType, FlowType>(features, num_threads);))
+    std::cerr << "... auto: " << features.num_nodes << " nodes, " << features.num_nbor_arcs << " arcs, "
+        << (features.is_grid ? "grid" : "non-grid") << ", capacities " << features.min_cap << "-" << features.max_cap
+        << " -> " << rule->solver << " (" << rule->reason << ")"
+        << std::endl;
+    return algo_from_string(rule->solver);
+}
+
+template <class Data>
+void bench_loaded(DataConfig config, const std::vector<BenchConfig>& bench_configs, const Data& data)
+{
+    std::cerr << "Benching " << config.file_name << std::endl;
+    GraphFeatures features;
+    bool has_features = false;
+    // Serial algorithms picked by auto for each type combination, which are run once and not for every thread count
+    std::set<std::tuple<TypeCode, TypeCode, TypeCode, TypeCode, Algorithm>> auto_serial;
+    for (BenchConfig bc : bench_configs) {
+        if (bc.algo == ALGO_AUTO) {
+            if (!has_features) {
+                features = compute_graph_features(data, config.grid_type != GRID_TYPE_NO_GRID);
+                has_features = true;
+            }
+            bc.algo = resolve_auto_algo(config, bc, features);
+            if (!algo_is_parallel(bc.algo)) {
+                bc.num_threads = 1;
+                if (!auto_serial.insert({ bc.cap_type, bc.term_type, bc.flow_type, bc.index_type, bc.algo }).second) {
+                    std::cerr << "... " << algo_to_string(bc.algo) << " (SKIPPING: serial algo already run)" << std::endl;
+                    continue;
+                }
+            }
+        }
+        std::cerr << "... " << algo_to_string(bc.algo);
+        if (algo_is_parallel(bc.algo)) {
+            std::cerr << "(" << bc.num_threads << ")";
+        }
+        if (algo_requires_grid(bc.algo) && config.grid_type == GRID_TYPE_NO_GRID) {
+            std::cerr << " (SKIPPING: algo needs grid but data is non-grid)";
+        }
+        std::cerr << std::endl;
+        RUN_BENCH_FUNC(config, bc, data, bench_data);
     }
 }
 
 template <class DataCap, class DataTerm>
 void bench(DataConfig config, std::vector<BenchConfig> bench_configs)
 {
+    if (config.stream && config.file_type != FTYPE_BQ) {
+        // Serial algorithms are built from the file directly. The rest need the whole graph, so it is loaded for them
+        // afterwards as usual.
+        std::vector<BenchConfig> streamed;
+        auto split = std::stable_partition(bench_configs.begin(), bench_configs.end(),
+            [](const BenchConfig& bc) { return algo_is_streamable(bc.algo); });
+        streamed.assign(bench_configs.begin(), split);
+        bench_configs.erase(bench_configs.begin(), split);
+        if (!streamed.empty()) {
+            GraphFormat format = config.file_type == FTYPE_DIMACS ? GRAPH_FORMAT_DIMACS : GRAPH_FORMAT_BBK;
+            bench_loaded(config, streamed, open_graph_stream<DataCap, DataTerm>(config.file_name, format));
+        }
+        if (bench_configs.empty()) {
+            return;
+        }
+    }
+    // The algorithms left are run on a loaded graph, so their records must not report a stream
+    config.stream = false;
+
+    // Only uncompressed binary files can be mapped. The others fall back to the normal readers, so their records
+    // must report "memory".
+    if (config.mmap) {
+        config.mmap = (config.file_type == FTYPE_BBK && is_uncompressed_bbk(config.file_name))
+            || (config.file_type == FTYPE_BQ && is_uncompressed_bq(config.file_name));
+    }
+    if (config.mmap && config.file_type == FTYPE_BBK) {
+        // Solvers are built straight from the mapped file, so no BkGraph copy is made
+        bench_loaded(config, bench_configs, map_bbk_to_view<DataCap, DataTerm>(config.file_name));
+        return;
+    }
+
     BkGraph<DataCap, DataTerm> data;
     if (config.file_type == FTYPE_DIMACS) {
         data = read_dimacs_to_bk<DataCap, DataTerm>(config.file_name);
     } else if (config.file_type == FTYPE_BBK) {
         data = read_bbk_to_bk<DataCap, DataTerm>(config.file_name);
+    } else if (config.file_type == FTYPE_BQ && config.mmap) {
+        // The QPBO must be converted to a graph anyway, but this saves reading the terms into vectors first
+        data = qpbo_to_graph(map_bq_to_view<DataCap>(config.file_name));
     } else if (config.file_type == FTYPE_BQ) {
         data = qpbo_to_graph(read_bq_to_qpbo<DataCap>(config.file_name));
     }
+    bench_loaded(config, bench_configs, data);
+}
 
-    std::cerr << "Benching " << config.file_name << std::endl;
-    for (const auto& bc : bench_configs) {
-        std::cerr << "... " << algo_to_string(bc.algo);
-        if (algo_is_parallel(bc.algo)) {
-            std::cerr << "(" << bc.num_threads << ")";
+/**
+ * Print how the results of this run compare to the baseline and return the exit code: 0 if nothing regressed, 1 if
+ * the solve time of any algorithm and data set regressed or its maxflow changed.
+ */
+int report_comparison(const std::string& baseline_fname, const BenchResults& baseline, double max_slowdown,
+    double confidence)
+{
+    auto comparisons = compare_results(baseline, current_results, max_slowdown, confidence);
+    if (comparisons.empty()) {
+        throw std::runtime_error("No results match the baseline " + baseline_fname);
+    }
+
+    std::cerr << "Comparison against " << baseline_fname << " (max. slowdown " << 100 * max_slowdown
+        << "%, confidence " << 100 * confidence << "%):" << std::endl;
+    int num_failed = 0;
+    for (const auto& cmp : comparisons) {
+        const char *status = "ok";
+        if (cmp.maxflow_changed) {
+            status = "MAXFLOW CHANGED";
+        } else if (cmp.regressed) {
+            status = "REGRESSED";
+        } else if (cmp.ratio > 1 + max_slowdown) {
+            status = "slower, not significant";
         }
-        if (algo_requires_grid(bc.algo) && config.grid_type == GRID_TYPE_NO_GRID) {
-            std::cerr << " (SKIPPING: algo needs grid but data is non-grid)";
+        std::ostringstream change;
+        change << std::showpos << std::fixed << std::setprecision(1) << 100 * (cmp.ratio - 1) << "%";
+        std::cerr << "    " << status << ": " << cmp.key << ", median solve time " << cmp.baseline.solve_time.median
+            << " s -> " << cmp.current.solve_time.median << " s (" << change.str() << ")";
+        if (cmp.maxflow_changed) {
+            std::cerr << ", maxflow " << cmp.baseline.maxflow << " -> " << cmp.current.maxflow;
         }
         std::cerr << std::endl;
-        RUN_BENCH_FUNC(config, bc, data, bench_data);
+        if (cmp.regressed || cmp.maxflow_changed) {
+            num_failed++;
+        }
+    }
+    if (comparisons.size() < current_results.size()) {
+        std::cerr << "    " << current_results.size() - comparisons.size() << " results have no baseline" << std::endl;
+    }
+    std::cerr << (num_failed ? "FAILED: " : "PASSED: ") << num_failed << " of " << comparisons.size()
+        << " results regressed" << std::endl;
+    return num_failed ? 1 : 0;
+}
+
+/**
+ * Print strong scaling of each parallel algorithm which was run with more than one thread count: speedup and parallel
+ * efficiency of the median solve time relative to the smallest thread count, and speedup relative to the fastest
+ * serial algorithm on the same data set, if any was run. If scaling_fname is not empty, the table is also written
+ * there as CSV.
+ */
+void report_scaling(const std::string& scaling_fname)
+{
+    auto types_key = [](const json& r) {
+        return r["cap_type"].get<std::string>() + "," + r["term_type"].get<std::string>() + ","
+            + r["flow_type"].get<std::string>() + "," + r["index_type"].get<std::string>();
+    };
+    auto median = [](const json& r) {
+        return r["solve_time"]["median"].get<double>();
+    };
+    // Data sets with the same file can differ in how they are loaded
+    auto data_name = [](const json& r) {
+        return r["file_name"].get<std::string>() + " [" + r["load"].get<std::string>() + "]";
+    };
+
+    std::map<std::string, std::vector<json>> groups;
+    std::map<std::string, const json *> best_serial;
+    for (const auto& r : all_records) {
+        Algorithm algo = algo_from_string(r["algorithm"]);
+        std::string data_key = data_name(r) + " " + types_key(r);
+        if (algo_is_parallel(algo)) {
+            groups[data_key + " " + r["algorithm"].get<std::string>()].push_back(r);
+        } else {
+            auto& best = best_serial[data_key];
+            if (!best || median(r) < median(*best)) {
+                best = &r;
+            }
+        }
+    }
+
+    std::fstream csv;
+    if (!scaling_fname.empty()) {
+        csv.open(scaling_fname, std::ios::out);
+        if (!csv.is_open()) {
+            throw std::runtime_error("Could not open scaling_file: " + scaling_fname);
+        }
+        csv << "bench_name,file_name,load,algorithm,cap_type,term_type,flow_type,index_type,num_threads,num_blocks,"
+            << "solve_time_median,speedup,efficiency,best_serial,speedup_vs_serial\n";
+    }
+
+    for (auto& group : groups) {
+        auto& rs = group.second;
+        if (rs.size() < 2) {
+            continue;
+        }
+        std::sort(rs.begin(), rs.end(), [](const json& a, const json& b) {
+            return a["num_threads"].get<int>() < b["num_threads"].get<int>();
+        });
+        const json& base = rs.front();
+        const int base_threads = base["num_threads"];
+        auto serial = best_serial.find(data_name(base) + " " + types_key(base));
+        const json *best = serial != best_serial.end() ? serial->second : nullptr;
+
+        std::cerr << "Scaling of " << base["algorithm"].get<std::string>() << " on "
+            << data_name(base) << " (" << types_key(base) << "), relative to "
+            << base_threads << " thread" << (base_threads > 1 ? "s" : "");
+        if (best) {
+            std::cerr << " and to " << (*best)["algorithm"].get<std::string>();
+        }
+        std::cerr << ":" << std::endl;
+        std::cerr << "    threads  blocks  median [s]  speedup  efficiency" << (best ? "  vs. serial" : "") << std::endl;
+        for (const auto& r : rs) {
+            const int threads = r["num_threads"];
+            const double speedup = median(base) / median(r);
+            const double efficiency = speedup * base_threads / threads;
+            const double vs_serial = best ? median(*best) / median(r) : NAN;
+            std::ostringstream line;
+            line << std::fixed << "    " << std::setw(7) << threads << "  " << std::setw(6)
+                << r["num_blocks"].get<int>() << "  " << std::setw(10) << std::setprecision(6) << median(r) << "  "
+                << std::setw(7) << std::setprecision(2) << speedup << "  " << std::setw(9) << std::setprecision(1)
+                << 100 * efficiency << "%";
+            if (best) {
+                line << "  " << std::setw(11) << std::setprecision(2) << vs_serial;
+            }
+            std::cerr << line.str() << std::endl;
+
+            if (csv.is_open()) {
+                csv << r["bench_name"].get<std::string>() << "," << r["file_name"].get<std::string>() << ","
+                    << r["load"].get<std::string>() << "," << r["algorithm"].get<std::string>() << ","
+                    << types_key(r) << "," << threads << "," << r["num_blocks"].get<int>() << "," << median(r) << ","
+                    << speedup << "," << efficiency << ",";
+                if (best) {
+                    csv << (*best)["algorithm"].get<std::string>() << "," << vs_serial;
+                } else {
+                    csv << ",";
+                }
+                csv << "\n";
+            }
+        }
     }
 }
 
 int main(int argc, const char* argv[])
 {
+    // bench compare <config> <baseline> [max_slowdown] reruns config and compares it to an earlier result
+    const bool compare = argc >= 2 && std::string(argv[1]) == "compare";
+    if (compare && argc < 4) {
+        std::cerr << "usage: bench compare <config> <baseline> [max_slowdown]" << std::endl;
+        return 2;
+    }
+
     std::string fname;
     if (argc < 2) {
         /*std::cout << "usage: demo <config>\n";
         return -1;*/
         fname = "C:/Users/patmjen/Documents/HCP Anywhere/projects/parallel-qpbo/bench_config.json";
     } else {
-        fname = argv[1];
+        fname = argv[compare ? 2 : 1];
     }
 
     json config;
@@ -1331,7 +2292,39 @@ int main(int argc, const char* argv[])
         std::vector<BenchConfig> bench_configs = gen_bench_configs(config);
         std::vector<DataConfig> data_configs = gen_data_configs(config);
 
-	    print_config_header();
+        // Load the baseline first so a bad file is found before running anything
+        const double confidence = config.value("confidence", 0.95);
+        const double max_slowdown = argc >= 5 ? std::stod(argv[4]) : 0.05;
+        BenchResults baseline;
+        if (compare) {
+            if (config.contains("summary_file") && fs::exists(argv[3]) &&
+                fs::equivalent(config["summary_file"].get<std::string>(), argv[3])) {
+                throw std::runtime_error("The summary_file of the config would overwrite the baseline.");
+            }
+            baseline = load_results(argv[3], confidence);
+        }
+
+        pin_to_cpus(config.value("pin_cpus", std::vector<int>()));
+        verify = config.value("verify", false);
+        perf_counters.open(config.value("counters", std::vector<std::string>()));
+        if (config.contains("summary_file")) {
+            auto counter_names = perf_counters.names();
+            if (count_ops) {
+                counter_names.insert(counter_names.end(), op_stats_names.begin(), op_stats_names.end());
+            }
+            summary_writer.open(config["summary_file"], counter_names);
+        }
+        if (config.contains("trace_file")) {
+            if (phase_trace_enabled) {
+                PhaseTrace::instance().set_capacity(config.value("trace_events", 1 << 18));
+                trace_writer.open(config["trace_file"]);
+            } else {
+                std::cerr << "WARNING: trace_file is ignored, build with the CMake option maxflow_algos_trace_phases "
+                    << "to record phases" << std::endl;
+            }
+        }
+
+        print_config_header();
 
         for (const auto& dc : data_configs) {
             if (dc.nbor_cap_type != TYPE_INT32 || dc.term_cap_type != TYPE_INT32) {
@@ -1339,8 +2332,25 @@ int main(int argc, const char* argv[])
             }
             bench<int, int>(dc, bench_configs);
         }
+
+        trace_writer.close();
+        report_scaling(config.value("scaling_file", ""));
+
+        if (num_verify_failures > 0) {
+            std::cerr << num_verify_failures << " runs failed verification" << std::endl;
+        }
+        if (compare) {
+            int status = report_comparison(argv[3], baseline, max_slowdown, confidence);
+            return num_verify_failures > 0 ? std::max(status, 1) : status;
+        }
+        if (num_verify_failures > 0) {
+            return 1;
+        }
     } catch (std::exception& e) {
         std::cerr << e.what() << std::endl;
+        if (compare) {
+            return 2;
+        }
     }
 
     return 0;
@@ -1406,6 +2416,8 @@ const char* algo_to_string(Algorithm algo)
     case ALGO_GRIDCUT_MT:
         return "gridcut_mt";
 
+    case ALGO_AUTO:
+        return "auto";
     case ALGO_DUMMY:
         return "dummy";
     default:
@@ -1437,6 +2449,7 @@ Algorithm algo_from_string(const std::string& str)
     if (str == algo_to_string(ALGO_PEIBFS)) return ALGO_PEIBFS;
     if (str == algo_to_string(ALGO_GRIDCUT_MT)) return ALGO_GRIDCUT_MT;
 
+    if (str == algo_to_string(ALGO_AUTO)) return ALGO_AUTO;
     if (str == algo_to_string(ALGO_DUMMY)) return ALGO_DUMMY;
     throw std::invalid_argument("Invalid algorithm.");
 }
@@ -1501,15 +2514,63 @@ bool algo_requires_grid(Algorithm algo)
     return algo == ALGO_GRIDCUT || algo == ALGO_GRIDCUT_MT;
 }
 
+bool algo_is_streamable(Algorithm algo)
+{
+    return
+        algo == ALGO_BK ||
+        algo == ALGO_NBK ||
+        algo == ALGO_MBK ||
+        algo == ALGO_MBK2 ||
+        algo == ALGO_EIBFS ||
+        algo == ALGO_EIBFS2 ||
+        algo == ALGO_EIBFS_OLD ||
+        algo == ALGO_HPF ||
+        algo == ALGO_HPF_HF ||
+        algo == ALGO_HPF_HL ||
+        algo == ALGO_HPF_LF ||
+        algo == ALGO_HPF_LL ||
+        algo == ALGO_DUMMY;
+}
+
+std::vector<int> thread_counts(const json& parallel)
+{
+    if (!parallel.contains("max_threads")) {
+        return parallel["threads"].get<std::vector<int>>();
+    }
+    // Sweep powers of two up to max_threads, and max_threads itself
+    const int max_threads = parallel["max_threads"];
+    if (max_threads < 1) {
+        throw std::invalid_argument("max_threads must be positive.");
+    }
+    std::vector<int> out;
+    for (int threads = 1; threads < max_threads; threads *= 2) {
+        out.push_back(threads);
+    }
+    out.push_back(max_threads);
+    return out;
+}
+
 std::vector<BenchConfig> gen_bench_configs(json config)
 {
     std::vector<BenchConfig> out;
+    int num_warmup = config.value("num_warmup", 0);
+    int max_run = std::max(config.value("max_run", 0), config["num_run"].get<int>());
+    double target_ci = config.value("target_ci", 0.05);
+    double confidence = config.value("confidence", 0.95);
+    if (confidence <= 0 || confidence >= 1) {
+        throw std::invalid_argument("confidence must be between 0 and 1.");
+    }
+    // auto can only pick a parallel algorithm for data sets with node blocks, and is then run for each thread count
+    bool auto_parallel = false;
+    for (const auto& data_config : gen_data_configs(config)) {
+        auto_parallel = auto_parallel || has_node_blocks(data_config);
+    }
     for (auto& type_config : config["types"]) {
         for (auto& algo : config["algorithms"]) {
             auto algorithm = algo_from_string(algo);
-            if (algo_is_parallel(algorithm) && config.contains("parallel")) {
-                auto& parallel = config["parallel"];
-                for (auto& threads : parallel["threads"]) {
+            bool per_thread_count = algo_is_parallel(algorithm) || (algorithm == ALGO_AUTO && auto_parallel);
+            if (per_thread_count && config.contains("parallel")) {
+                for (int threads : thread_counts(config["parallel"])) {
                     out.push_back({
                         config["name"],
                         code_from_string(type_config["cap"]),
@@ -1518,7 +2579,11 @@ std::vector<BenchConfig> gen_bench_configs(json config)
                         code_from_string(type_config["index"]),
                         algorithm,
                         config["num_run"],
-                        threads.get<int>()
+                        threads,
+                        num_warmup,
+                        max_run,
+                        target_ci,
+                        confidence
                     });
                 }
             } else {
@@ -1530,7 +2595,11 @@ std::vector<BenchConfig> gen_bench_configs(json config)
                     code_from_string(type_config["index"]),
                     algorithm,
                     config["num_run"],
-                    1
+                    1,
+                    num_warmup,
+                    max_run,
+                    target_ci,
+                    confidence
                 });
             }
         }
@@ -1548,6 +2617,14 @@ std::vector<DataConfig> gen_data_configs(json config)
         data_config.term_cap_type = code_from_string(data["term_cap_type"]);
         data_config.file_name = data["file_name"];
         data_config.file_type = ftype_from_string(data["file_type"]);
+        data_config.mmap = data.value("mmap", false);
+        data_config.stream = data.value("stream", false);
+        data_config.auto_blocks = config.contains("parallel") ? config["parallel"].value("auto_blocks", 0) : 0;
+        data_config.auto_blocks_per_thread =
+            config.contains("parallel") ? config["parallel"].value("auto_blocks_per_thread", 0) : 0;
+        if (data_config.auto_blocks > 0 && data_config.auto_blocks_per_thread > 0) {
+            throw std::invalid_argument("Only one of auto_blocks and auto_blocks_per_thread can be set.");
+        }
         if (data.contains("grid_info")) {
             const auto& grid_info = data["grid_info"];
             data_config.grid_type = grid_type_from_string(grid_info["grid_type"]);
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __cplusplus >= 201700L
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#endif
+
+#include "graph_io.h"
+#include "maxflow_solver.h"
+
+using Duration = std::chrono::duration<double>;
+static const auto now = std::chrono::steady_clock::now;
+
+using Solver = MaxflowSolver<int, int, int64_t>;
+
+/** Result of solving one instance. */
+struct InstanceResult {
+    std::string algorithm;
+    unsigned int worker = 0;
+    uint64_t num_nodes = 0;
+    uint64_t num_term_arcs = 0;
+    uint64_t num_nbor_arcs = 0;
+    double read_time = 0;
+    double build_time = 0;
+    double solve_time = 0;
+    int64_t maxflow = 0;
+    std::string error; // Empty if the instance was solved
+};
+
+bool is_graph_file(const fs::path& path)
+{
+    return path.extension() == ".max" || path.extension() == ".bbk";
+}
+
+/**
+ * Instances to solve: all .max and .bbk files of a directory, or the files listed in a manifest with one path per
+ * line. Paths in a manifest are relative to its directory. Empty lines and lines starting with # are skipped.
+ */
+std::vector<std::string> list_instances(const std::string& source)
+{
+    std::vector<std::string> out;
+    if (fs::is_directory(source)) {
+        for (const auto& entry : fs::directory_iterator(source)) {
+            if (entry.is_regular_file() && is_graph_file(entry.path())) {
+                out.push_back(entry.path().string());
+            }
+        }
+        std::sort(out.begin(), out.end());
+    } else {
+        std::ifstream manifest(source);
+        if (!manifest.is_open()) {
+            throw std::runtime_error("Could not open manifest: " + source);
+        }
+        const fs::path dir = fs::path(source).parent_path();
+        std::string line;
+        while (std::getline(manifest, line)) {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            fs::path path(line);
+            out.push_back(path.is_absolute() ? path.string() : (dir / path).string());
+        }
+    }
+    if (out.empty()) {
+        throw std::runtime_error("No instances found in " + source);
+    }
+    return out;
+}
+
+/**
+ * One worker of the batch. It keeps a solver per algorithm name and rebuilds it for each instance, so the solver's
+ * node and arc arrays are only reallocated when an instance is larger than all earlier ones.
+ */
+class BatchWorker {
+public:
+    BatchWorker(unsigned int id, const std::string& algorithm) : id_(id), algorithm_(algorithm) {}
+
+    InstanceResult solve(const std::string& fname)
+    {
+        InstanceResult res;
+        res.worker = id_;
+        res.algorithm = algorithm_;
+        try {
+            auto read_begin = now();
+            // Instances are solved concurrently, so each file is read with a single thread
+            BkGraph<int, int> graph = fname.size() >= 4 && fname.compare(fname.size() - 4, 4, ".bbk") == 0 ?
+                read_bbk_to_bk<int, int>(fname) : read_dimacs_to_bk<int, int>(fname, 1);
+            res.read_time = Duration(now() - read_begin).count();
+            res.num_nodes = graph.num_nodes;
+            res.num_term_arcs = graph.terminal_arcs.size();
+            res.num_nbor_arcs = graph.neighbor_arcs.size();
+
+            if (algorithm_ == "auto") {
+                res.algorithm = select_solver<int, int, int64_t>(compute_graph_features(graph));
+            }
+            Solver& solver = get_solver(res.algorithm);
+            solver.build(graph);
+            res.maxflow = solver.solve();
+            res.build_time = solver.timings().build_time;
+            res.solve_time = solver.timings().solve_time;
+        } catch (const std::exception& e) {
+            res.error = e.what();
+        }
+        return res;
+    }
+
+private:
+    Solver& get_solver(const std::string& name)
+    {
+        auto& solver = solvers_[name];
+        if (!solver) {
+            solver = SolverRegistry<int, int, int64_t>::instance().create(name);
+        }
+        return *solver;
+    }
+
+    unsigned int id_;
+    std::string algorithm_;
+    std::map<std::string, std::unique_ptr<Solver>> solvers_;
+};
+
+std::string csv_escape(const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos) {
+        return str;
+    }
+    std::string out = "\"";
+    for (char c : str) {
+        out += c == '"' ? "\"\"" : std::string(1, c);
+    }
+    return out + "\"";
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 2) {
+        std::cout << "usage: bench_batch <dir_or_manifest> [<algo>] [<num_threads>]\n";
+        std::cout << "  Solve all instances concurrently with ALGO (default mbk_r) on NUM_THREADS threads\n";
+        std::cout << "  (default one per core). ALGO is any serial solver name or auto.\n";
+        return 0;
+    }
+    const std::string source = argv[1];
+    const std::string algorithm = argc > 2 ? argv[2] : "mbk_r";
+    unsigned int num_threads = argc > 3 ? std::stoi(argv[3]) : default_num_threads();
+
+    try {
+        if (algorithm != "auto") {
+            // Fail early on a bad name instead of once per instance
+            SolverRegistry<int, int, int64_t>::instance().create(algorithm);
+        }
+        const std::vector<std::string> instances = list_instances(source);
+        num_threads = static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(num_threads, instances.size())));
+
+        std::cout << "file_name,algorithm,worker,num_nodes,num_term_arcs,num_nbor_arcs,"
+            << "read_time,build_time,solve_time,maxflow,error\n";
+        std::vector<InstanceResult> results(instances.size());
+        std::atomic<size_t> next(0);
+        std::mutex print_mutex;
+        auto batch_begin = now();
+        auto work = [&](unsigned int id) {
+            BatchWorker worker(id, algorithm);
+            for (size_t i = next++; i < instances.size(); i = next++) {
+                results[i] = worker.solve(instances[i]);
+                const InstanceResult& r = results[i];
+                std::ostringstream line;
+                line << csv_escape(instances[i]) << "," << r.algorithm << "," << r.worker << "," << r.num_nodes << ","
+                    << r.num_term_arcs << "," << r.num_nbor_arcs << "," << r.read_time << "," << r.build_time << ","
+                    << r.solve_time << "," << (r.error.empty() ? std::to_string(r.maxflow) : "") << ","
+                    << csv_escape(r.error) << "\n";
+                std::lock_guard<std::mutex> lock(print_mutex);
+                std::cout << line.str();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& th : threads) {
+            th.join();
+        }
+        const double wall_time = Duration(now() - batch_begin).count();
+
+        size_t num_failed = 0;
+        double read_time = 0, build_time = 0, solve_time = 0;
+        for (const auto& r : results) {
+            num_failed += !r.error.empty();
+            read_time += r.read_time;
+            build_time += r.build_time;
+            solve_time += r.solve_time;
+        }
+        const size_t num_solved = instances.size() - num_failed;
+        std::cerr << "Solved " << num_solved << " of " << instances.size() << " instances with " << algorithm
+            << " on " << num_threads << " threads in " << wall_time << " s: " << num_solved / wall_time
+            << " graphs/s" << std::endl;
+        std::cerr << "    summed over instances: read " << read_time << " s, build " << build_time << " s, solve "
+            << solve_time << " s" << std::endl;
+        if (num_failed) {
+            std::cerr << "    " << num_failed << " instances failed, see the error column" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+#ifndef BENCH_COMPARE_H__
+#define BENCH_COMPARE_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "bench_stats.h"
+
+/** Solve time and flow of one algorithm on one data set, from a summary record or from the runs of a result CSV. */
+struct BenchResult {
+    SampleStats solve_time;
+    int64_t maxflow = 0;
+};
+
+/**
+ * Results keyed by data set, how it was loaded, algorithm, thread count and types, so runs of the same config can be
+ * matched up. The bench name is not part of the key, since the same config may be saved under different names.
+ */
+using BenchResults = std::map<std::string, BenchResult>;
+
+inline std::string result_key(const std::string& file_name, const std::string& load, const std::string& algorithm,
+    int num_threads, const std::string& cap_type, const std::string& term_type, const std::string& flow_type,
+    const std::string& index_type)
+{
+    return file_name + " [" + load + "] " + algorithm + "(" + std::to_string(num_threads) + ") " + cap_type + ","
+        + term_type + "," + flow_type + "," + index_type;
+}
+
+inline std::string result_key(const nlohmann::json& record)
+{
+    // Records from before the load field was added are of data sets loaded in memory
+    return result_key(record.at("file_name"), record.value("load", std::string("memory")), record.at("algorithm"),
+        record.at("num_threads"), record.at("cap_type"), record.at("term_type"), record.at("flow_type"),
+        record.at("index_type"));
+}
+
+/** Read the solve time stats back from a summary record. A CI which was written as null is infinite. */
+inline BenchResult result_from_record(const nlohmann::json& record)
+{
+    const nlohmann::json& solve = record.at("solve_time");
+    BenchResult res;
+    res.maxflow = record.at("maxflow");
+    res.solve_time.count = record.at("num_runs");
+    res.solve_time.mean = solve.at("mean");
+    res.solve_time.stddev = solve.at("stddev");
+    res.solve_time.min = solve.at("min");
+    res.solve_time.max = solve.at("max");
+    res.solve_time.median = solve.at("median");
+    res.solve_time.mad = solve.at("mad");
+    res.solve_time.ci_half_width = solve.at("ci_half_width").is_null() ? INFINITY : solve.at("ci_half_width").get<double>();
+    return res;
+}
+
+namespace compare_detail {
+
+inline std::vector<std::string> split_csv_line(const std::string& line)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(line);
+    std::string cell;
+    while (std::getline(ss, cell, ',')) {
+        out.push_back(cell);
+    }
+    if (!line.empty() && line.back() == ',') {
+        out.push_back("");
+    }
+    return out;
+}
+
+inline size_t column(const std::vector<std::string>& header, const std::string& name)
+{
+    auto it = std::find(header.begin(), header.end(), name);
+    if (it == header.end()) {
+        throw std::runtime_error("Result file has no column: " + name);
+    }
+    return it - header.begin();
+}
+
+} // namespace compare_detail
+
+/**
+ * Load results written by bench. Accepted are a JSON or CSV summary_file, or the CSV bench prints to stdout with one
+ * line per run, in which case the runs of each key are summarized here with the given confidence.
+ */
+inline BenchResults load_results(const std::string& fname, double confidence)
+{
+    using namespace compare_detail;
+    std::ifstream file(fname);
+    if (!file) {
+        throw std::runtime_error("Could not open result file: " + fname);
+    }
+
+    BenchResults results;
+    if (fname.size() >= 5 && fname.compare(fname.size() - 5, 5, ".json") == 0) {
+        nlohmann::json records;
+        file >> records;
+        for (const auto& record : records) {
+            results[result_key(record)] = result_from_record(record);
+        }
+        return results;
+    }
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        throw std::runtime_error("Result file is empty: " + fname);
+    }
+    std::vector<std::string> header = split_csv_line(line);
+    bool is_summary = std::find(header.begin(), header.end(), "solve_time_median") != header.end();
+
+    const size_t file_col = column(header, "file_name");
+    // Files from before the load column was added are of data sets loaded in memory
+    const bool has_load = std::find(header.begin(), header.end(), "load") != header.end();
+    const size_t load_col = has_load ? column(header, "load") : 0;
+    const size_t algo_col = column(header, "algorithm");
+    const size_t threads_col = column(header, "num_threads");
+    const size_t cap_col = column(header, "cap_type");
+    const size_t term_col = column(header, "term_type");
+    const size_t flow_col = column(header, "flow_type");
+    const size_t index_col = column(header, "index_type");
+    const size_t maxflow_col = column(header, "maxflow");
+
+    std::map<std::string, std::vector<double>> run_times;
+    while (std::getline(file, line)) {
+        std::vector<std::string> cells = split_csv_line(line);
+        if (cells.size() < header.size()) {
+            // A run which crashed before printing its results
+            continue;
+        }
+        std::string key = result_key(cells[file_col], has_load ? cells[load_col] : "memory", cells[algo_col],
+            std::stoi(cells[threads_col]), cells[cap_col], cells[term_col], cells[flow_col], cells[index_col]);
+        BenchResult& res = results[key];
+        res.maxflow = std::stoll(cells[maxflow_col]);
+        if (is_summary) {
+            auto stat = [&](const char *name) {
+                const std::string& cell = cells[column(header, std::string("solve_time_") + name)];
+                return cell.empty() ? INFINITY : std::stod(cell);
+            };
+            res.solve_time.count = std::stoul(cells[column(header, "num_runs")]);
+            res.solve_time.mean = stat("mean");
+            res.solve_time.stddev = stat("stddev");
+            res.solve_time.min = stat("min");
+            res.solve_time.max = stat("max");
+            res.solve_time.median = stat("median");
+            res.solve_time.mad = stat("mad");
+            res.solve_time.ci_half_width = stat("ci_half_width");
+        } else {
+            run_times[key].push_back(std::stod(cells[column(header, "solve_time")]));
+        }
+    }
+    for (const auto& rt : run_times) {
+        results[rt.first].solve_time = compute_stats(rt.second, confidence);
+    }
+    return results;
+}
+
+/** Outcome of comparing one key of a new run against the baseline. */
+struct ResultComparison {
+    std::string key;
+    BenchResult baseline;
+    BenchResult current;
+    // Median solve time of the new run relative to the baseline
+    double ratio = 1;
+    // The mean is larger with the given confidence by Welch's t-test, or there are too few runs to tell
+    bool significant = false;
+    bool regressed = false;
+    bool maxflow_changed = false;
+};
+
+/**
+ * True if the mean of current is larger than the mean of baseline by a one-sided Welch's t-test at the given
+ * confidence. With less than two runs on either side there is no variance estimate, so any increase counts.
+ */
+inline bool is_significantly_slower(const SampleStats& baseline, const SampleStats& current, double confidence)
+{
+    if (baseline.count < 2 || current.count < 2) {
+        return current.mean > baseline.mean;
+    }
+    double v1 = baseline.stddev * baseline.stddev / baseline.count;
+    double v2 = current.stddev * current.stddev / current.count;
+    double se = std::sqrt(v1 + v2);
+    if (se == 0) {
+        return current.mean > baseline.mean;
+    }
+    // Welch-Satterthwaite degrees of freedom
+    double dof = (v1 + v2) * (v1 + v2) /
+        (v1 * v1 / (baseline.count - 1) + v2 * v2 / (current.count - 1));
+    double t = (current.mean - baseline.mean) / se;
+    return t > student_t_quantile(confidence, std::max<size_t>(1, static_cast<size_t>(dof)));
+}
+
+/**
+ * Compare all keys of current which are also in baseline. A key has regressed if its median solve time grew by more
+ * than max_slowdown (relative) and the increase is significant. A changed maxflow is always reported.
+ */
+inline std::vector<ResultComparison> compare_results(const BenchResults& baseline, const BenchResults& current,
+    double max_slowdown, double confidence)
+{
+    std::vector<ResultComparison> out;
+    for (const auto& cur : current) {
+        auto base = baseline.find(cur.first);
+        if (base == baseline.end()) {
+            continue;
+        }
+        ResultComparison cmp;
+        cmp.key = cur.first;
+        cmp.baseline = base->second;
+        cmp.current = cur.second;
+        cmp.ratio = cmp.baseline.solve_time.median > 0 ?
+            cmp.current.solve_time.median / cmp.baseline.solve_time.median : 1;
+        cmp.significant = is_significantly_slower(cmp.baseline.solve_time, cmp.current.solve_time, confidence);
+        cmp.regressed = cmp.ratio > 1 + max_slowdown && cmp.significant;
+        cmp.maxflow_changed = cmp.baseline.maxflow != cmp.current.maxflow;
+        out.push_back(cmp);
+    }
+    return out;
+}
+
+#endif // BENCH_COMPARE_H__
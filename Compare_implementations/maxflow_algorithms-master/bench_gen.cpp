@@ -0,0 +1,491 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <map>
+#include <set>
+#include <limits>
+
+#include "graph_io.h"
+
+using Graph = BkGraph<int32_t, int32_t>;
+
+/**
+ * SplitMix64 random generator. It is small and fast to seed, so every chunk of a graph gets its own generator
+ * seeded from the chunk index, which makes the output independent of the number of threads.
+ */
+class Rng {
+public:
+    Rng(uint64_t seed, uint64_t stream) : state(seed * 0x9E3779B97F4A7C15ull + stream)
+    {
+        next();
+    }
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /** Uniform in [lo, hi]. */
+    int64_t uniform(int64_t lo, int64_t hi)
+    {
+        return lo + static_cast<int64_t>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    /** Uniform in [0, 1). */
+    double real()
+    {
+        return (next() >> 11) * (1.0 / (1ull << 53));
+    }
+
+private:
+    uint64_t state;
+};
+
+/** Options given as key=value arguments. Every option has to be read, so a misspelled key is an error. */
+class Options {
+public:
+    Options(int argc, const char *argv[], int first)
+    {
+        for (int i = first; i < argc; ++i) {
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                throw std::invalid_argument("Option must be key=value: " + arg);
+            }
+            values[arg.substr(0, eq)] = arg.substr(eq + 1);
+        }
+    }
+
+    int64_t get_int(const std::string& key, int64_t def)
+    {
+        used.insert(key);
+        auto it = values.find(key);
+        return it == values.end() ? def : std::stoll(it->second);
+    }
+
+    double get_double(const std::string& key, double def)
+    {
+        used.insert(key);
+        auto it = values.find(key);
+        return it == values.end() ? def : std::stod(it->second);
+    }
+
+    void check_all_used() const
+    {
+        for (const auto& kv : values) {
+            if (!used.count(kv.first)) {
+                throw std::invalid_argument("Unknown option: " + kv.first);
+            }
+        }
+    }
+
+private:
+    std::map<std::string, std::string> values;
+    std::set<std::string> used;
+};
+
+void check_positive(int64_t value, const char *name)
+{
+    if (value < 1) {
+        throw std::invalid_argument(std::string(name) + " must be positive");
+    }
+}
+
+int32_t checked_cap(int64_t cap)
+{
+    if (cap > std::numeric_limits<int32_t>::max()) {
+        throw std::invalid_argument("Capacity " + std::to_string(cap) + " does not fit in int32");
+    }
+    return static_cast<int32_t>(cap);
+}
+
+/**
+ * Build a graph from num_items items (nodes, frames, ...) in parallel. Items are split into chunks of
+ * items_per_chunk, gen(item, rng, part) appends the arcs of one item to the part of its chunk, and the parts are
+ * concatenated in order.
+ */
+template <class Func>
+Graph generate_chunked(uint64_t num_nodes, size_t num_items, size_t items_per_chunk, uint64_t seed,
+    unsigned int num_threads, Func gen)
+{
+    const size_t num_chunks = (num_items + items_per_chunk - 1) / items_per_chunk;
+    std::vector<Graph> parts(num_chunks);
+    parallel_for(num_chunks, num_threads, [&](size_t c) {
+        Func chunk_gen = gen; // Own copy of any scratch space captured by gen
+        Rng rng(seed, c);
+        size_t last = std::min(num_items, (c + 1) * items_per_chunk);
+        for (size_t item = c * items_per_chunk; item < last; ++item) {
+            chunk_gen(item, rng, parts[c]);
+        }
+    });
+
+    std::vector<size_t> term_offsets(num_chunks + 1, 0);
+    std::vector<size_t> nbor_offsets(num_chunks + 1, 0);
+    for (size_t c = 0; c < num_chunks; ++c) {
+        term_offsets[c + 1] = term_offsets[c] + parts[c].terminal_arcs.size();
+        nbor_offsets[c + 1] = nbor_offsets[c] + parts[c].neighbor_arcs.size();
+    }
+    Graph graph;
+    graph.num_nodes = num_nodes;
+    graph.terminal_arcs.resize(term_offsets.back());
+    graph.neighbor_arcs.resize(nbor_offsets.back());
+    parallel_for(num_chunks, num_threads, [&](size_t c) {
+        std::copy(parts[c].terminal_arcs.begin(), parts[c].terminal_arcs.end(),
+            graph.terminal_arcs.begin() + term_offsets[c]);
+        std::copy(parts[c].neighbor_arcs.begin(), parts[c].neighbor_arcs.end(),
+            graph.neighbor_arcs.begin() + nbor_offsets[c]);
+        parts[c] = Graph(); // Free memory early
+    });
+    return graph;
+}
+
+/** Pick count distinct values in [0, n) by rejection. count must be small compared to n. */
+void pick_distinct(Rng& rng, uint64_t n, size_t count, std::vector<uint64_t>& out)
+{
+    out.clear();
+    while (out.size() < count) {
+        uint64_t v = rng.next() % n;
+        if (std::find(out.begin(), out.end(), v) == out.end()) {
+            out.push_back(v);
+        }
+    }
+}
+
+/**
+ * Vision-style 2D or 3D grid. Node (i, j, k) has index i + j * h + k * h * w, which matches the grid blocks of
+ * grid_block_intervals. Neighbor arcs get the same random capacity in both directions. Each node gets a terminal
+ * arc to either the source or the sink with probability term_density.
+ */
+Graph gen_grid(Options& opt, uint64_t seed, unsigned int num_threads, const std::string& fname)
+{
+    const int64_t h = opt.get_int("h", 512);
+    const int64_t w = opt.get_int("w", 512);
+    const int64_t d = opt.get_int("d", 1);
+    const int64_t conn = opt.get_int("conn", d == 1 ? 4 : 6);
+    const int64_t max_cap = opt.get_int("max_cap", 100);
+    const int64_t max_term_cap = opt.get_int("max_term_cap", max_cap);
+    const double term_density = opt.get_double("term_density", 0.5);
+    const int64_t block_h = opt.get_int("block_h", 0);
+    const int64_t block_w = opt.get_int("block_w", block_h);
+    const int64_t block_d = opt.get_int("block_d", d == 1 ? 1 : block_h);
+    check_positive(h, "h");
+    check_positive(w, "w");
+    check_positive(d, "d");
+    check_positive(max_cap, "max_cap");
+    check_positive(max_term_cap, "max_term_cap");
+    checked_cap(max_cap);
+    checked_cap(max_term_cap);
+
+    opt.check_all_used();
+
+    // Offsets to the neighbors with larger index, i.e. half of the stencil
+    struct Offset {
+        int di, dj, dk;
+    };
+    std::vector<Offset> offsets;
+    for (int dk = -1; dk <= 1; ++dk) {
+        for (int dj = -1; dj <= 1; ++dj) {
+            for (int di = -1; di <= 1; ++di) {
+                int dist = std::abs(di) + std::abs(dj) + std::abs(dk);
+                bool forward = dk > 0 || (dk == 0 && (dj > 0 || (dj == 0 && di > 0)));
+                if (!forward || (d == 1 && dk != 0)) {
+                    continue;
+                }
+                if ((conn == 4 || conn == 6) && dist > 1) {
+                    continue;
+                }
+                if (conn == 18 && dist > 2) {
+                    continue;
+                }
+                offsets.push_back({ di, dj, dk });
+            }
+        }
+    }
+    const bool valid_conn = d == 1 ? (conn == 4 || conn == 8) : (conn == 6 || conn == 18 || conn == 26);
+    if (!valid_conn) {
+        throw std::invalid_argument("conn must be 4 or 8 for 2D and 6, 18 or 26 for 3D grids");
+    }
+
+    const uint64_t num_nodes = h * w * d;
+    Graph graph = generate_chunked(num_nodes, num_nodes, 1 << 14, seed, num_threads,
+        [&](size_t n, Rng& rng, Graph& part) {
+            const int64_t i = n % h;
+            const int64_t j = (n / h) % w;
+            const int64_t k = n / (h * w);
+            for (const auto& o : offsets) {
+                int64_t ni = i + o.di, nj = j + o.dj, nk = k + o.dk;
+                if (ni < 0 || ni >= h || nj < 0 || nj >= w || nk < 0 || nk >= d) {
+                    continue;
+                }
+                int32_t cap = static_cast<int32_t>(rng.uniform(1, max_cap));
+                part.neighbor_arcs.push_back({ n, static_cast<uint64_t>(ni + nj * h + nk * h * w), cap, cap });
+            }
+            if (rng.real() < term_density) {
+                int32_t cap = static_cast<int32_t>(rng.uniform(1, max_term_cap));
+                if (rng.next() & 1) {
+                    part.terminal_arcs.push_back({ n, cap, 0 });
+                } else {
+                    part.terminal_arcs.push_back({ n, 0, cap });
+                }
+            }
+        });
+
+    if (block_h > 0) {
+        check_positive(block_w, "block_w");
+        check_positive(block_d, "block_d");
+        auto intervals = grid_block_intervals(h, w, d, block_h, block_w, block_d);
+        std::vector<uint16_t> node_blocks;
+        node_blocks.reserve(num_nodes);
+        for (const auto& iv : intervals.first) {
+            node_blocks.insert(node_blocks.end(), iv.first, iv.second);
+        }
+        write_blocks(fname + ".blk", node_blocks, intervals.second + 1);
+    }
+    return graph;
+}
+
+/**
+ * Genrmf graph (Goldfarb and Grigoriadis): b frames of a x a grids. Arcs inside a frame connect grid neighbors in
+ * both directions with capacity c2 * a * a. Each node has an arc to the node of the next frame given by a random
+ * permutation, with a random capacity in [c1, c2]. Flow goes from the first node of the first frame to the last node
+ * of the last frame. Since the solvers take the source and sink as separate terminals, these two nodes get terminal
+ * arcs with a capacity which can never be saturated.
+ */
+Graph gen_genrmf(Options& opt, uint64_t seed, unsigned int num_threads)
+{
+    const int64_t a = opt.get_int("a", 32);
+    const int64_t b = opt.get_int("b", 32);
+    const int64_t c1 = opt.get_int("c1", 1);
+    const int64_t c2 = opt.get_int("c2", 100);
+    check_positive(a, "a");
+    check_positive(b, "b");
+    check_positive(c1, "c1");
+    if (c2 < c1) {
+        throw std::invalid_argument("c2 must not be smaller than c1");
+    }
+    const int32_t frame_cap = checked_cap(c2 * a * a);
+    const int32_t term_cap = checked_cap(4 * c2 * a * a + c2);
+
+    opt.check_all_used();
+
+    const uint64_t frame_size = a * a;
+    const uint64_t num_nodes = frame_size * b;
+    return generate_chunked(num_nodes, b, 1, seed, num_threads, [&](size_t f, Rng& rng, Graph& part) {
+        const uint64_t base = f * frame_size;
+        for (int64_t y = 0; y < a; ++y) {
+            for (int64_t x = 0; x < a; ++x) {
+                uint64_t n = base + y * a + x;
+                if (x + 1 < a) {
+                    part.neighbor_arcs.push_back({ n, n + 1, frame_cap, frame_cap });
+                }
+                if (y + 1 < a) {
+                    part.neighbor_arcs.push_back({ n, n + a, frame_cap, frame_cap });
+                }
+            }
+        }
+        if (f + 1 < static_cast<size_t>(b)) {
+            std::vector<uint64_t> perm(frame_size);
+            for (uint64_t i = 0; i < frame_size; ++i) {
+                perm[i] = i;
+            }
+            for (uint64_t i = frame_size - 1; i > 0; --i) {
+                std::swap(perm[i], perm[rng.next() % (i + 1)]);
+            }
+            for (uint64_t i = 0; i < frame_size; ++i) {
+                int32_t cap = static_cast<int32_t>(rng.uniform(c1, c2));
+                part.neighbor_arcs.push_back({ base + i, base + frame_size + perm[i], cap, 0 });
+            }
+        }
+        if (f == 0) {
+            part.terminal_arcs.push_back({ 0, term_cap, 0 });
+        }
+        if (f + 1 == static_cast<size_t>(b)) {
+            part.terminal_arcs.push_back({ num_nodes - 1, 0, term_cap });
+        }
+    });
+}
+
+/**
+ * Two chains of n nodes each in the style of the AK generator of Cherkassky and Goldberg. The max flow is 2n.
+ *
+ * The first chain gets n units from the source at its head and leaks one unit to the sink at every node, so
+ * augmenting path solvers find n paths of average length n / 2. The second chain gets 2n units at its head but can
+ * only pass n to the sink at its tail, so push-relabel has to raise the labels of the whole chain to return the
+ * surplus to the source, which takes Theta(n^2) relabel work without global relabelling or the gap heuristic.
+ */
+Graph gen_ak(Options& opt, uint64_t seed, unsigned int num_threads)
+{
+    const int64_t n = opt.get_int("n", 4096);
+    check_positive(n, "n");
+    const int32_t surplus_cap = checked_cap(2 * n);
+
+    opt.check_all_used();
+
+    const uint64_t num_nodes = 2 * n;
+    return generate_chunked(num_nodes, num_nodes, 1 << 14, seed, num_threads, [&](size_t v, Rng&, Graph& part) {
+        const int64_t i = v % n;
+        const bool first = static_cast<int64_t>(v) < n;
+        if (first) {
+            part.terminal_arcs.push_back({ v, i == 0 ? static_cast<int32_t>(n) : 0, 1 });
+            if (i + 1 < n) {
+                part.neighbor_arcs.push_back({ v, v + 1, static_cast<int32_t>(n - i - 1), 0 });
+            }
+        } else {
+            if (i == 0 || i + 1 == n) {
+                part.terminal_arcs.push_back({ v, i == 0 ? surplus_cap : 0, i + 1 == n ? static_cast<int32_t>(n) : 0 });
+            }
+            if (i + 1 < n) {
+                part.neighbor_arcs.push_back({ v, v + 1, surplus_cap, 0 });
+            }
+        }
+    });
+}
+
+/**
+ * Random level graph like the RLG family of the Washington generator: layers of width nodes, where each node has
+ * arcs to degree random nodes of the next layer with random capacities in [1, max_cap]. The source connects to all
+ * nodes of the first layer and all nodes of the last layer connect to the sink.
+ */
+Graph gen_layered(Options& opt, uint64_t seed, unsigned int num_threads)
+{
+    const int64_t layers = opt.get_int("layers", 64);
+    const int64_t width = opt.get_int("width", 1024);
+    const int64_t degree = opt.get_int("degree", 3);
+    const int64_t max_cap = opt.get_int("max_cap", 10000);
+    check_positive(layers, "layers");
+    check_positive(width, "width");
+    check_positive(degree, "degree");
+    check_positive(max_cap, "max_cap");
+    if (degree > width) {
+        throw std::invalid_argument("degree must not exceed width");
+    }
+    const int32_t term_cap = checked_cap(max_cap * degree);
+
+    opt.check_all_used();
+
+    const uint64_t num_nodes = layers * width;
+    return generate_chunked(num_nodes, num_nodes, 1 << 14, seed, num_threads,
+        [&, targets = std::vector<uint64_t>()](size_t v, Rng& rng, Graph& part) mutable {
+            const int64_t layer = v / width;
+            if (layer == 0 || layer + 1 == layers) {
+                part.terminal_arcs.push_back({ v, layer == 0 ? term_cap : 0, layer + 1 == layers ? term_cap : 0 });
+            }
+            if (layer + 1 < layers) {
+                pick_distinct(rng, width, degree, targets);
+                for (uint64_t t : targets) {
+                    int32_t cap = static_cast<int32_t>(rng.uniform(1, max_cap));
+                    part.neighbor_arcs.push_back({ v, (layer + 1) * width + t, cap, 0 });
+                }
+            }
+        });
+}
+
+/**
+ * Bipartite matching instance. Every left node has arcs to degree random right nodes. With the default max_cap of 1
+ * the max flow is the size of a maximum matching; larger values give random terminal capacities in [1, max_cap]
+ * and middle arcs of capacity max_cap, i.e. a transportation problem.
+ */
+Graph gen_bipartite(Options& opt, uint64_t seed, unsigned int num_threads)
+{
+    const int64_t left = opt.get_int("left", 1 << 16);
+    const int64_t right = opt.get_int("right", left);
+    const int64_t degree = opt.get_int("degree", 3);
+    const int64_t max_cap = opt.get_int("max_cap", 1);
+    check_positive(left, "left");
+    check_positive(right, "right");
+    check_positive(degree, "degree");
+    check_positive(max_cap, "max_cap");
+    if (degree > right) {
+        throw std::invalid_argument("degree must not exceed right");
+    }
+    const int32_t mid_cap = checked_cap(max_cap);
+
+    opt.check_all_used();
+
+    const uint64_t num_nodes = left + right;
+    return generate_chunked(num_nodes, num_nodes, 1 << 14, seed, num_threads,
+        [&, targets = std::vector<uint64_t>()](size_t v, Rng& rng, Graph& part) mutable {
+            int32_t term_cap = static_cast<int32_t>(rng.uniform(1, max_cap));
+            if (static_cast<int64_t>(v) < left) {
+                part.terminal_arcs.push_back({ v, term_cap, 0 });
+                pick_distinct(rng, right, degree, targets);
+                for (uint64_t t : targets) {
+                    part.neighbor_arcs.push_back({ v, left + t, mid_cap, 0 });
+                }
+            } else {
+                part.terminal_arcs.push_back({ v, 0, term_cap });
+            }
+        });
+}
+
+bool ends_with(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 3) {
+        std::cout << "usage: bench_gen <family> <fname> [<key>=<value>...]\n";
+        std::cout << "  Writes a DIMACS file if fname ends in .max and a chunked bbk file if it ends in .bbk.\n";
+        std::cout << "  families and their options:\n";
+        std::cout << "  * grid: h w d conn max_cap max_term_cap term_density block_h block_w block_d\n";
+        std::cout << "  * genrmf: a b c1 c2\n";
+        std::cout << "  * ak: n\n";
+        std::cout << "  * layered: layers width degree max_cap\n";
+        std::cout << "  * bipartite: left right degree max_cap\n";
+        std::cout << "  common options: seed threads\n";
+        return 0;
+    }
+    std::string family = argv[1];
+    std::string fname = argv[2];
+
+    try {
+        Options opt(argc, argv, 3);
+        const uint64_t seed = opt.get_int("seed", 1);
+        const unsigned int num_threads = static_cast<unsigned int>(opt.get_int("threads", 0));
+        const bool dimacs = ends_with(fname, ".max");
+        if (!dimacs && !ends_with(fname, ".bbk")) {
+            throw std::invalid_argument("File name must end in .max or .bbk");
+        }
+
+        std::cout << "generating " << family << "... ";
+        auto start = std::chrono::system_clock::now();
+        Graph graph;
+        if (family == "grid") {
+            graph = gen_grid(opt, seed, num_threads, fname);
+        } else if (family == "genrmf") {
+            graph = gen_genrmf(opt, seed, num_threads);
+        } else if (family == "ak") {
+            graph = gen_ak(opt, seed, num_threads);
+        } else if (family == "layered") {
+            graph = gen_layered(opt, seed, num_threads);
+        } else if (family == "bipartite") {
+            graph = gen_bipartite(opt, seed, num_threads);
+        } else {
+            throw std::invalid_argument("Invalid family: " + family);
+        }
+        std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+        std::cout << dur.count() << " seconds\n";
+        std::cout << "  nodes: " << graph.num_nodes << ", terminal arcs: " << graph.terminal_arcs.size();
+        std::cout << ", neighbor arcs: " << graph.neighbor_arcs.size() << '\n';
+
+        std::cout << "writing " << (dimacs ? "dimacs" : "chunked bbk") << " (" << fname << ")... ";
+        start = std::chrono::system_clock::now();
+        if (dimacs) {
+            write_bk_to_dimacs(fname, graph, num_threads);
+        } else {
+            write_bk_to_chunked_bbk(fname, graph, BBK_CHUNK_BYTES, num_threads);
+        }
+        dur = std::chrono::system_clock::now() - start;
+        std::cout << dur.count() << " seconds\n";
+    } catch (const std::exception& e) {
+        std::cout << "\nERROR: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
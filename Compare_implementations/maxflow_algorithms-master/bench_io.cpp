@@ -2,6 +2,7 @@
 #include <chrono>
 #include <string>
 #include <fstream>
+#include <algorithm>
 
 #include "graph_io.h"
 
@@ -274,6 +275,61 @@ void bbk_to_compressed_bbk(const std::string fname)
     check_graphs_equal(bkg, bkg_compressed);
 }
 
+void bbk_to_chunked_bbk(const std::string fname)
+{
+    std::string bfname = fname + ".bbk";
+    std::string cfname = fname + ".bbkz";
+
+    std::cout << "reading bbk... ";
+    auto start = std::chrono::system_clock::now();
+    auto bkg = read_bbk_to_bk<int, int>(bfname);
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    std::cout << dur.count() << " seconds\n";
+
+    std::cout << "writing chunked bbk... ";
+    start = std::chrono::system_clock::now();
+    write_bk_to_chunked_bbk<int, int>(cfname, bkg);
+    dur = std::chrono::system_clock::now() - start;
+    std::cout << dur.count() << " seconds\n";
+
+    std::cout << "reading chunked bbk... ";
+    start = std::chrono::system_clock::now();
+    auto bkg_chunked = read_bbk_to_bk<int, int>(cfname);
+    dur = std::chrono::system_clock::now() - start;
+    std::cout << dur.count() << " seconds\n";
+
+    check_graphs_equal(bkg, bkg_chunked);
+}
+
+void bbk_to_packed_bbk(const std::string fname)
+{
+    std::string bfname = fname + ".bbk";
+    std::string pfname = fname + ".bbkp";
+
+    std::cout << "reading bbk... ";
+    auto start = std::chrono::system_clock::now();
+    auto bkg = read_bbk_to_bk<int, int>(bfname);
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    std::cout << dur.count() << " seconds\n";
+
+    std::cout << "writing packed bbk... ";
+    start = std::chrono::system_clock::now();
+    write_bk_to_packed_bbk<int, int>(pfname, bkg);
+    dur = std::chrono::system_clock::now() - start;
+    std::cout << dur.count() << " seconds\n";
+
+    std::cout << "reading packed bbk... ";
+    start = std::chrono::system_clock::now();
+    auto bkg_packed = read_bbk_to_bk<int, int>(pfname);
+    dur = std::chrono::system_clock::now() - start;
+    std::cout << dur.count() << " seconds\n";
+
+    // Packed files store neighbor arcs sorted by i
+    std::stable_sort(bkg.neighbor_arcs.begin(), bkg.neighbor_arcs.end(),
+        [](const auto& a, const auto& b) { return a.i < b.i; });
+    check_graphs_equal(bkg, bkg_packed);
+}
+
 void bq_to_compressed_bq(const std::string& fname)
 {
     std::string bfname = fname + ".bq";
@@ -339,6 +395,8 @@ int main(int argc, const char *argv[])
         std::cout << "  * bq_to_dimacs\n";      
         std::cout << "  * blk_to_txt\n";
         std::cout << "  * bbk_to_compressed_bbk\n";
+        std::cout << "  * bbk_to_chunked_bbk\n";
+        std::cout << "  * bbk_to_packed_bbk\n";
         std::cout << "  * bq_to_compressed_bq\n";
         std::cout << "  * bq_to_bbk\n";
         return 0;
@@ -358,6 +416,10 @@ int main(int argc, const char *argv[])
             blk_to_txt(fname);
         } else if (cmd == "bbk_to_compressed_bbk") {
             bbk_to_compressed_bbk(fname);
+        } else if (cmd == "bbk_to_chunked_bbk") {
+            bbk_to_chunked_bbk(fname);
+        } else if (cmd == "bbk_to_packed_bbk") {
+            bbk_to_packed_bbk(fname);
         } else if (cmd == "bq_to_compressed_bq") {
             bq_to_compressed_bq(fname);
         } else if (cmd == "bq_to_bbk") {
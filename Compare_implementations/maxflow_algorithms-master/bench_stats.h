@@ -0,0 +1,128 @@
+#ifndef BENCH_STATS_H__
+#define BENCH_STATS_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/** Summary of repeated timing measurements. All values are in the unit of the samples. */
+struct SampleStats {
+    size_t count = 0;
+    double mean = 0;
+    double stddev = 0;
+    double min = 0;
+    double max = 0;
+    double median = 0;
+    // Median absolute deviation from the median, unscaled
+    double mad = 0;
+    double p5 = 0;
+    double p25 = 0;
+    double p75 = 0;
+    double p95 = 0;
+    // Half width of the confidence interval of the mean, or infinity for less than two samples
+    double ci_half_width = 0;
+
+    /** CI half width relative to the mean. Used as the stopping criterion for adaptive repetition. */
+    double rel_ci() const
+    {
+        return mean > 0 ? ci_half_width / mean : (ci_half_width == 0 ? 0 : INFINITY);
+    }
+};
+
+/** Percentile p in [0, 1] of sorted samples, linearly interpolated between closest ranks. */
+inline double sorted_percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        throw std::invalid_argument("Percentile of empty sample.");
+    }
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(pos));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+}
+
+/** Quantile of the standard normal distribution, found by bisection on erfc. */
+inline double normal_quantile(double p)
+{
+    double lo = -40, hi = 40;
+    for (int i = 0; i < 200; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (0.5 * std::erfc(-mid / std::sqrt(2.0)) < p) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+/**
+ * Quantile of Student's t distribution with dof degrees of freedom. Exact for one and two degrees of freedom,
+ * otherwise the Cornish-Fisher expansion around the normal quantile, which is within 1% for three or more.
+ */
+inline double student_t_quantile(double p, size_t dof)
+{
+    const double pi = 3.14159265358979323846;
+    if (dof == 1) {
+        return std::tan(pi * (p - 0.5));
+    }
+    if (dof == 2) {
+        return (2 * p - 1) / std::sqrt(2 * p * (1 - p));
+    }
+    double z = normal_quantile(p);
+    double z2 = z * z;
+    double v = static_cast<double>(dof);
+    return z
+        + z * (z2 + 1) / (4 * v)
+        + z * ((5 * z2 + 16) * z2 + 3) / (96 * v * v)
+        + z * (((3 * z2 + 19) * z2 + 17) * z2 - 15) / (384 * v * v * v)
+        + z * ((((79 * z2 + 776) * z2 + 1482) * z2 - 1920) * z2 - 945) / (92160 * v * v * v * v);
+}
+
+/** Compute SampleStats for the samples. confidence is the two-sided level of the CI, e.g. 0.95. */
+inline SampleStats compute_stats(std::vector<double> samples, double confidence)
+{
+    SampleStats stats;
+    stats.count = samples.size();
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = sorted_percentile(samples, 0.5);
+    stats.p5 = sorted_percentile(samples, 0.05);
+    stats.p25 = sorted_percentile(samples, 0.25);
+    stats.p75 = sorted_percentile(samples, 0.75);
+    stats.p95 = sorted_percentile(samples, 0.95);
+
+    double sum = 0;
+    for (double s : samples) {
+        sum += s;
+    }
+    stats.mean = sum / samples.size();
+
+    std::vector<double> deviations;
+    deviations.reserve(samples.size());
+    double sq_sum = 0;
+    for (double s : samples) {
+        deviations.push_back(std::abs(s - stats.median));
+        sq_sum += (s - stats.mean) * (s - stats.mean);
+    }
+    std::sort(deviations.begin(), deviations.end());
+    stats.mad = sorted_percentile(deviations, 0.5);
+
+    if (samples.size() < 2) {
+        stats.ci_half_width = INFINITY;
+    } else {
+        stats.stddev = std::sqrt(sq_sum / (samples.size() - 1));
+        double t = student_t_quantile(0.5 + 0.5 * confidence, samples.size() - 1);
+        stats.ci_half_width = t * stats.stddev / std::sqrt(static_cast<double>(samples.size()));
+    }
+    return stats;
+}
+
+#endif // BENCH_STATS_H__
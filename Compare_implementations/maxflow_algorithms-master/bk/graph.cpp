@@ -12,8 +12,8 @@
 #define TERMINAL ( (arc *) 1 )		/* to terminal */
 #define ORPHAN   ( (arc *) 2 )		/* orphan */
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	Graph<captype, tcaptype, flowtype>::Graph(size_t node_num_max, size_t edge_num_max, void (*err_function)(const char *))
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	Graph<captype,tcaptype,flowtype,count_ops>::Graph(size_t node_num_max, size_t edge_num_max, void (*err_function)(const char *))
 	: node_num(0),
 	  nodeptr_block(NULL),
 	  error_function(err_function)
@@ -34,8 +34,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	flow = 0;
 }
 
-template <typename captype, typename tcaptype, typename flowtype>
-Graph<captype, tcaptype, flowtype>::Graph(Graph&& other) noexcept :
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops>
+Graph<captype,tcaptype,flowtype,count_ops>::Graph(Graph&& other) noexcept :
 	nodes(other.nodes),
 	node_last(other.node_last),
 	node_max(other.node_max),
@@ -51,7 +51,8 @@ Graph<captype, tcaptype, flowtype>::Graph(Graph&& other) noexcept :
 	queue_last{ other.queue_last[0], other.queue_last[1] },
 	orphan_first(other.orphan_first),
 	orphan_last(other.orphan_last),
-	TIME(other.TIME)
+	TIME(other.TIME),
+	op_counter(other.op_counter)
 {
 	other.nodes = nullptr;
 	other.node_last = nullptr;
@@ -73,8 +74,8 @@ Graph<captype, tcaptype, flowtype>::Graph(Graph&& other) noexcept :
 	other.TIME = 0;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	Graph<captype,tcaptype,flowtype>::~Graph()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	Graph<captype,tcaptype,flowtype,count_ops>::~Graph()
 {
 	if (nodeptr_block) 
 	{ 
@@ -85,8 +86,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	free(arcs);
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::reset()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::reset()
 {
 	node_last = nodes;
 	arc_last = arcs;
@@ -102,8 +103,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	flow = 0;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::reallocate_nodes(int num)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::reallocate_nodes(int num)
 {
 	int node_num_max = (int)(node_max - nodes);
 	node* nodes_old = nodes;
@@ -131,8 +132,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	}
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::reallocate_arcs()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::reallocate_arcs()
 {
 	int arc_num_max = (int)(arc_max - arcs);
 	int arc_num = (int)(arc_last - arcs);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <stdexcept>
@@ -7,6 +8,7 @@
 #include <vector>
 
 #include "graph_io.h"
+#include "maxflow_solver.h"
 
 #ifdef GRIDCUT_IS_AVAILABLE
 #include "grid_cut/GridGraph_3D_6C.h"
@@ -45,8 +47,8 @@ coord id2coord(int i, int width, int height)
     );
 };
 
-template <class capty, class tcapty>
-void bench_bk(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_bk(const Graph<capty, tcapty>& bkg)
 {
     std::cout << "building... ";
     auto build_begin = now();
@@ -70,8 +72,8 @@ void bench_bk(const BkGraph<capty, tcapty>& bkg)
     std::cout << "total: " << (build_dur + solve_dur).count() << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_mbk(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_mbk(const Graph<capty, tcapty>& bkg)
 {
     std::cout << "building... ";
     auto build_begin = now();
@@ -95,8 +97,8 @@ void bench_mbk(const BkGraph<capty, tcapty>& bkg)
     std::cout << "total: " << (build_dur + solve_dur).count() << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_mbk2(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_mbk2(const Graph<capty, tcapty>& bkg)
 {
     std::cout << "building... ";
     auto build_begin = now();
@@ -126,8 +128,8 @@ void bench_mbk2(const BkGraph<capty, tcapty>& bkg)
     std::cout << "total: " << (build_dur + init_dur + solve_dur).count() << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_pmbk(const BkGraph<capty, tcapty>& bkg, const std::string& fname)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_pmbk(const Graph<capty, tcapty>& bkg, const std::string& fname)
 {
     uint16_t num_blocks;
     std::vector<uint16_t> node_blocks;
@@ -181,8 +183,8 @@ void bench_pmbk(const BkGraph<capty, tcapty>& bkg, const std::string& fname)
     std::cout << "total: " << (build_dur + solve_dur).count() << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_ibfs(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_ibfs(const Graph<capty, tcapty>& bkg)
 {
     using Ibfs = reimpls::IBFSGraph<int, int, int, uint32_t, uint64_t>;
     std::cout << "building...";
@@ -213,8 +215,8 @@ void bench_ibfs(const BkGraph<capty, tcapty>& bkg)
     std::cout << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_ibfs2(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_ibfs2(const Graph<capty, tcapty>& bkg)
 {
     using Ibfs = reimpls::IBFSGraph2<int, int, int>;
     std::cout << "building...";
@@ -245,8 +247,8 @@ void bench_ibfs2(const BkGraph<capty, tcapty>& bkg)
     std::cout << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_ibfs_old(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_ibfs_old(const Graph<capty, tcapty>& bkg)
 {
     using Ibfs = ibfs::IBFSGraph<int, int, int>;
     std::cout << "building...";
@@ -278,8 +280,8 @@ void bench_ibfs_old(const BkGraph<capty, tcapty>& bkg)
     std::cout << " seconds, maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_pibfs(const BkGraph<capty, tcapty>& bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_pibfs(const Graph<capty, tcapty>& bkg)
 {
     using Ibfs = reimpls::ParallelIbfs<int, int, int>;
     std::cout << "building...";
@@ -367,8 +369,8 @@ void bench_pibfs(const BkGraph<capty, tcapty>& bkg)
     std::cout << " seconds, flow: " << graph.get_flow() << "\n";
 }*/
 
-template <class capty>
-void bench_hpf(const BkGraph<capty, capty> bkg)
+template <template <class, class> class Graph, class capty>
+void bench_hpf(const Graph<capty, capty>& bkg)
 {
     auto init_begin = now();
     reimpls::Hpf<int, reimpls::LabelOrder::LOWEST_FIRST, reimpls::RootOrder::FIFO> graph(
@@ -404,7 +406,8 @@ void bench_hpf(const BkGraph<capty, capty> bkg)
     std::cout << " seconds, flow: " << graph.compute_maxflow() << "\n";
 }
 
-void bench_hi_pr(const BkGraph<int, int> bkg)
+template <class Graph>
+void bench_hi_pr(const Graph& bkg)
 {
     std::cout << "init...\n";
     hi_pr::HiPr graph;
@@ -412,6 +415,8 @@ void bench_hi_pr(const BkGraph<int, int> bkg)
     std::vector<int> endpoints; // [from, to, from, to, ...]
     std::vector<int> capacities; // [cap, rev_cap, cap, rev_cap, ...]
     std::vector<int> excesses; // source_cap - sink_cap for all nodes
+    std::vector<int> source_caps(bkg.num_nodes, 0);
+    std::vector<int> sink_caps(bkg.num_nodes, 0);
     endpoints.reserve(2 * bkg.neighbor_arcs.size());
     capacities.reserve(2 * bkg.neighbor_arcs.size());
     excesses.resize(bkg.num_nodes, 0);
@@ -423,7 +428,14 @@ void bench_hi_pr(const BkGraph<int, int> bkg)
         capacities.push_back(narc.rev_cap);
     }
     for (const auto& tarc : bkg.terminal_arcs) {
-        excesses[tarc.node] = tarc.source_cap - tarc.sink_cap;
+        source_caps[tarc.node] += tarc.source_cap;
+        sink_caps[tarc.node] += tarc.sink_cap;
+    }
+    // HI_PR only sees the net excess, so flow going straight from source to sink through a node is added back
+    int64_t terminal_flow = 0;
+    for (size_t i = 0; i < bkg.num_nodes; ++i) {
+        excesses[i] = source_caps[i] - sink_caps[i];
+        terminal_flow += std::min(source_caps[i], sink_caps[i]);
     }
 
     std::cout << "building... ";
@@ -440,7 +452,7 @@ void bench_hi_pr(const BkGraph<int, int> bkg)
     std::cout << solve_dur.count() << " seconds\n";
 
     std::cout << "total: " << (build_dur + solve_dur).count() << " seconds, ";
-    std::cout << "maxflow: " << graph.flow - graph.flow0 << "\n";
+    std::cout << "maxflow: " << terminal_flow + graph.flow - graph.flow0 << "\n";
 }
 
 /*void bench_sk_old(const BkGraph<int, int> bkg)
@@ -488,8 +500,8 @@ void bench_hi_pr(const BkGraph<int, int> bkg)
     std::cout << "maxflow: " << graph.flow / 2 << ", iters: " << graph.iter << std::endl;
 }*/
 
-template <class capty, class tcapty>
-void bench_sk(const BkGraph<capty, tcapty> bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_sk(const Graph<capty, tcapty>& bkg)
 {
     const int num_threads = 2;// std::thread::hardware_concurrency();
     std::vector<std::pair<size_t, uint16_t>> block_intervals;
@@ -541,8 +553,8 @@ void bench_sk(const BkGraph<capty, tcapty> bkg)
 }
 
 #ifdef GRIDCUT_IS_AVAILABLE
-template <class capty, class tcapty>
-void bench_gridcut(const BkGraph<capty, tcapty> bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_gridcut(const Graph<capty, tcapty>& bkg)
 {
     // bone.n6c10
     //const int width = 256, height = 256, depth = 119;
@@ -610,8 +622,8 @@ void bench_gridcut(const BkGraph<capty, tcapty> bkg)
     std::cout << "maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_gridcut_fastbuild(const BkGraph<capty, tcapty> bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_gridcut_fastbuild(const Graph<capty, tcapty>& bkg)
 {
     // bone.n6c10
     //const int width = 256, height = 256, depth = 119;
@@ -704,8 +716,8 @@ void bench_gridcut_fastbuild(const BkGraph<capty, tcapty> bkg)
     std::cout << "maxflow: " << flow << std::endl;
 }
 
-template <class capty, class tcapty>
-void bench_gridcut_mt(const BkGraph<capty, tcapty> bkg)
+template <template <class, class> class Graph, class capty, class tcapty>
+void bench_gridcut_mt(const Graph<capty, tcapty>& bkg)
 {
     // bone.n6c10
     //const int width = 256, height = 256, depth = 119;
@@ -802,6 +814,30 @@ void bench_gridcut_mt(const BkGraph<capty, tcapty> bkg)
 }
 #endif
 
+/** Run any solver from the SolverRegistry, e.g. those without a dedicated bench_* function above. */
+template <class Graph>
+void bench_registered(const Graph& bkg, const std::string& algo)
+{
+    auto solver = SolverRegistry<int, int, int64_t>::instance().create(algo);
+
+    std::cout << "building... ";
+    solver->build(bkg);
+    std::cout << solver->timings().build_time << " seconds" << std::endl;
+
+    std::cout << "solving... ";
+    auto flow = solver->solve();
+    std::cout << solver->timings().solve_time << " seconds" << std::endl;
+
+    std::cout << "extracting cut... ";
+    std::vector<uint8_t> cut;
+    solver->get_cut(cut);
+    std::cout << solver->timings().extract_time << " seconds, ";
+    std::cout << std::count(cut.begin(), cut.end(), 1) << " source side nodes" << std::endl;
+
+    std::cout << "total: " << solver->timings().build_time + solver->timings().solve_time;
+    std::cout << " seconds, maxflow: " << flow << std::endl;
+}
+
 template <class capty, class tcapty>
 BkGraph<capty, tcapty> read_graph(const std::string& fname)
 {
@@ -812,6 +848,14 @@ BkGraph<capty, tcapty> read_graph(const std::string& fname)
         return qpbo_to_graph(read_bq_to_qpbo<capty>(fname));
     };
 
+    // DIMACS files are text so the binary readers would reject them anyway
+    auto ends_with = [&](const std::string& ext) {
+        return fname.size() >= ext.size() && fname.compare(fname.size() - ext.size(), ext.size(), ext) == 0;
+    };
+    if (ends_with(".max") || ends_with(".inp") || ends_with(".dimacs")) {
+        return read_dimacs_to_bk<capty, tcapty>(fname);
+    }
+
     bool likely_bbk = (fname.back() != 'q'); // QPBO files usually end in .bq
 
     try {
@@ -822,6 +866,76 @@ BkGraph<capty, tcapty> read_graph(const std::string& fname)
     }
 }
 
+template <class Graph>
+void run_algos(const Graph& bkg, const std::string& fname, const std::vector<std::string>& algos)
+{
+    for (const auto& algo : algos) {
+        if (algo == "bk") {
+            std::cerr << "BK:" << std::endl;
+            bench_bk(bkg);
+        } else if (algo == "mbk") {
+            std::cerr << "MBK:" << std::endl;
+            bench_mbk(bkg);
+        } else if (algo == "mbk_r") {
+            std::cerr << "MBK2:" << std::endl;
+            bench_mbk2(bkg);
+        } else if (algo == "liusun") {
+            std::cerr << "Parallel MBK:" << std::endl;
+            bench_pmbk(bkg, fname);
+        } else if (algo == "eibfs") {
+            std::cerr << "EIBFS old:" << std::endl;
+            bench_ibfs_old(bkg);
+        } else if (algo =="eibfs_i") {
+            std::cerr << "EIBFS new:" << std::endl;
+            bench_ibfs(bkg);
+        } else if (algo =="eibfs_i_nr") {
+            std::cerr << "EIBFS new2:" << std::endl;
+            bench_ibfs2(bkg);
+        } else if (algo =="peibfs") {
+            std::cerr << "Parallel EIBFS:" << std::endl;
+            bench_pibfs(bkg);
+        } /*else if (algo =="ppr") {
+            std::cerr << "Parallel PR:" << std::endl;
+            bench_ppr(bkg);
+        } */else if (algo =="hpf") {
+            std::cerr << "HPF:" << std::endl;
+            bench_hpf(bkg);
+        } else if (algo =="hi_pr") {
+            std::cerr << "HI_PR:" << std::endl;
+            bench_hi_pr(bkg);
+        } /*else if (algo =="sk_old") {
+            std::cerr << "Strandmark-Kahl old:" << std::endl;
+            bench_sk_old(bkg);
+        }*/ else if (algo =="psk") {
+            std::cerr << "Strandmark-Kahl new:" << std::endl;
+            bench_sk(bkg);
+        }
+#ifdef GRIDCUT_IS_AVAILABLE
+        else if (algo == "gridcut") {
+            std::cerr << "GridCut:" << std::endl;
+            bench_gridcut(bkg);
+        } else if (algo == "gridcut_fastbuild") {
+            std::cerr << "GridCut (fastbuild):" << std::endl;
+            bench_gridcut_fastbuild(bkg);
+        } else if (algo == "gridcut_mt") {
+            std::cerr << "Parallel GridCut:" << std::endl;
+            bench_gridcut_mt(bkg);
+        }
+#endif
+        else if (algo == "auto") {
+            // demo only runs serial solvers, so the selection is made for a single thread
+            const SolverRule& rule = select_solver_rule<int, int, int64_t>(compute_graph_features(bkg));
+            std::cerr << "auto -> " << rule.solver << " (" << rule.reason << "):" << std::endl;
+            bench_registered(bkg, rule.solver);
+        } else if (SolverRegistry<int, int, int64_t>::instance().contains(algo)) {
+            std::cerr << algo << " (registry):" << std::endl;
+            bench_registered(bkg, algo);
+        } else {
+            std::cerr << "Unknown algorithm: " << algo << std::endl;
+        }
+    }
+}
+
 int main(int argc, const char* argv[])
 {
     std::string fname;
@@ -830,6 +944,7 @@ int main(int argc, const char* argv[])
         std::cout << "Usage: demo <file> [<algo>...]\n";
         std::cout << "  Benchmark FILE with ALGOs. ALGO must be one of:\n";
         std::cout << "    bk mbk pmbk eilbfs_old eibfs eibfs2 peibfs ppr hpf hi_pr sk\n";
+        std::cout << "  or any solver in the SolverRegistry (e.g. nbk hpf_ll), or auto to pick one from the graph.\n";
         return -1;
     } else {
         fname = argv[1];
@@ -837,65 +952,12 @@ int main(int argc, const char* argv[])
     std::cout << "reading " << fname << "..." << std::endl;
 
     try {
-        auto bkg = read_graph<int, int>(fname);
-
-        for (int i = 0; i < argc - 2; ++i) {
-            std::string algo = argv[i + 2];
-            if (algo == "bk") {
-                std::cerr << "BK:" << std::endl;
-                bench_bk(bkg);
-            } else if (algo == "mbk") {
-                std::cerr << "MBK:" << std::endl;
-                bench_mbk(bkg);
-            } else if (algo == "mbk_r") {
-                std::cerr << "MBK2:" << std::endl;
-                bench_mbk2(bkg);
-            } else if (algo == "liusun") {
-                std::cerr << "Parallel MBK:" << std::endl;
-                bench_pmbk(bkg, fname);
-            } else if (algo == "eibfs") {
-                std::cerr << "EIBFS old:" << std::endl;
-                bench_ibfs_old(bkg);
-            } else if (algo =="eibfs_i") {
-                std::cerr << "EIBFS new:" << std::endl;
-                bench_ibfs(bkg);
-            } else if (algo =="eibfs_i_nr") {
-                std::cerr << "EIBFS new2:" << std::endl;
-                bench_ibfs2(bkg);
-            } else if (algo =="peibfs") {
-                std::cerr << "Parallel EIBFS:" << std::endl;
-                bench_pibfs(bkg);
-            } /*else if (algo =="ppr") {
-                std::cerr << "Parallel PR:" << std::endl;
-                bench_ppr(bkg);
-            } */else if (algo =="hpf") {
-                std::cerr << "HPF:" << std::endl;
-                bench_hpf(bkg);
-            } else if (algo =="hi_pr") {
-                std::cerr << "HI_PR:" << std::endl;
-                bench_hi_pr(bkg);
-            } /*else if (algo =="sk_old") {
-                std::cerr << "Strandmark-Kahl old:" << std::endl;
-                bench_sk_old(bkg);
-            }*/ else if (algo =="psk") {
-                std::cerr << "Strandmark-Kahl new:" << std::endl;
-                bench_sk(bkg);
-            }
-#ifdef GRIDCUT_IS_AVAILABLE
-            else if (algo == "gridcut") {
-                std::cerr << "GridCut:" << std::endl;
-                bench_gridcut(bkg);
-            } else if (algo == "gridcut_fastbuild") {
-                std::cerr << "GridCut (fastbuild):" << std::endl;
-                bench_gridcut_fastbuild(bkg);
-            } else if (algo == "gridcut_mt") {
-                std::cerr << "Parallel GridCut:" << std::endl;
-                bench_gridcut_mt(bkg);
-            }
-#endif
-            else {
-                std::cerr << "Unknown algorithm: " << algo << std::endl;
-            }
+        std::vector<std::string> algos(argv + 2, argv + argc);
+        if (is_uncompressed_bbk(fname)) {
+            // Build solvers directly from the mapped file instead of copying it into a BkGraph first
+            run_algos(map_bbk_to_view<int, int>(fname), fname, algos);
+        } else {
+            run_algos(read_graph<int, int>(fname), fname, algos);
         }
     } catch (const std::exception& e) {
         std::cout << "ERROR: " << e.what() << "\n";
@@ -0,0 +1,500 @@
+#ifndef DIMACS_READER_H__
+#define DIMACS_READER_H__
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <utility>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <exception>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Memory mapped, parallel DIMACS reader. This header only depends on the standard library and POSIX, so the programs
+ * outside of this project (maxflow-master, Dinitz_Compare and the ChatGPT implementations) include it directly
+ * instead of linking graph_io.cpp. graph_io.h builds the BK graph readers on top of it.
+ */
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Memory mapped files and threading helpers
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Access pattern hints for MappedFile. Ignored on platforms without mmap. */
+enum MapHint : uint8_t {
+    MAP_HINT_NONE,
+    MAP_HINT_SEQUENTIAL, // madvise(MADV_SEQUENTIAL)
+    MAP_HINT_RANDOM, // madvise(MADV_RANDOM)
+    MAP_HINT_WILLNEED, // madvise(MADV_WILLNEED), i.e. start asynchronous read ahead of the whole file
+    MAP_HINT_POPULATE // MAP_POPULATE, i.e. fault in all pages before the constructor returns
+};
+
+/**
+ * Read-only memory mapping of a whole file. The mapping is released when the object is destroyed.
+ * On platforms without mmap the file is read into a private buffer instead.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& fname, MapHint hint = MAP_HINT_SEQUENTIAL);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char *data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    void release() noexcept;
+
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<char> buffer_; // Only used if the file could not be mapped
+};
+
+inline MappedFile::MappedFile(const std::string& fname, MapHint hint)
+{
+#ifndef _WIN32
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (hint == MAP_HINT_POPULATE) {
+                flags |= MAP_POPULATE;
+            }
+#endif
+            void *addr = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+            if (addr != MAP_FAILED) {
+                switch (hint) {
+                case MAP_HINT_SEQUENTIAL: madvise(addr, size_, MADV_SEQUENTIAL); break;
+                case MAP_HINT_RANDOM: madvise(addr, size_, MADV_RANDOM); break;
+                case MAP_HINT_WILLNEED: madvise(addr, size_, MADV_WILLNEED); break;
+                default: break;
+                }
+                data_ = static_cast<const char *>(addr);
+            }
+        }
+    }
+    close(fd);
+    if (data_ != nullptr || size_ == 0) {
+        return;
+    }
+#endif
+    (void)hint; // Access hints only apply to mapped files
+    // Fall back to reading the whole file
+    std::fstream file(fname, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+    size_ = static_cast<size_t>(file.tellg());
+    buffer_.resize(size_);
+    file.seekg(0);
+    file.read(buffer_.data(), size_);
+    data_ = buffer_.data();
+}
+
+inline MappedFile::~MappedFile()
+{
+    release();
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), buffer_(std::move(other.buffer_))
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        buffer_ = std::move(other.buffer_);
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+inline void MappedFile::release() noexcept
+{
+#ifndef _WIN32
+    if (data_ != nullptr && buffer_.empty()) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+/** Number of threads to use when the caller passes 0. */
+inline unsigned int default_num_threads()
+{
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+/**
+ * Call func(i) for every i in [0, n) using up to num_threads threads. Indices are handed out dynamically
+ * so uneven work is balanced. The first exception thrown by func is rethrown in the calling thread.
+ */
+template <class Func>
+void parallel_for(size_t n, unsigned int num_threads, Func func)
+{
+    if (num_threads == 0) {
+        num_threads = default_num_threads();
+    }
+    num_threads = static_cast<unsigned int>(std::min<size_t>(num_threads, n));
+    if (num_threads <= 1) {
+        for (size_t i = 0; i < n; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error = nullptr;
+    std::atomic_flag error_set = ATOMIC_FLAG_INIT;
+    auto worker = [&]() {
+        try {
+            for (size_t i = next++; i < n; i = next++) {
+                func(i);
+            }
+        } catch (...) {
+            if (!error_set.test_and_set()) {
+                error = std::current_exception();
+            }
+            next = n; // Make other threads stop early
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (unsigned int t = 1; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : threads) {
+        th.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Split buffer into at most max_chunks pieces of roughly equal size which all end on a line boundary.
+ * Returns the begin offsets of each chunk followed by the buffer size.
+ */
+inline std::vector<size_t> split_at_lines(const char *data, size_t size, size_t max_chunks, size_t min_chunk_size)
+{
+    size_t num_chunks = std::max<size_t>(1, std::min(max_chunks, size / std::max<size_t>(min_chunk_size, 1)));
+    std::vector<size_t> bounds = { 0 };
+    for (size_t i = 1; i < num_chunks; ++i) {
+        size_t pos = std::max(bounds.back(), i * (size / num_chunks));
+        const char *nl = static_cast<const char *>(std::memchr(data + pos, '\n', size - pos));
+        if (nl == nullptr) {
+            break;
+        }
+        pos = nl - data + 1;
+        if (pos > bounds.back() && pos < size) {
+            bounds.push_back(pos);
+        }
+    }
+    bounds.push_back(size);
+    return bounds;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// DIMACS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Arc read from a DIMACS file. Node indices are kept as in the file, i.e. one-based. */
+template <class captype>
+struct DimacsArc {
+    uint64_t from;
+    uint64_t to;
+    captype cap;
+};
+
+/**
+ * Plain edge list read from a DIMACS file. Arcs are stored in file order.
+ * Source and sink are one-based like the arcs, or 0 if the file has no node descriptor for them.
+ */
+template <class captype>
+struct DimacsGraph {
+    uint64_t num_nodes = 0;
+    uint64_t num_arcs = 0;
+    uint64_t source = 0;
+    uint64_t sink = 0;
+
+    std::vector<DimacsArc<captype>> arcs;
+};
+
+/**
+ * Read DIMACS file into a plain edge list, for front-ends which build their own graph representation.
+ * Implmented according to the spec. at: http://lpsolve.sourceforge.net/5.5/DIMACS_maxf.htm
+ *
+ * The file is memory mapped, split into chunks at line boundaries and parsed in parallel using num_threads threads
+ * (0 means one per core). Throws std::runtime_error if the file cannot be opened or a line cannot be parsed.
+ */
+template <class captype>
+DimacsGraph<captype> read_dimacs_arcs(const std::string& fname, unsigned int num_threads = 0);
+
+namespace dimacs_detail {
+
+/** Throw an error quoting the malformed line starting at pos. */
+[[noreturn]] inline void throw_parse_error(const char *pos, const char *end)
+{
+    const char *nl = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+    std::string line(pos, nl ? nl : end);
+    throw std::runtime_error("Could not parse DIMACS line: " + line);
+}
+
+inline const char *skip_blanks(const char *pos, const char *end) noexcept
+{
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+        ++pos;
+    }
+    return pos;
+}
+
+inline const char *skip_line(const char *pos, const char *end) noexcept
+{
+    const char *nl = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+    return nl ? nl + 1 : end;
+}
+
+/** Scan unsigned decimal integer. Leading blanks are skipped. Returns nullptr if no number was found. */
+inline const char *scan_uint(const char *pos, const char *end, uint64_t& out) noexcept
+{
+    pos = skip_blanks(pos, end);
+    if (pos == end || *pos < '0' || *pos > '9') {
+        return nullptr;
+    }
+    uint64_t val = 0;
+    do {
+        val = 10 * val + (*pos - '0');
+        ++pos;
+    } while (pos < end && *pos >= '0' && *pos <= '9');
+    out = val;
+    return pos;
+}
+
+/**
+ * Scan capacity. Integer types are scanned by hand, floating point types are handed to strtod.
+ * Returns nullptr if no number was found.
+ */
+template <class captype>
+inline const char *scan_cap(const char *pos, const char *end, captype& out) noexcept
+{
+    pos = skip_blanks(pos, end);
+    if (std::is_floating_point<captype>::value) {
+        // strtod needs a terminated string which the mapped file does not give us
+        char buf[64];
+        size_t len = 0;
+        while (pos + len < end && len < sizeof(buf) - 1 && !std::isspace(static_cast<unsigned char>(pos[len]))) {
+            buf[len] = pos[len];
+            ++len;
+        }
+        buf[len] = '\0';
+        char *parsed_end;
+        double val = std::strtod(buf, &parsed_end);
+        if (parsed_end == buf) {
+            return nullptr;
+        }
+        out = static_cast<captype>(val);
+        return pos + (parsed_end - buf);
+    } else {
+        bool negative = pos < end && *pos == '-';
+        uint64_t val;
+        pos = scan_uint(pos + negative, end, val);
+        if (pos == nullptr) {
+            return nullptr;
+        }
+        out = static_cast<captype>(negative ? -static_cast<int64_t>(val) : static_cast<int64_t>(val));
+        return pos;
+    }
+}
+
+/** Problem and node descriptors found in part of a DIMACS file. */
+struct ChunkInfo {
+    uint64_t num_nodes = 0;
+    uint64_t num_arcs = 0;
+    uint64_t source = 0;
+    uint64_t sink = 0;
+    bool has_problem = false;
+};
+
+template <class captype>
+struct Chunk : ChunkInfo {
+    std::vector<DimacsArc<captype>> arcs;
+};
+
+/** Parse lines in [pos, end). Descriptors are stored in info and on_arc(const DimacsArc&) is called for every arc. */
+template <class captype, class ArcFunc>
+void scan_chunk(const char *pos, const char *end, ChunkInfo& info, ArcFunc on_arc)
+{
+    while (pos < end) {
+        const char *line = pos;
+        pos = skip_blanks(pos, end);
+        if (pos == end) {
+            break;
+        }
+        switch (*pos) {
+        case 'a': {
+            DimacsArc<captype> arc;
+            pos = scan_uint(pos + 1, end, arc.from);
+            pos = pos ? scan_uint(pos, end, arc.to) : nullptr;
+            pos = pos ? scan_cap(pos, end, arc.cap) : nullptr;
+            if (pos) {
+                on_arc(arc);
+            }
+            break;
+        }
+        case 'n': {
+            uint64_t id;
+            pos = scan_uint(pos + 1, end, id);
+            pos = pos ? skip_blanks(pos, end) : nullptr;
+            if (pos && pos < end && *pos == 's') {
+                info.source = id;
+            } else if (pos && pos < end && *pos == 't') {
+                info.sink = id;
+            } else {
+                pos = nullptr;
+            }
+            break;
+        }
+        case 'p':
+            pos = skip_blanks(pos + 1, end);
+            if (end - pos < 3 || std::strncmp(pos, "max", 3) != 0) {
+                pos = nullptr;
+                break;
+            }
+            pos = scan_uint(pos + 3, end, info.num_nodes);
+            pos = pos ? scan_uint(pos, end, info.num_arcs) : nullptr;
+            info.has_problem = true;
+            break;
+        case 'c':
+        case '\n':
+            break;
+        default:
+            pos = nullptr;
+        }
+        if (pos == nullptr) {
+            throw_parse_error(line, end);
+        }
+        pos = skip_line(pos, end);
+    }
+}
+
+template <class captype>
+void parse_chunk(const char *pos, const char *end, Chunk<captype>& chunk)
+{
+    // Arc lines are at least 8 bytes ("a 1 2 3\n") but typically around twice that
+    chunk.arcs.reserve((end - pos) / 16);
+    scan_chunk<captype>(pos, end, chunk, [&](const DimacsArc<captype>& arc) { chunk.arcs.push_back(arc); });
+}
+
+/**
+ * Map file and parse it in parallel. Problem and node descriptors are merged into the first chunk.
+ * Only the problem line is required, callers check for source and sink if they need them.
+ */
+template <class captype>
+std::vector<Chunk<captype>> parse_file(const std::string& fname, unsigned int num_threads)
+{
+    MappedFile file(fname);
+    if (num_threads == 0) {
+        num_threads = default_num_threads();
+    }
+
+    // Parsing small chunks is not worth the thread overhead
+    constexpr size_t min_chunk_size = 1 << 20;
+    std::vector<size_t> bounds = split_at_lines(file.data(), file.size(), num_threads, min_chunk_size);
+    std::vector<Chunk<captype>> chunks(bounds.size() - 1);
+    parallel_for(chunks.size(), num_threads, [&](size_t i) {
+        parse_chunk(file.data() + bounds[i], file.data() + bounds[i + 1], chunks[i]);
+    });
+
+    Chunk<captype>& head = chunks.front();
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        const Chunk<captype>& c = chunks[i];
+        if (c.has_problem) {
+            head.num_nodes = c.num_nodes;
+            head.num_arcs = c.num_arcs;
+            head.has_problem = true;
+        }
+        head.source = c.source ? c.source : head.source;
+        head.sink = c.sink ? c.sink : head.sink;
+    }
+    if (!head.has_problem) {
+        throw std::runtime_error("Missing problem line in DIMACS file: " + fname);
+    }
+    return chunks;
+}
+
+/** Exclusive prefix sum of counts. The total is appended at the end. */
+inline std::vector<size_t> prefix_offsets(const std::vector<size_t>& counts)
+{
+    std::vector<size_t> offsets(counts.size() + 1, 0);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        offsets[i + 1] = offsets[i] + counts[i];
+    }
+    return offsets;
+}
+
+} // namespace dimacs_detail
+
+template <class captype>
+DimacsGraph<captype> read_dimacs_arcs(const std::string& fname, unsigned int num_threads)
+{
+    auto chunks = dimacs_detail::parse_file<captype>(fname, num_threads);
+    std::vector<size_t> counts;
+    for (const auto& c : chunks) {
+        counts.push_back(c.arcs.size());
+    }
+    auto offsets = dimacs_detail::prefix_offsets(counts);
+
+    DimacsGraph<captype> g;
+    g.num_nodes = chunks.front().num_nodes;
+    g.num_arcs = chunks.front().num_arcs;
+    g.source = chunks.front().source;
+    g.sink = chunks.front().sink;
+    if (chunks.size() == 1) {
+        g.arcs = std::move(chunks.front().arcs);
+    } else {
+        g.arcs.resize(offsets.back());
+        parallel_for(chunks.size(), num_threads, [&](size_t i) {
+            std::copy(chunks[i].arcs.begin(), chunks[i].arcs.end(), g.arcs.begin() + offsets[i]);
+            chunks[i].arcs = std::vector<DimacsArc<captype>>(); // Free memory early
+        });
+    }
+    return g;
+}
+
+#endif // DIMACS_READER_H__
@@ -0,0 +1,249 @@
+#ifndef FLOW_VERIFY_H__
+#define FLOW_VERIFY_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "graph_io.h"
+
+/**
+ * What a solver leaves behind for verification after a solve. The cut is available from all solvers which extract
+ * one. Residual capacities are only given by solvers which keep their arcs in the order they were added: for the k-th
+ * neighbor arc of the input, residuals[2k] is the residual capacity of i->j and residuals[2k+1] that of j->i.
+ */
+struct SolveCertificate {
+    std::vector<uint8_t> cut;
+    std::vector<int64_t> residuals;
+
+    void clear()
+    {
+        cut.clear();
+        residuals.clear();
+    }
+};
+
+/** Outcome of verifying one solve. An empty error means all checks which could be made passed. */
+struct VerifyResult {
+    bool cut_checked = false;
+    bool flow_checked = false;
+    std::string error;
+
+    bool ok() const { return error.empty(); }
+
+    /** Short status for the result CSV: FAILED, or which checks were made. */
+    std::string status() const
+    {
+        if (!ok()) {
+            return "FAILED";
+        }
+        if (flow_checked) {
+            return cut_checked ? "flow+cut" : "flow";
+        }
+        return cut_checked ? "cut" : "none";
+    }
+};
+
+namespace verify_detail {
+
+// Arcs per parallel work item
+constexpr size_t chunk_arcs = 1 << 16;
+
+/** Sum and first error found in one chunk of arcs or nodes. */
+struct Partial {
+    int64_t sum = 0;
+    std::string error;
+};
+
+inline Partial combine(const std::vector<Partial>& parts)
+{
+    Partial out;
+    for (const auto& p : parts) {
+        out.sum += p.sum;
+        if (out.error.empty()) {
+            out.error = p.error;
+        }
+    }
+    return out;
+}
+
+/** Call func(k, arcs[k], partial) for all k in chunks of arcs, on num_threads threads. */
+template <class Arcs, class Func>
+Partial for_arcs(const Arcs& arcs, unsigned int num_threads, Func func)
+{
+    const size_t n = arcs.size();
+    std::vector<Partial> parts((n + chunk_arcs - 1) / chunk_arcs);
+    parallel_for(parts.size(), num_threads, [&](size_t c) {
+        const size_t end = std::min(n, (c + 1) * chunk_arcs);
+        for (size_t k = c * chunk_arcs; k < end && parts[c].error.empty(); ++k) {
+            func(k, arcs[k], parts[c]);
+        }
+    });
+    return combine(parts);
+}
+
+/** Visit the terminal and neighbor arcs of a BkGraph or BkGraphView in parallel. */
+template <class Graph, class TermFunc, class NborFunc>
+Partial visit_arcs(const Graph& graph, unsigned int num_threads, TermFunc term_func, NborFunc nbor_func)
+{
+    Partial term = for_arcs(graph.terminal_arcs, num_threads, term_func);
+    Partial nbor = for_arcs(graph.neighbor_arcs, num_threads, nbor_func);
+    return combine({ term, nbor });
+}
+
+/** A stream can only be read front to back, so its arcs are visited serially. */
+template <class captype, class tcaptype, class TermFunc, class NborFunc>
+Partial visit_arcs(const GraphStream<captype, tcaptype>& stream, unsigned int, TermFunc term_func, NborFunc nbor_func)
+{
+    Partial out;
+    uint64_t term_idx = 0;
+    uint64_t nbor_idx = 0;
+    visit_graph(stream, make_visitor([](uint64_t, uint64_t, uint64_t) {}, [&](const auto& tarc) {
+        if (out.error.empty()) {
+            term_func(term_idx++, tarc, out);
+        }
+    }, [&](const auto& narc) {
+        if (out.error.empty()) {
+            nbor_func(nbor_idx++, narc, out);
+        }
+    }));
+    return out;
+}
+
+template <class Arc>
+std::string arc_name(uint64_t k, const Arc& narc)
+{
+    return "arc " + std::to_string(k) + " (" + std::to_string(narc.i) + "->" + std::to_string(narc.j) + ")";
+}
+
+} // namespace verify_detail
+
+/**
+ * Check that the capacity of the cut equals flow. The cut capacity is an upper bound on every flow, so if it matches,
+ * the flow is maximal and the cut is minimal. Arcs are summed in parallel chunks on num_threads threads.
+ */
+template <class Graph>
+VerifyResult verify_cut(const Graph& graph, int64_t flow, const std::vector<uint8_t>& cut, unsigned int num_threads = 0)
+{
+    using namespace verify_detail;
+    VerifyResult res;
+    res.cut_checked = true;
+    if (cut.size() != graph.num_nodes) {
+        res.error = "cut has " + std::to_string(cut.size()) + " nodes but the graph has " +
+            std::to_string(graph.num_nodes);
+        return res;
+    }
+    Partial total = visit_arcs(graph, num_threads, [&](uint64_t, const auto& tarc, Partial& p) {
+        // Source side nodes cut their sink arc, sink side nodes their source arc
+        p.sum += cut[tarc.node] ? tarc.sink_cap : tarc.source_cap;
+    }, [&](uint64_t, const auto& narc, Partial& p) {
+        if (cut[narc.i] && !cut[narc.j]) {
+            p.sum += narc.cap;
+        } else if (!cut[narc.i] && cut[narc.j]) {
+            p.sum += narc.rev_cap;
+        }
+    });
+    if (total.sum != flow) {
+        res.error = "cut capacity " + std::to_string(total.sum) + " differs from maxflow " + std::to_string(flow);
+    }
+    return res;
+}
+
+/**
+ * Check the flow given by the residual capacities of a solve: each arc pair must keep its total capacity with both
+ * residuals non-negative, every node must be able to balance its net outflow with its terminal arcs, and the flow
+ * this allows from the source must equal flow. Terminal arcs of a node are merged, as the solvers do, so a node with
+ * capacity to both terminals also carries flow straight from source to sink.
+ */
+template <class Graph>
+VerifyResult verify_flow(const Graph& graph, int64_t flow, const std::vector<int64_t>& residuals,
+    unsigned int num_threads = 0)
+{
+    using namespace verify_detail;
+    VerifyResult res;
+    res.flow_checked = true;
+    const uint64_t num_nodes = graph.num_nodes;
+    if (residuals.size() != 2 * neighbor_arc_count(graph)) {
+        res.error = "solver has " + std::to_string(residuals.size()) + " residual arcs but the graph has " +
+            std::to_string(2 * neighbor_arc_count(graph));
+        return res;
+    }
+
+    // Terminal capacities and net outflow over neighbor arcs of each node
+    std::vector<std::atomic<int64_t>> source_caps(num_nodes);
+    std::vector<std::atomic<int64_t>> sink_caps(num_nodes);
+    std::vector<std::atomic<int64_t>> net_out(num_nodes);
+    Partial arcs = visit_arcs(graph, num_threads, [&](uint64_t, const auto& tarc, Partial&) {
+        source_caps[tarc.node].fetch_add(tarc.source_cap, std::memory_order_relaxed);
+        sink_caps[tarc.node].fetch_add(tarc.sink_cap, std::memory_order_relaxed);
+    }, [&](uint64_t k, const auto& narc, Partial& p) {
+        const int64_t res_fwd = residuals[2 * k];
+        const int64_t res_rev = residuals[2 * k + 1];
+        if (res_fwd < 0 || res_rev < 0 || res_fwd + res_rev != int64_t(narc.cap) + narc.rev_cap) {
+            p.error = arc_name(k, narc) + " with capacities " + std::to_string(narc.cap) + "/" +
+                std::to_string(narc.rev_cap) + " has residuals " + std::to_string(res_fwd) + "/" +
+                std::to_string(res_rev);
+            return;
+        }
+        const int64_t f = narc.cap - res_fwd;
+        net_out[narc.i].fetch_add(f, std::memory_order_relaxed);
+        net_out[narc.j].fetch_sub(f, std::memory_order_relaxed);
+    });
+    if (!arcs.error.empty()) {
+        res.error = arcs.error;
+        return res;
+    }
+
+    std::vector<Partial> parts((num_nodes + chunk_arcs - 1) / chunk_arcs);
+    parallel_for(parts.size(), num_threads, [&](size_t c) {
+        const uint64_t end = std::min<uint64_t>(num_nodes, (c + 1) * chunk_arcs);
+        for (uint64_t i = c * chunk_arcs; i < end; ++i) {
+            const int64_t src = source_caps[i].load(std::memory_order_relaxed);
+            const int64_t snk = sink_caps[i].load(std::memory_order_relaxed);
+            const int64_t out = net_out[i].load(std::memory_order_relaxed);
+            if (out > src || -out > snk) {
+                parts[c].error = "node " + std::to_string(i) + " has net outflow " + std::to_string(out) +
+                    " but terminal capacities " + std::to_string(src) + "/" + std::to_string(snk);
+                return;
+            }
+            // Flow from the source: what leaves over neighbor arcs plus what goes straight on to the sink
+            const int64_t from_source = std::max<int64_t>(out, 0);
+            parts[c].sum += from_source + std::min(src - from_source, snk - std::max<int64_t>(-out, 0));
+        }
+    });
+    Partial nodes = combine(parts);
+    if (!nodes.error.empty()) {
+        res.error = nodes.error;
+    } else if (nodes.sum != flow) {
+        res.error = "flow value " + std::to_string(nodes.sum) + " of the arc flows differs from maxflow " +
+            std::to_string(flow);
+    }
+    return res;
+}
+
+/**
+ * Verify a solve with all checks its certificate allows: the flow if residuals are given, and the cut if one was
+ * extracted. Both take O(n + m) work, split over num_threads threads (all cores if 0) unless graph is a stream.
+ */
+template <class Graph>
+VerifyResult verify_solve(const Graph& graph, int64_t flow, const SolveCertificate& certificate,
+    unsigned int num_threads = 0)
+{
+    VerifyResult res;
+    if (!certificate.residuals.empty()) {
+        res = verify_flow(graph, flow, certificate.residuals, num_threads);
+        if (!res.ok()) {
+            return res;
+        }
+    }
+    if (!certificate.cut.empty()) {
+        VerifyResult cut_res = verify_cut(graph, flow, certificate.cut, num_threads);
+        res.cut_checked = true;
+        res.error = cut_res.error;
+    }
+    return res;
+}
+
+#endif // FLOW_VERIFY_H__
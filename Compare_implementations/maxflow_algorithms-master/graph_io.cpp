@@ -60,6 +60,17 @@ std::vector<std::pair<size_t, uint16_t>> split_block_intervals(const std::vector
     return intervals;
 }
 
+std::pair<std::vector<uint16_t>, uint16_t> contiguous_blocks(uint64_t num_nodes, uint16_t num_blocks) {
+    num_blocks = static_cast<uint16_t>(std::max<uint64_t>(1, std::min<uint64_t>(num_blocks, num_nodes)));
+    std::vector<uint16_t> blocks(num_nodes);
+    for (uint16_t b = 0; b < num_blocks; ++b) {
+        uint64_t first = num_nodes * b / num_blocks;
+        uint64_t last = num_nodes * (b + 1) / num_blocks;
+        std::fill(blocks.begin() + first, blocks.begin() + last, b);
+    }
+    return std::make_pair(blocks, num_blocks);
+}
+
 std::pair<std::vector<std::pair<size_t, uint16_t>>, uint16_t> grid_block_intervals(
     size_t grid_h, size_t grid_w, size_t grid_d, size_t block_h, size_t block_w, size_t block_d) {
     std::vector<std::pair<size_t, uint16_t>> intervals;
@@ -144,3 +155,117 @@ std::tuple<uint64_t, uint64_t, double> parse_arc_line_float(const std::string &l
     return std::make_tuple(from, to, cap);
 }
 
+
+bool is_uncompressed_bbk(const std::string &fname) {
+    std::fstream file(fname, std::ios::in | std::ios::binary);
+    char header[3] = {0};
+    file.read(header, sizeof(header));
+    return file && std::strncmp(header, "BBQ", 3) == 0;
+}
+
+bool is_uncompressed_bq(const std::string &fname) {
+    std::fstream file(fname, std::ios::in | std::ios::binary);
+    char header[5] = {0};
+    file.read(header, sizeof(header));
+    return file && std::strncmp(header, "BQPBO", 5) == 0;
+}
+
+ChunkedBbkHeader parse_chunked_bbk_header(const MappedFile &file, const std::string &fname) {
+    ChunkedBbkHeader header;
+    const char *data = file.data();
+    const size_t size = file.size();
+
+    uint64_t sizes[3];
+    uint64_t num_chunks[2];
+    constexpr size_t fixed_size = 3 + sizeof(header.types) + sizeof(sizes) + sizeof(num_chunks);
+    if (size < fixed_size || std::strncmp(data, "bbc", 3) != 0) {
+        throw std::runtime_error("Invalid file header for chunked binary BK file.");
+    }
+    std::memcpy(header.types, data + 3, sizeof(header.types));
+    std::memcpy(sizes, data + 5, sizeof(sizes));
+    std::memcpy(num_chunks, data + 5 + sizeof(sizes), sizeof(num_chunks));
+    header.num_nodes = sizes[0];
+    header.num_term_arcs = sizes[1];
+    header.num_nbor_arcs = sizes[2];
+
+    const uint64_t total_chunks = num_chunks[0] + num_chunks[1];
+    if (total_chunks > (size - fixed_size) / sizeof(BbkChunk)) {
+        throw std::runtime_error("Chunked binary BK file is truncated: " + fname);
+    }
+    header.term_chunks.resize(num_chunks[0]);
+    header.nbor_chunks.resize(num_chunks[1]);
+    std::memcpy(header.term_chunks.data(), data + fixed_size, num_chunks[0] * sizeof(BbkChunk));
+    std::memcpy(header.nbor_chunks.data(), data + fixed_size + num_chunks[0] * sizeof(BbkChunk),
+        num_chunks[1] * sizeof(BbkChunk));
+
+    // Validate index so decompression never reads outside the file or writes outside the arc arrays
+    auto check_chunks = [&](const std::vector<BbkChunk> &chunks, uint64_t num_elems) {
+        uint64_t total = 0;
+        for (const auto &c : chunks) {
+            if (c.offset > size || c.compressed_bytes > size - c.offset) {
+                throw std::runtime_error("Chunked binary BK file is truncated: " + fname);
+            }
+            total += c.num_elems;
+        }
+        if (total != num_elems) {
+            throw std::runtime_error("Chunk index does not match arc counts in file: " + fname);
+        }
+    };
+    check_chunks(header.term_chunks, header.num_term_arcs);
+    check_chunks(header.nbor_chunks, header.num_nbor_arcs);
+
+    return header;
+}
+
+namespace packed_detail {
+
+void pack_ints(std::string &out, const std::vector<int64_t> &values) {
+    int64_t min = 0;
+    uint64_t range = 0;
+    if (!values.empty()) {
+        auto minmax = std::minmax_element(values.begin(), values.end());
+        min = *minmax.first;
+        range = static_cast<uint64_t>(*minmax.second) - static_cast<uint64_t>(min);
+    }
+    uint8_t bits = 0;
+    while (bits < 64 && (range >> bits) != 0) {
+        bits++;
+    }
+
+    out.append(reinterpret_cast<const char *>(&min), sizeof(min));
+    out.append(reinterpret_cast<const char *>(&bits), sizeof(bits));
+    if (bits == 0) {
+        return;
+    }
+
+    std::vector<uint64_t> words((values.size() * bits + 63) / 64, 0);
+    uint64_t bit_pos = 0;
+    for (int64_t v : values) {
+        uint64_t u = static_cast<uint64_t>(v) - static_cast<uint64_t>(min);
+        uint64_t word_idx = bit_pos >> 6;
+        uint64_t shift = bit_pos & 63;
+        words[word_idx] |= u << shift;
+        if (shift + bits > 64) {
+            words[word_idx + 1] |= u >> (64 - shift);
+        }
+        bit_pos += bits;
+    }
+    out.append(reinterpret_cast<const char *>(words.data()), words.size() * sizeof(uint64_t));
+}
+
+PackedIntReader::PackedIntReader(const char *data, size_t bytes, size_t count) {
+    uint8_t bits;
+    if (bytes < sizeof(min_) + sizeof(bits)) {
+        throw std::runtime_error("Packed binary BK file is truncated.");
+    }
+    std::memcpy(&min_, data, sizeof(min_));
+    std::memcpy(&bits, data + sizeof(min_), sizeof(bits));
+    if (bits > 64 || bytes - sizeof(min_) - sizeof(bits) < (count * bits + 63) / 64 * sizeof(uint64_t)) {
+        throw std::runtime_error("Packed binary BK file is truncated.");
+    }
+    words_ = data + sizeof(min_) + sizeof(bits);
+    bits_ = bits;
+    mask_ = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+}
+
+} // namespace packed_detail
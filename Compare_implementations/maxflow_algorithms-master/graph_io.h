@@ -3,19 +3,29 @@
 
 #include <stdexcept>
 #include <vector>
+#include <algorithm>
 #include <stdio.h>
 #include <inttypes.h>
 #include <string>
 #include <cstring>
+#include <cstdlib>
+#include <cctype>
 #include <fstream>
 #include <utility>
 #include <tuple>
 #include <type_traits>
+#include <atomic>
+#include <thread>
+#include <exception>
 #include <assert.h>
+#include <charconv>
+#include <limits>
 
 #include "robin_hood.h"
 #include "snappy.h"
 
+#include "dimacs_reader.h"
+
 /** Enum for switching over POD types. */
 enum TypeCode : uint8_t {
     TYPE_UINT8,
@@ -115,6 +125,49 @@ struct BkQpbo {
     std::vector<BkBinaryTerm<Ty>> binary_terms;
 };
 
+/**
+ * Read-only array view over memory which may not be suitably aligned for Ty, e.g. arcs in a mapped file.
+ * Elements are returned by value and copied out with memcpy, which compiles to plain loads on x86.
+ */
+template <class Ty>
+class UnalignedSpan {
+    static_assert(std::is_trivially_copyable<Ty>::value, "UnalignedSpan requires trivially copyable type");
+public:
+    class iterator {
+    public:
+        explicit iterator(const char *ptr) noexcept : ptr_(ptr) {}
+        Ty operator*() const noexcept
+        {
+            Ty out;
+            std::memcpy(&out, ptr_, sizeof(Ty));
+            return out;
+        }
+        iterator& operator++() noexcept
+        {
+            ptr_ += sizeof(Ty);
+            return *this;
+        }
+        bool operator==(const iterator& other) const noexcept { return ptr_ == other.ptr_; }
+        bool operator!=(const iterator& other) const noexcept { return ptr_ != other.ptr_; }
+    private:
+        const char *ptr_;
+    };
+
+    UnalignedSpan() = default;
+    UnalignedSpan(const char *data, size_t size) noexcept : data_(data), size_(size) {}
+
+    Ty operator[](size_t i) const noexcept { return *iterator(data_ + i * sizeof(Ty)); }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const char *data() const noexcept { return data_; }
+    iterator begin() const noexcept { return iterator(data_); }
+    iterator end() const noexcept { return iterator(data_ + size_ * sizeof(Ty)); }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+};
+
 template <class Ty>
 void compress_and_write(const std::vector<Ty>& vec, std::fstream& file, std::string& buffer)
 {
@@ -160,6 +213,12 @@ void write_blocks(const std::string& fname, const std::vector<uint16_t>& node_bl
  */
 std::vector<std::pair<size_t, uint16_t>> split_block_intervals(const std::vector<uint16_t>& node_blocks);
 
+/**
+ * Split nodes into num_blocks blocks of consecutive node indices of (almost) equal size. For graphs whose nodes are
+ * numbered in scan order, e.g. most grids, this gives slabs. Returns block index for each node and number of blocks.
+ */
+std::pair<std::vector<uint16_t>, uint16_t> contiguous_blocks(uint64_t num_nodes, uint16_t num_blocks);
+
 /**
  * Make intervals of block indices corresponding to box-shaped blocks in a grid graph.
  * Returns vector of (interval length, block index) and max block index.
@@ -174,9 +233,12 @@ std::pair<std::vector<std::pair<size_t, uint16_t>>, uint16_t> grid_block_interva
 /** 
  * Read DIMACS file describing a directed arc weighted graph with a source and sink node.
  * Implmented according to the spec. at: http://lpsolve.sourceforge.net/5.5/DIMACS_maxf.htm
+ *
+ * The file is parsed by the shared reader in dimacs_reader.h, i.e. memory mapped and parsed in parallel using
+ * num_threads threads (0 means one per core).
  */
 template <class captype, class tcaptype>
-BkGraph<captype, tcaptype> read_dimacs_to_bk(const std::string fname);
+BkGraph<captype, tcaptype> read_dimacs_to_bk(const std::string fname, unsigned int num_threads = 0);
 
 /**
  * Read lines in fs until a non-comment line is read into line buffer. 
@@ -228,56 +290,183 @@ inline uint64_t convert_node_id(uint64_t n_id, uint64_t s_id, uint64_t t_id)
     return out;
 }
 
-template <class captype, class tcaptype>
-BkGraph<captype, tcaptype> read_dimacs_to_bk(const std::string fname)
-{
-    int64_t num_nodes, s_id, t_id;
+namespace dimacs_detail {
 
-    std::fstream file(fname);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file: " + fname);
+/**
+ * Split a DIMACS arc into a terminal or neighbor arc of the BK graph with source s_id and sink t_id and pass it to
+ * term_func or nbor_func. Node ids are converted to zero-based ids without source and sink.
+ */
+template <class captype, class tcaptype, class TermFunc, class NborFunc>
+inline void split_arc(const DimacsArc<captype>& arc, uint64_t s_id, uint64_t t_id, TermFunc&& term_func,
+    NborFunc&& nbor_func)
+{
+    // We assume no i->source or sink->i edges exist
+    if (arc.from == s_id) {
+        term_func(BkTermArc<tcaptype>{ convert_node_id(arc.to, s_id, t_id), static_cast<tcaptype>(arc.cap), 0 });
+    } else if (arc.to == t_id) {
+        term_func(BkTermArc<tcaptype>{ convert_node_id(arc.from, s_id, t_id), 0, static_cast<tcaptype>(arc.cap) });
+    } else {
+        assert(arc.to != s_id && arc.from != t_id);
+        nbor_func(BkNborArc<captype>{
+            convert_node_id(arc.from, s_id, t_id), convert_node_id(arc.to, s_id, t_id), arc.cap, 0 });
     }
+}
 
-    std::string line;
+} // namespace dimacs_detail
 
-    // Read problem line
-    next_code_line(file, line);
-    std::tie(num_nodes, std::ignore) = parse_problem_line(line);
+template <class captype, class tcaptype>
+BkGraph<captype, tcaptype> read_dimacs_to_bk(const std::string fname, unsigned int num_threads)
+{
+    auto chunks = dimacs_detail::parse_file<captype>(fname, num_threads);
+    const uint64_t s_id = chunks.front().source;
+    const uint64_t t_id = chunks.front().sink;
+    if (s_id == 0 || t_id == 0) {
+        throw std::runtime_error("Missing source or sink descriptor in DIMACS file: " + fname);
+    }
+
+    // Count terminal arcs in each chunk so every chunk can write its part of the graph independently
+    std::vector<size_t> term_counts(chunks.size(), 0);
+    std::vector<size_t> nbor_counts(chunks.size(), 0);
+    parallel_for(chunks.size(), num_threads, [&](size_t i) {
+        size_t count = 0;
+        for (const auto& arc : chunks[i].arcs) {
+            count += (arc.from == s_id || arc.to == t_id);
+        }
+        term_counts[i] = count;
+        nbor_counts[i] = chunks[i].arcs.size() - count;
+    });
+    auto term_offsets = dimacs_detail::prefix_offsets(term_counts);
+    auto nbor_offsets = dimacs_detail::prefix_offsets(nbor_counts);
 
     // Subtract two as we don't add source and sink
     BkGraph<captype, tcaptype> bkg;
-    bkg.num_nodes = num_nodes - 2;
-
-    // Read node descriptors
-    next_code_line(file, line);
-    auto node1 = parse_node_line(line);
-    next_code_line(file, line);
-    auto node2 = parse_node_line(line);
-    if (node1.second == 's') {
-        s_id = node1.first;
-        t_id = node2.first;
+    bkg.num_nodes = chunks.front().num_nodes - 2;
+    bkg.terminal_arcs.resize(term_offsets.back());
+    bkg.neighbor_arcs.resize(nbor_offsets.back());
+
+    parallel_for(chunks.size(), num_threads, [&](size_t i) {
+        auto tarc = bkg.terminal_arcs.begin() + term_offsets[i];
+        auto narc = bkg.neighbor_arcs.begin() + nbor_offsets[i];
+        for (const auto& arc : chunks[i].arcs) {
+            dimacs_detail::split_arc<captype, tcaptype>(arc, s_id, t_id,
+                [&](const BkTermArc<tcaptype>& t) { *tarc++ = t; },
+                [&](const BkNborArc<captype>& n) { *narc++ = n; });
+        }
+        chunks[i].arcs = std::vector<DimacsArc<captype>>(); // Free memory early
+    });
+
+    return bkg;
+}
+
+namespace dimacs_detail {
+
+template <class Ty>
+inline void append_cap(std::string& out, Ty cap)
+{
+    char buf[32];
+    if (std::is_integral<Ty>::value) {
+        auto res = std::to_chars(buf, buf + sizeof(buf), static_cast<int64_t>(cap));
+        out.append(buf, res.ptr);
     } else {
-        s_id = node2.first;
-        t_id = node1.first;
+        int len = snprintf(buf, sizeof(buf), "%.17g", static_cast<double>(cap));
+        out.append(buf, len);
     }
+}
 
-    uint64_t from, to;
-    captype cap;
-    while (next_code_line(file, line)) {
-        std::tie(from, to, cap) = parse_arc_line<captype>(line);
-        // We assume no i->source or sink->i edges exist
-        if (from == s_id) {
-            bkg.terminal_arcs.push_back({ convert_node_id(to, s_id, t_id), cap, 0 });
-        } else if (to == t_id) {
-            bkg.terminal_arcs.push_back({ convert_node_id(from, s_id, t_id), 0, cap });
+inline void append_node(std::string& out, uint64_t node)
+{
+    char buf[std::numeric_limits<uint64_t>::digits10 + 1];
+    auto res = std::to_chars(buf, buf + sizeof(buf), node);
+    if (res.ec != std::errc()) {
+        throw std::runtime_error("Could not format node " + std::to_string(node) + ".");
+    }
+    out.append(buf, res.ptr);
+}
+
+inline void append_arc_prefix(std::string& out, uint64_t from, uint64_t to)
+{
+    out.append("a ");
+    append_node(out, from);
+    out.push_back(' ');
+    append_node(out, to);
+    out.push_back(' ');
+}
+
+} // namespace dimacs_detail
+
+/**
+ * Write graph as DIMACS file with the source as node 1, the sink as node 2 and node i as i + 3. Arcs with zero
+ * capacity are left out. The arc lines are formatted in parallel using num_threads threads (0 means one per core)
+ * and written in order, so the output does not depend on the number of threads.
+ */
+template <class captype, class tcaptype>
+void write_bk_to_dimacs(const std::string& fname, const BkGraph<captype, tcaptype>& bkg,
+    unsigned int num_threads = 0)
+{
+    std::fstream file(fname, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+
+    constexpr size_t arcs_per_piece = 1 << 16;
+    const size_t num_term_pieces = (bkg.terminal_arcs.size() + arcs_per_piece - 1) / arcs_per_piece;
+    const size_t num_pieces = num_term_pieces + (bkg.neighbor_arcs.size() + arcs_per_piece - 1) / arcs_per_piece;
+    std::vector<std::string> pieces(num_pieces);
+    std::vector<size_t> piece_arcs(num_pieces, 0);
+    parallel_for(num_pieces, num_threads, [&](size_t p) {
+        std::string& out = pieces[p];
+        size_t count = 0;
+        if (p < num_term_pieces) {
+            size_t first = p * arcs_per_piece;
+            size_t last = std::min(first + arcs_per_piece, bkg.terminal_arcs.size());
+            out.reserve((last - first) * 24);
+            for (size_t i = first; i < last; ++i) {
+                const auto& a = bkg.terminal_arcs[i];
+                if (a.source_cap != 0) {
+                    dimacs_detail::append_arc_prefix(out, 1, a.node + 3);
+                    dimacs_detail::append_cap(out, a.source_cap);
+                    out.push_back('\n');
+                    count++;
+                }
+                if (a.sink_cap != 0) {
+                    dimacs_detail::append_arc_prefix(out, a.node + 3, 2);
+                    dimacs_detail::append_cap(out, a.sink_cap);
+                    out.push_back('\n');
+                    count++;
+                }
+            }
         } else {
-            assert(to != s_id && from != t_id);
-            bkg.neighbor_arcs.push_back(
-                { convert_node_id(from, s_id, t_id), convert_node_id(to, s_id, t_id), cap, 0 });
+            size_t first = (p - num_term_pieces) * arcs_per_piece;
+            size_t last = std::min(first + arcs_per_piece, bkg.neighbor_arcs.size());
+            out.reserve((last - first) * 32);
+            for (size_t i = first; i < last; ++i) {
+                const auto& a = bkg.neighbor_arcs[i];
+                if (a.cap != 0) {
+                    dimacs_detail::append_arc_prefix(out, a.i + 3, a.j + 3);
+                    dimacs_detail::append_cap(out, a.cap);
+                    out.push_back('\n');
+                    count++;
+                }
+                if (a.rev_cap != 0) {
+                    dimacs_detail::append_arc_prefix(out, a.j + 3, a.i + 3);
+                    dimacs_detail::append_cap(out, a.rev_cap);
+                    out.push_back('\n');
+                    count++;
+                }
+            }
         }
-    }
+        piece_arcs[p] = count;
+    });
 
-    return bkg;
+    size_t num_arcs = 0;
+    for (size_t c : piece_arcs) {
+        num_arcs += c;
+    }
+    file << "p max " << bkg.num_nodes + 2 << ' ' << num_arcs << '\n';
+    file << "n 1 s\nn 2 t\n";
+    for (const auto& piece : pieces) {
+        file.write(piece.data(), piece.size());
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -304,7 +493,212 @@ BkGraph<captype, tcaptype> read_dimacs_to_bk(const std::string fname)
  *                (compressed_bytes_1 x uint8) compressed num_terminal_arcs x BkTermArc
  * Neighbor arcs: (1 x uint64) compressed_bytes_2
  *                (compressed_bytes_2 x uint8) compressed num_neighbor_arcs x BkNborArc
+ *
+ * Chunked
+ * =======
+ * Header: (3 x uint8) 'bbc'
+ * Types codes: (2 x uint8) captype, tcaptype
+ * Sizes: (3 x uint64) num_nodes, num_terminal_arcs, num_neighbor_arcs
+ * Chunk counts: (2 x uint64) num_terminal_chunks, num_neighbor_chunks
+ * Chunk index: ((num_terminal_chunks + num_neighbor_chunks) x BbkChunk) terminal chunks first
+ * Chunk data: compressed chunks at the offsets given in the index
+ *
+ * Each chunk holds a whole number of arcs and is compressed independently, so chunks can be decompressed in
+ * parallel or one at a time.
+ *
+ * Packed
+ * ======
+ * Header: (3 x uint8) 'bbp'
+ * Types codes: (2 x uint8) captype, tcaptype
+ * Sizes: (3 x uint64) num_nodes, num_terminal_arcs, num_neighbor_arcs
+ * Stream sizes: (4 x uint64) bytes in each of the four streams below
+ * Terminal nodes: (num_terminal_arcs x varint) zigzag encoded node - previous node
+ * Terminal caps: (packed ints) source_cap, sink_cap for each terminal arc
+ * Neighbor nodes: (num_neighbor_arcs x 2 x varint) i - previous i, zigzag encoded j - i
+ * Neighbor caps: (packed ints) cap, rev_cap for each neighbor arc
+ *
+ * Neighbor arcs are stably sorted by i before writing, so i deltas are non-negative and usually 0 or 1.
+ * Packed ints are stored as (1 x int64) min, (1 x uint8) bits, followed by each value - min in bits bits,
+ * least significant bit first, in uint64 words. Only integer capacities can be packed.
+ */
+
+/** Entry in the chunk index of a chunked binary BK file. */
+struct BbkChunk {
+    uint64_t offset; // From start of file
+    uint64_t compressed_bytes;
+    uint64_t num_elems;
+};
+
+/** Default uncompressed size of chunks in chunked binary BK files. */
+constexpr size_t BBK_CHUNK_BYTES = 4 << 20;
+
+/** Sizes and chunk index of a chunked binary BK file. */
+struct ChunkedBbkHeader {
+    uint8_t types[2];
+    uint64_t num_nodes;
+    uint64_t num_term_arcs;
+    uint64_t num_nbor_arcs;
+
+    std::vector<BbkChunk> term_chunks;
+    std::vector<BbkChunk> nbor_chunks;
+};
+
+/** Parse and validate header and chunk index of a mapped chunked binary BK file. */
+ChunkedBbkHeader parse_chunked_bbk_header(const MappedFile& file, const std::string& fname);
+
+/** Decompress one chunk of a chunked binary BK file into sink, which must have room for chunk.num_elems items. */
+template <class Ty>
+void decompress_chunk(const MappedFile& file, const BbkChunk& chunk, Ty *sink)
+{
+    size_t uncompressed_bytes;
+    const char *src = file.data() + chunk.offset;
+    if (!snappy::GetUncompressedLength(src, chunk.compressed_bytes, &uncompressed_bytes) ||
+        uncompressed_bytes != chunk.num_elems * sizeof(Ty) ||
+        !snappy::RawUncompress(src, chunk.compressed_bytes, (char *)sink)) {
+        throw std::runtime_error("Corrupt chunk in chunked binary BK file.");
+    }
+}
+
+template <class captype, class tcaptype>
+ChunkedBbkHeader map_chunked_bbk(const std::string& fname, MappedFile& file)
+{
+    file = MappedFile(fname, MAP_HINT_WILLNEED);
+    ChunkedBbkHeader header = parse_chunked_bbk_header(file, fname);
+    if (header.types[0] != type_code<captype>() || header.types[1] != type_code<tcaptype>()) {
+        throw std::runtime_error("Types for binary BK file do not match requested.");
+    }
+    return header;
+}
+
+/** Read chunked binary BK file, decompressing chunks in parallel using num_threads threads (0 means one per core). */
+template <class captype, class tcaptype>
+BkGraph<captype, tcaptype> read_chunked_bbk_to_bk(const std::string& fname, unsigned int num_threads = 0)
+{
+    MappedFile file;
+    ChunkedBbkHeader header = map_chunked_bbk<captype, tcaptype>(fname, file);
+
+    BkGraph<captype, tcaptype> bkg;
+    bkg.num_nodes = header.num_nodes;
+    bkg.terminal_arcs.resize(header.num_term_arcs);
+    bkg.neighbor_arcs.resize(header.num_nbor_arcs);
+
+    // Element offset of every chunk in its array
+    const size_t num_term_chunks = header.term_chunks.size();
+    std::vector<size_t> elem_offsets(num_term_chunks + header.nbor_chunks.size());
+    for (size_t i = 1; i < num_term_chunks; ++i) {
+        elem_offsets[i] = elem_offsets[i - 1] + header.term_chunks[i - 1].num_elems;
+    }
+    for (size_t i = num_term_chunks + 1; i < elem_offsets.size(); ++i) {
+        elem_offsets[i] = elem_offsets[i - 1] + header.nbor_chunks[i - num_term_chunks - 1].num_elems;
+    }
+
+    parallel_for(elem_offsets.size(), num_threads, [&](size_t i) {
+        if (i < num_term_chunks) {
+            decompress_chunk(file, header.term_chunks[i], bkg.terminal_arcs.data() + elem_offsets[i]);
+        } else {
+            decompress_chunk(file, header.nbor_chunks[i - num_term_chunks],
+                bkg.neighbor_arcs.data() + elem_offsets[i]);
+        }
+    });
+
+    return bkg;
+}
+
+/**
+ * Stream the arcs of a chunked binary BK file without materializing the graph. Calls
+ * sizes_func(num_nodes, num_terminal_arcs, num_neighbor_arcs) once, then term_func(const BkTermArc *, size_t)
+ * for every terminal chunk and nbor_func(const BkNborArc *, size_t) for every neighbor chunk, in file order and
+ * from the calling thread. Up to num_threads chunks are decompressed in parallel ahead of the callbacks, so only
+ * num_threads chunk buffers are held in memory at once.
  */
+template <class captype, class tcaptype, class SizesFunc, class TermFunc, class NborFunc>
+void stream_chunked_bbk(const std::string& fname, SizesFunc sizes_func, TermFunc term_func, NborFunc nbor_func,
+    unsigned int num_threads = 0)
+{
+    MappedFile file;
+    ChunkedBbkHeader header = map_chunked_bbk<captype, tcaptype>(fname, file);
+    sizes_func(header.num_nodes, header.num_term_arcs, header.num_nbor_arcs);
+
+    if (num_threads == 0) {
+        num_threads = default_num_threads();
+    }
+    auto stream = [&](const std::vector<BbkChunk>& chunks, auto *type_tag, auto func) {
+        using Ty = std::remove_pointer_t<decltype(type_tag)>;
+        std::vector<std::vector<Ty>> buffers(num_threads);
+        for (size_t first = 0; first < chunks.size(); first += num_threads) {
+            size_t batch = std::min<size_t>(num_threads, chunks.size() - first);
+            parallel_for(batch, num_threads, [&](size_t i) {
+                buffers[i].resize(chunks[first + i].num_elems);
+                decompress_chunk(file, chunks[first + i], buffers[i].data());
+            });
+            for (size_t i = 0; i < batch; ++i) {
+                func(static_cast<const Ty *>(buffers[i].data()), buffers[i].size());
+            }
+        }
+    };
+    stream(header.term_chunks, static_cast<BkTermArc<tcaptype> *>(nullptr), term_func);
+    stream(header.nbor_chunks, static_cast<BkNborArc<captype> *>(nullptr), nbor_func);
+}
+
+/**
+ * Write chunked binary BK file. Chunks hold about chunk_bytes of uncompressed arcs each and are compressed in
+ * parallel using num_threads threads (0 means one per core).
+ */
+template <class captype, class tcaptype>
+void write_bk_to_chunked_bbk(const std::string& fname, const BkGraph<captype, tcaptype>& bkg,
+    size_t chunk_bytes = BBK_CHUNK_BYTES, unsigned int num_threads = 0)
+{
+    std::fstream file(fname, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+
+    // Split both arc arrays into chunks of whole arcs
+    struct Piece {
+        const char *data;
+        size_t bytes;
+        size_t num_elems;
+    };
+    std::vector<Piece> pieces;
+    auto add_pieces = [&](const auto& vec) {
+        using Ty = typename std::decay_t<decltype(vec)>::value_type;
+        const size_t elems_per_chunk = std::max<size_t>(1, chunk_bytes / sizeof(Ty));
+        for (size_t first = 0; first < vec.size(); first += elems_per_chunk) {
+            size_t n = std::min(elems_per_chunk, vec.size() - first);
+            pieces.push_back({ (const char *)(vec.data() + first), n * sizeof(Ty), n });
+        }
+        return (vec.size() + elems_per_chunk - 1) / elems_per_chunk;
+    };
+    const uint64_t num_chunks[2] = { add_pieces(bkg.terminal_arcs), add_pieces(bkg.neighbor_arcs) };
+
+    std::vector<std::string> compressed(pieces.size());
+    parallel_for(pieces.size(), num_threads, [&](size_t i) {
+        snappy::Compress(pieces[i].data, pieces[i].bytes, &compressed[i]);
+    });
+
+    // Write header, sizes and chunk index
+    static const uint8_t types[2] = { type_code<captype>(), type_code<tcaptype>() };
+    const uint64_t sizes[3] = { bkg.num_nodes, bkg.terminal_arcs.size(), bkg.neighbor_arcs.size() };
+    file.write("bbc", 3);
+    file.write((char *)types, sizeof(types));
+    file.write((char *)sizes, sizeof(sizes));
+    file.write((char *)num_chunks, sizeof(num_chunks));
+
+    uint64_t offset = 3 + sizeof(types) + sizeof(sizes) + sizeof(num_chunks) + pieces.size() * sizeof(BbkChunk);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        BbkChunk chunk = { offset, compressed[i].size(), pieces[i].num_elems };
+        file.write((char *)&chunk, sizeof(chunk));
+        offset += compressed[i].size();
+    }
+
+    // Write chunk data
+    for (const auto& c : compressed) {
+        file.write(c.data(), c.size());
+    }
+}
+
+template <class captype, class tcaptype>
+BkGraph<captype, tcaptype> read_packed_bbk_to_bk(const std::string& fname);
 
 /** Read binary BK file */
 template <class captype, class tcaptype>
@@ -318,6 +712,14 @@ BkGraph<captype, tcaptype> read_bbk_to_bk(const std::string fname)
     // Read file header
     uint8_t header[3] = { 0 };
     file.read((char *)header, sizeof(header));
+    if (std::strncmp((char *)header, "bbc", 3) == 0) {
+        file.close();
+        return read_chunked_bbk_to_bk<captype, tcaptype>(fname);
+    }
+    if (std::strncmp((char *)header, "bbp", 3) == 0) {
+        file.close();
+        return read_packed_bbk_to_bk<captype, tcaptype>(fname);
+    }
     if (std::strncmp((char *)header, "BBQ", 3) != 0 && std::strncmp((char *)header, "bbq", 3) != 0) {
         throw std::runtime_error("Invalid file header for binary BK file.");
     }
@@ -356,6 +758,60 @@ BkGraph<captype, tcaptype> read_bbk_to_bk(const std::string fname)
     return bkg;
 }
 
+/**
+ * Graph backed directly by a memory mapped uncompressed binary BK file. Has the same members as BkGraph, so it can
+ * be passed to any code which only iterates over the arcs. Arcs are read straight from the mapping, so there is no
+ * copy of the file contents and repeated loads of the same file are served from the page cache.
+ */
+template <class captype, class tcaptype>
+struct BkGraphView {
+    uint64_t num_nodes = 0;
+
+    UnalignedSpan<BkTermArc<tcaptype>> terminal_arcs;
+    UnalignedSpan<BkNborArc<captype>> neighbor_arcs;
+
+    MappedFile file;
+};
+
+/** Return true if fname starts with the header of an uncompressed binary BK file, i.e. map_bbk_to_view can map it. */
+bool is_uncompressed_bbk(const std::string& fname);
+
+/** Map uncompressed binary BK file. Throws if the file is compressed as arcs cannot be accessed in place then. */
+template <class captype, class tcaptype>
+BkGraphView<captype, tcaptype> map_bbk_to_view(const std::string& fname, MapHint hint = MAP_HINT_POPULATE)
+{
+    BkGraphView<captype, tcaptype> view;
+    view.file = MappedFile(fname, hint);
+    const char *data = view.file.data();
+    const size_t size = view.file.size();
+
+    // Same layout as read by read_bbk_to_bk: header, type codes and sizes
+    constexpr size_t header_size = 3 + 2 + 3 * sizeof(uint64_t);
+    if (size < header_size || (std::strncmp(data, "BBQ", 3) != 0 && std::strncmp(data, "bbq", 3) != 0)) {
+        throw std::runtime_error("Invalid file header for binary BK file.");
+    }
+    if (std::islower(data[0])) {
+        throw std::runtime_error("Compressed binary BK files cannot be mapped: " + fname);
+    }
+    if (static_cast<uint8_t>(data[3]) != type_code<captype>() ||
+        static_cast<uint8_t>(data[4]) != type_code<tcaptype>()) {
+        throw std::runtime_error("Types for binary BK file do not match requested.");
+    }
+
+    uint64_t sizes[3];
+    std::memcpy(sizes, data + 5, sizeof(sizes));
+    const size_t term_bytes = sizes[1] * sizeof(BkTermArc<tcaptype>);
+    const size_t nbor_bytes = sizes[2] * sizeof(BkNborArc<captype>);
+    if (size < header_size + term_bytes + nbor_bytes) {
+        throw std::runtime_error("Binary BK file is truncated: " + fname);
+    }
+
+    view.num_nodes = sizes[0];
+    view.terminal_arcs = UnalignedSpan<BkTermArc<tcaptype>>(data + header_size, sizes[1]);
+    view.neighbor_arcs = UnalignedSpan<BkNborArc<captype>>(data + header_size + term_bytes, sizes[2]);
+    return view;
+}
+
 /** Write binary BK file */
 template <class captype, class tcaptype>
 void write_bk_to_bbk(const std::string fname, const BkGraph<captype, tcaptype>& bkg, bool compress = true)
@@ -389,6 +845,555 @@ void write_bk_to_bbk(const std::string fname, const BkGraph<captype, tcaptype>&
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Packed binary BK
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace packed_detail {
+
+inline uint64_t zigzag(int64_t v) noexcept
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) noexcept
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline void put_varint(std::string& out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline const char *get_varint(const char *pos, const char *end, uint64_t& v)
+{
+    uint64_t out = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*pos++);
+        out |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            v = out;
+            return pos;
+        }
+    }
+    throw std::runtime_error("Corrupt varint in packed binary BK file.");
+}
+
+/** Bit pack values into out. See the file format description above. */
+void pack_ints(std::string& out, const std::vector<int64_t>& values);
+
+/** Reads back values written by pack_ints, one at a time. */
+class PackedIntReader {
+public:
+    PackedIntReader(const char *data, size_t bytes, size_t count);
+
+    int64_t next() noexcept
+    {
+        if (bits_ == 0) {
+            return min_;
+        }
+        uint64_t word_idx = bit_pos_ >> 6;
+        uint64_t shift = bit_pos_ & 63;
+        uint64_t v = load(word_idx) >> shift;
+        if (shift + bits_ > 64) {
+            v |= load(word_idx + 1) << (64 - shift);
+        }
+        bit_pos_ += bits_;
+        return min_ + static_cast<int64_t>(v & mask_);
+    }
+
+private:
+    uint64_t load(uint64_t word_idx) const noexcept
+    {
+        uint64_t w;
+        std::memcpy(&w, words_ + word_idx * sizeof(uint64_t), sizeof(w));
+        return w;
+    }
+
+    const char *words_;
+    int64_t min_;
+    uint32_t bits_;
+    uint64_t mask_;
+    uint64_t bit_pos_ = 0;
+};
+
+/** Mapped packed binary BK file with the bounds of its four streams. */
+struct PackedBbk {
+    MappedFile file;
+    uint64_t sizes[3];
+    uint64_t stream_sizes[4];
+    const char *streams[5];
+};
+
+template <class captype, class tcaptype>
+void map_packed_bbk(const std::string& fname, PackedBbk& packed)
+{
+    packed.file = MappedFile(fname, MAP_HINT_SEQUENTIAL);
+    const char *data = packed.file.data();
+    constexpr size_t header_size = 3 + 2 + sizeof(packed.sizes) + sizeof(packed.stream_sizes);
+    if (packed.file.size() < header_size || std::strncmp(data, "bbp", 3) != 0) {
+        throw std::runtime_error("Invalid file header for packed binary BK file.");
+    }
+    if (static_cast<uint8_t>(data[3]) != type_code<captype>() ||
+        static_cast<uint8_t>(data[4]) != type_code<tcaptype>()) {
+        throw std::runtime_error("Types for binary BK file do not match requested.");
+    }
+    std::memcpy(packed.sizes, data + 5, sizeof(packed.sizes));
+    std::memcpy(packed.stream_sizes, data + 5 + sizeof(packed.sizes), sizeof(packed.stream_sizes));
+
+    packed.streams[0] = data + header_size;
+    for (int s = 0; s < 4; ++s) {
+        if (packed.stream_sizes[s] > packed.file.size() - (packed.streams[s] - data)) {
+            throw std::runtime_error("Packed binary BK file is truncated: " + fname);
+        }
+        packed.streams[s + 1] = packed.streams[s] + packed.stream_sizes[s];
+    }
+}
+
+/** Decode the terminal arcs of a packed file in order, calling func(const BkTermArc&) for each. */
+template <class tcaptype, class Func>
+void decode_terminal_arcs(const PackedBbk& packed, Func func)
+{
+    const char *pos = packed.streams[0];
+    PackedIntReader caps(packed.streams[1], packed.stream_sizes[1], 2 * packed.sizes[1]);
+    int64_t node = 0;
+    for (uint64_t k = 0; k < packed.sizes[1]; ++k) {
+        uint64_t delta;
+        pos = get_varint(pos, packed.streams[1], delta);
+        node += unzigzag(delta);
+        BkTermArc<tcaptype> tarc;
+        tarc.node = node;
+        tarc.source_cap = static_cast<tcaptype>(caps.next());
+        tarc.sink_cap = static_cast<tcaptype>(caps.next());
+        func(tarc);
+    }
+}
+
+/** Decode the neighbor arcs of a packed file in order, calling func(const BkNborArc&) for each. */
+template <class captype, class Func>
+void decode_neighbor_arcs(const PackedBbk& packed, Func func)
+{
+    const char *pos = packed.streams[2];
+    PackedIntReader caps(packed.streams[3], packed.stream_sizes[3], 2 * packed.sizes[2]);
+    uint64_t i = 0;
+    for (uint64_t k = 0; k < packed.sizes[2]; ++k) {
+        uint64_t delta, offset;
+        pos = get_varint(pos, packed.streams[3], delta);
+        pos = get_varint(pos, packed.streams[3], offset);
+        i += delta;
+        BkNborArc<captype> narc;
+        narc.i = i;
+        narc.j = i + unzigzag(offset);
+        narc.cap = static_cast<captype>(caps.next());
+        narc.rev_cap = static_cast<captype>(caps.next());
+        func(narc);
+    }
+}
+
+} // namespace packed_detail
+
+/**
+ * Write packed binary BK file. Neighbor arcs are stably sorted by i, so reading the file back gives the arcs in
+ * that order rather than the order in bkg. Terminal arc order is kept.
+ */
+template <class captype, class tcaptype>
+void write_bk_to_packed_bbk(const std::string& fname, const BkGraph<captype, tcaptype>& bkg)
+{
+    static_assert(std::is_integral<captype>::value && std::is_integral<tcaptype>::value,
+        "Packed binary BK files only support integer capacities");
+    using namespace packed_detail;
+
+    std::fstream file(fname, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+
+    std::string streams[4];
+    std::vector<int64_t> caps;
+
+    // Terminal arcs in file order
+    caps.reserve(2 * bkg.terminal_arcs.size());
+    int64_t prev_node = 0;
+    for (const auto& tarc : bkg.terminal_arcs) {
+        put_varint(streams[0], zigzag(static_cast<int64_t>(tarc.node) - prev_node));
+        prev_node = tarc.node;
+        caps.push_back(tarc.source_cap);
+        caps.push_back(tarc.sink_cap);
+    }
+    pack_ints(streams[1], caps);
+
+    // Neighbor arcs sorted by i
+    std::vector<size_t> order(bkg.neighbor_arcs.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        order[k] = k;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return bkg.neighbor_arcs[a].i < bkg.neighbor_arcs[b].i;
+    });
+    caps.clear();
+    caps.reserve(2 * order.size());
+    uint64_t prev_i = 0;
+    for (auto k : order) {
+        const auto& narc = bkg.neighbor_arcs[k];
+        put_varint(streams[2], narc.i - prev_i);
+        put_varint(streams[2], zigzag(static_cast<int64_t>(narc.j) - static_cast<int64_t>(narc.i)));
+        prev_i = narc.i;
+        caps.push_back(narc.cap);
+        caps.push_back(narc.rev_cap);
+    }
+    pack_ints(streams[3], caps);
+
+    static const uint8_t types[2] = { type_code<captype>(), type_code<tcaptype>() };
+    const uint64_t sizes[3] = { bkg.num_nodes, bkg.terminal_arcs.size(), bkg.neighbor_arcs.size() };
+    const uint64_t stream_sizes[4] = { streams[0].size(), streams[1].size(), streams[2].size(), streams[3].size() };
+    file.write("bbp", 3);
+    file.write((char *)types, sizeof(types));
+    file.write((char *)sizes, sizeof(sizes));
+    file.write((char *)stream_sizes, sizeof(stream_sizes));
+    for (const auto& stream : streams) {
+        file.write(stream.data(), stream.size());
+    }
+}
+
+template <class captype, class tcaptype>
+BkGraph<captype, tcaptype> read_packed_bbk_to_bk(const std::string& fname)
+{
+    packed_detail::PackedBbk packed;
+    packed_detail::map_packed_bbk<captype, tcaptype>(fname, packed);
+
+    BkGraph<captype, tcaptype> bkg;
+    bkg.num_nodes = packed.sizes[0];
+    bkg.terminal_arcs.resize(packed.sizes[1]);
+    bkg.neighbor_arcs.resize(packed.sizes[2]);
+
+    // The terminal and neighbor arcs are independent, so they are decoded concurrently
+    parallel_for(2, 2, [&](size_t part) {
+        if (part == 0) {
+            auto tarc = bkg.terminal_arcs.begin();
+            packed_detail::decode_terminal_arcs<tcaptype>(packed, [&](const BkTermArc<tcaptype>& t) { *tarc++ = t; });
+        } else {
+            auto narc = bkg.neighbor_arcs.begin();
+            packed_detail::decode_neighbor_arcs<captype>(packed, [&](const BkNborArc<captype>& n) { *narc++ = n; });
+        }
+    });
+
+    return bkg;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Streaming
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The streaming readers pass a graph to a visitor one arc at a time instead of returning a BkGraph, so solvers can
+ * be built straight from the file without holding a second copy of the graph in memory. A visitor must have:
+ *
+ *   void on_problem(uint64_t num_nodes, uint64_t num_terminal_arcs, uint64_t num_neighbor_arcs);
+ *   void on_terminal_arc(const BkTermArc<tcaptype>& tarc);
+ *   void on_neighbor_arc(const BkNborArc<captype>& narc);
+ *
+ * on_problem is called once before any arcs and all terminal arcs are visited before the first neighbor arc, i.e.
+ * in the order of the BkGraph read_*_to_bk would return. All callbacks are made from the calling thread.
+ */
+
+enum GraphFormat {
+    GRAPH_FORMAT_DIMACS,
+    GRAPH_FORMAT_BBK
+};
+
+/**
+ * Graph file opened for streaming. Holds the sizes, so builders can be allocated before the arcs are visited, but
+ * none of the arcs. Each call to visit_graph reads the file again.
+ */
+template <class captype, class tcaptype>
+struct GraphStream {
+    std::string fname;
+    GraphFormat format;
+
+    uint64_t num_nodes = 0;
+    uint64_t num_term_arcs = 0;
+    uint64_t num_nbor_arcs = 0;
+
+    // These values are only used for DIMACS files
+    uint64_t source = 0;
+    uint64_t sink = 0;
+    size_t arcs_begin = 0;
+};
+
+/** Visitor which forwards to the given functions. See make_visitor. */
+template <class ProblemFunc, class TermFunc, class NborFunc>
+struct FuncVisitor {
+    ProblemFunc problem_func;
+    TermFunc term_func;
+    NborFunc nbor_func;
+
+    void on_problem(uint64_t num_nodes, uint64_t num_terminal_arcs, uint64_t num_neighbor_arcs)
+    {
+        problem_func(num_nodes, num_terminal_arcs, num_neighbor_arcs);
+    }
+
+    template <class TermArc>
+    void on_terminal_arc(const TermArc& tarc) { term_func(tarc); }
+
+    template <class NborArc>
+    void on_neighbor_arc(const NborArc& narc) { nbor_func(narc); }
+};
+
+template <class ProblemFunc, class TermFunc, class NborFunc>
+FuncVisitor<ProblemFunc, TermFunc, NborFunc> make_visitor(ProblemFunc problem_func, TermFunc term_func,
+    NborFunc nbor_func)
+{
+    return { problem_func, term_func, nbor_func };
+}
+
+namespace dimacs_detail {
+
+/** Return the start of the first arc line in [pos, end), or end if there is none. */
+inline const char *find_first_arc(const char *pos, const char *end) noexcept
+{
+    while (pos < end) {
+        const char *line = skip_blanks(pos, end);
+        if (line < end && *line == 'a') {
+            return pos;
+        }
+        pos = skip_line(line, end);
+    }
+    return end;
+}
+
+/**
+ * Read the descriptors of a mapped DIMACS file into stream and count its terminal and neighbor arcs in parallel.
+ * Unlike read_dimacs_to_bk, this requires all descriptors to precede the arcs, as the DIMACS spec. says.
+ */
+template <class captype, class tcaptype>
+void scan_stream_header(const MappedFile& file, GraphStream<captype, tcaptype>& stream, unsigned int num_threads)
+{
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+    const char *arcs = find_first_arc(begin, end);
+
+    ChunkInfo head;
+    scan_chunk<captype>(begin, arcs, head, [](const DimacsArc<captype>&) {});
+    if (!head.has_problem) {
+        throw std::runtime_error("Missing problem line in DIMACS file: " + stream.fname);
+    }
+    if (head.source == 0 || head.sink == 0) {
+        throw std::runtime_error("Missing source or sink descriptor in DIMACS file: " + stream.fname);
+    }
+
+    if (num_threads == 0) {
+        num_threads = default_num_threads();
+    }
+    constexpr size_t min_chunk_size = 1 << 20;
+    std::vector<size_t> bounds = split_at_lines(arcs, end - arcs, num_threads, min_chunk_size);
+    std::vector<size_t> term_counts(bounds.size() - 1, 0);
+    std::vector<size_t> nbor_counts(bounds.size() - 1, 0);
+    parallel_for(bounds.size() - 1, num_threads, [&](size_t i) {
+        ChunkInfo info;
+        scan_chunk<captype>(arcs + bounds[i], arcs + bounds[i + 1], info, [&](const DimacsArc<captype>& arc) {
+            bool is_term = arc.from == head.source || arc.to == head.sink;
+            term_counts[i] += is_term;
+            nbor_counts[i] += !is_term;
+        });
+        if (info.has_problem || info.source || info.sink) {
+            throw std::runtime_error("Descriptors must precede all arcs in streamed DIMACS file: " + stream.fname);
+        }
+    });
+
+    // Subtract two as we don't add source and sink
+    stream.num_nodes = head.num_nodes - 2;
+    stream.num_term_arcs = prefix_offsets(term_counts).back();
+    stream.num_nbor_arcs = prefix_offsets(nbor_counts).back();
+    stream.source = head.source;
+    stream.sink = head.sink;
+    stream.arcs_begin = arcs - begin;
+}
+
+} // namespace dimacs_detail
+
+/**
+ * Open graph file for streaming. For DIMACS files this parses the whole file once, using num_threads threads (0 means
+ * one per core), to count the arcs. Visiting a DIMACS stream then parses the file twice more, once per arc kind.
+ * For binary BK files (any of the formats read by read_bbk_to_bk) only the header is read.
+ */
+template <class captype, class tcaptype>
+GraphStream<captype, tcaptype> open_graph_stream(const std::string& fname, GraphFormat format,
+    unsigned int num_threads = 0)
+{
+    GraphStream<captype, tcaptype> stream;
+    stream.fname = fname;
+    stream.format = format;
+    if (format == GRAPH_FORMAT_DIMACS) {
+        MappedFile file(fname, MAP_HINT_SEQUENTIAL);
+        dimacs_detail::scan_stream_header(file, stream, num_threads);
+        return stream;
+    }
+
+    std::fstream file(fname, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+    // All binary BK formats start with a three byte header, the type codes and the sizes
+    char header[3] = { 0 };
+    uint8_t types[2] = { TYPE_INVALID };
+    uint64_t sizes[3] = { 0 };
+    file.read(header, sizeof(header));
+    file.read((char *)types, sizeof(types));
+    file.read((char *)sizes, sizeof(sizes));
+    if (!file || (std::strncmp(header, "BBQ", 3) != 0 && std::strncmp(header, "bbq", 3) != 0 &&
+        std::strncmp(header, "bbc", 3) != 0 && std::strncmp(header, "bbp", 3) != 0)) {
+        throw std::runtime_error("Invalid file header for binary BK file.");
+    }
+    if (types[0] != type_code<captype>() || types[1] != type_code<tcaptype>()) {
+        throw std::runtime_error("Types for binary BK file do not match requested.");
+    }
+    stream.num_nodes = sizes[0];
+    stream.num_term_arcs = sizes[1];
+    stream.num_nbor_arcs = sizes[2];
+    return stream;
+}
+
+/**
+ * Stream binary BK file to visitor. Uncompressed and packed files are decoded straight from a mapping of the file.
+ * Chunked files are decompressed by up to num_threads threads (0 means one per core) a chunk at a time and compressed
+ * files one arc array at a time, so at most one of the arc arrays is held in memory.
+ */
+template <class captype, class tcaptype, class Visitor>
+void visit_bbk(const std::string& fname, Visitor& visitor, unsigned int num_threads = 0)
+{
+    std::fstream file(fname, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fname);
+    }
+    char header[3] = { 0 };
+    file.read(header, sizeof(header));
+
+    if (std::strncmp(header, "BBQ", 3) == 0) {
+        file.close();
+        auto view = map_bbk_to_view<captype, tcaptype>(fname, MAP_HINT_SEQUENTIAL);
+        visitor.on_problem(view.num_nodes, view.terminal_arcs.size(), view.neighbor_arcs.size());
+        for (const auto& tarc : view.terminal_arcs) {
+            visitor.on_terminal_arc(tarc);
+        }
+        for (const auto& narc : view.neighbor_arcs) {
+            visitor.on_neighbor_arc(narc);
+        }
+    } else if (std::strncmp(header, "bbc", 3) == 0) {
+        file.close();
+        stream_chunked_bbk<captype, tcaptype>(fname,
+            [&](uint64_t num_nodes, uint64_t num_term_arcs, uint64_t num_nbor_arcs) {
+                visitor.on_problem(num_nodes, num_term_arcs, num_nbor_arcs);
+            },
+            [&](const BkTermArc<tcaptype> *tarcs, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    visitor.on_terminal_arc(tarcs[i]);
+                }
+            },
+            [&](const BkNborArc<captype> *narcs, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    visitor.on_neighbor_arc(narcs[i]);
+                }
+            }, num_threads);
+    } else if (std::strncmp(header, "bbp", 3) == 0) {
+        file.close();
+        packed_detail::PackedBbk packed;
+        packed_detail::map_packed_bbk<captype, tcaptype>(fname, packed);
+        visitor.on_problem(packed.sizes[0], packed.sizes[1], packed.sizes[2]);
+        packed_detail::decode_terminal_arcs<tcaptype>(packed,
+            [&](const BkTermArc<tcaptype>& tarc) { visitor.on_terminal_arc(tarc); });
+        packed_detail::decode_neighbor_arcs<captype>(packed,
+            [&](const BkNborArc<captype>& narc) { visitor.on_neighbor_arc(narc); });
+    } else if (std::strncmp(header, "bbq", 3) == 0) {
+        uint8_t types[2] = { TYPE_INVALID };
+        uint64_t sizes[3] = { 0 };
+        file.read((char *)types, sizeof(types));
+        file.read((char *)sizes, sizeof(sizes));
+        if (types[0] != type_code<captype>() || types[1] != type_code<tcaptype>()) {
+            throw std::runtime_error("Types for binary BK file do not match requested.");
+        }
+        visitor.on_problem(sizes[0], sizes[1], sizes[2]);
+
+        std::string buffer;
+        {
+            std::vector<BkTermArc<tcaptype>> tarcs(sizes[1]);
+            read_and_decompress(tarcs.data(), file, buffer);
+            for (const auto& tarc : tarcs) {
+                visitor.on_terminal_arc(tarc);
+            }
+        }
+        std::vector<BkNborArc<captype>> narcs(sizes[2]);
+        read_and_decompress(narcs.data(), file, buffer);
+        for (const auto& narc : narcs) {
+            visitor.on_neighbor_arc(narc);
+        }
+    } else {
+        throw std::runtime_error("Invalid file header for binary BK file.");
+    }
+}
+
+/** Stream graph file opened with open_graph_stream to visitor. */
+template <class captype, class tcaptype, class Visitor>
+void visit_graph(const GraphStream<captype, tcaptype>& stream, Visitor&& visitor, unsigned int num_threads = 0)
+{
+    if (stream.format == GRAPH_FORMAT_BBK) {
+        visit_bbk<captype, tcaptype>(stream.fname, visitor, num_threads);
+        return;
+    }
+
+    // The file was already validated by open_graph_stream. Some builders need all terminal arcs before the first
+    // neighbor arc, so the arcs are parsed in two sequential passes: one for each kind.
+    MappedFile file(stream.fname, MAP_HINT_SEQUENTIAL);
+    visitor.on_problem(stream.num_nodes, stream.num_term_arcs, stream.num_nbor_arcs);
+    auto pass = [&](auto term_func, auto nbor_func) {
+        dimacs_detail::ChunkInfo info;
+        dimacs_detail::scan_chunk<captype>(file.data() + stream.arcs_begin, file.data() + file.size(), info,
+            [&](const DimacsArc<captype>& arc) {
+                dimacs_detail::split_arc<captype, tcaptype>(arc, stream.source, stream.sink, term_func, nbor_func);
+            });
+    };
+    pass([&](const BkTermArc<tcaptype>& tarc) { visitor.on_terminal_arc(tarc); }, [](const BkNborArc<captype>&) {});
+    pass([](const BkTermArc<tcaptype>&) {}, [&](const BkNborArc<captype>& narc) { visitor.on_neighbor_arc(narc); });
+}
+
+/** Visit the arcs of an in-memory graph, i.e. a BkGraph or BkGraphView, in the same way as a stream. */
+template <class Graph, class Visitor>
+void visit_graph(const Graph& graph, Visitor&& visitor)
+{
+    visitor.on_problem(graph.num_nodes, graph.terminal_arcs.size(), graph.neighbor_arcs.size());
+    for (const auto& tarc : graph.terminal_arcs) {
+        visitor.on_terminal_arc(tarc);
+    }
+    for (const auto& narc : graph.neighbor_arcs) {
+        visitor.on_neighbor_arc(narc);
+    }
+}
+
+/** Stream DIMACS file to visitor without building a BkGraph. See open_graph_stream and visit_graph. */
+template <class captype, class tcaptype, class Visitor>
+void visit_dimacs(const std::string& fname, Visitor& visitor, unsigned int num_threads = 0)
+{
+    visit_graph(open_graph_stream<captype, tcaptype>(fname, GRAPH_FORMAT_DIMACS, num_threads), visitor);
+}
+
+/** Number of terminal arcs in a graph, view or stream. */
+template <class Graph>
+uint64_t terminal_arc_count(const Graph& graph) { return graph.terminal_arcs.size(); }
+
+template <class captype, class tcaptype>
+uint64_t terminal_arc_count(const GraphStream<captype, tcaptype>& stream) { return stream.num_term_arcs; }
+
+/** Number of neighbor arcs in a graph, view or stream. */
+template <class Graph>
+uint64_t neighbor_arc_count(const Graph& graph) { return graph.neighbor_arcs.size(); }
+
+template <class captype, class tcaptype>
+uint64_t neighbor_arc_count(const GraphStream<captype, tcaptype>& stream) { return stream.num_nbor_arcs; }
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Binary QPBO
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -466,6 +1471,55 @@ BkQpbo<captype> read_bq_to_qpbo(const std::string fname)
     return bq;
 }
 
+/** QPBO backed directly by a memory mapped uncompressed binary QPBO file. See BkGraphView. */
+template <class captype>
+struct BkQpboView {
+    uint64_t num_nodes = 0;
+
+    UnalignedSpan<BkUnaryTerm<captype>> unary_terms;
+    UnalignedSpan<BkBinaryTerm<captype>> binary_terms;
+
+    MappedFile file;
+};
+
+/** Return true if fname starts with the header of an uncompressed binary QPBO file. */
+bool is_uncompressed_bq(const std::string& fname);
+
+/** Map uncompressed binary QPBO file. Throws if the file is compressed. */
+template <class captype>
+BkQpboView<captype> map_bq_to_view(const std::string& fname, MapHint hint = MAP_HINT_POPULATE)
+{
+    BkQpboView<captype> view;
+    view.file = MappedFile(fname, hint);
+    const char *data = view.file.data();
+    const size_t size = view.file.size();
+
+    // Same layout as read by read_bq_to_qpbo: header, type code and sizes
+    constexpr size_t header_size = 5 + 1 + 3 * sizeof(uint64_t);
+    if (size < header_size || (std::strncmp(data, "BQPBO", 5) != 0 && std::strncmp(data, "bqpbo", 5) != 0)) {
+        throw std::runtime_error("Invalid file header for binary QPBO file.");
+    }
+    if (std::islower(data[0])) {
+        throw std::runtime_error("Compressed binary QPBO files cannot be mapped: " + fname);
+    }
+    if (static_cast<uint8_t>(data[5]) != type_code<captype>()) {
+        throw std::runtime_error("Type for binary QPBO file do not match requested.");
+    }
+
+    uint64_t sizes[3];
+    std::memcpy(sizes, data + 6, sizeof(sizes));
+    const size_t unary_bytes = sizes[1] * sizeof(BkUnaryTerm<captype>);
+    const size_t binary_bytes = sizes[2] * sizeof(BkBinaryTerm<captype>);
+    if (size < header_size + unary_bytes + binary_bytes) {
+        throw std::runtime_error("Binary QPBO file is truncated: " + fname);
+    }
+
+    view.num_nodes = sizes[0];
+    view.unary_terms = UnalignedSpan<BkUnaryTerm<captype>>(data + header_size, sizes[1]);
+    view.binary_terms = UnalignedSpan<BkBinaryTerm<captype>>(data + header_size + unary_bytes, sizes[2]);
+    return view;
+}
+
 /** Write binary QPBO file */
 template <class captype>
 void write_bq_to_qpbo(const std::string fname, const BkQpbo<captype>& bq, bool compress = true)
@@ -534,9 +1588,10 @@ inline std::tuple<Cap, Cap, Cap, Cap> compute_normal_form_weights(Cap e00, Cap e
  *
  * This function is essentially equivalent to adding terms to a QPBO instance,
  * calling tranform_to_second_stage, and then reading out the resulting graph.
+ * Works for both BkQpbo and BkQpboView.
  */
-template <class Cap>
-BkGraph<Cap, Cap> qpbo_to_graph(const BkQpbo<Cap>& bq)
+template <class Cap, template <class> class Qpbo>
+BkGraph<Cap, Cap> qpbo_to_graph(const Qpbo<Cap>& bq)
 {
     BkGraph<Cap, Cap> bk;
     bk.num_nodes = bq.num_nodes * 2;
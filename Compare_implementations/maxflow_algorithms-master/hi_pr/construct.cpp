@@ -118,11 +118,24 @@ template<typename tcap> void HiPr::construct(unsigned int _nV, unsigned int _nE,
 	sink = n - 1;
 	m = _nE + _nV;//add s->v links or v->t links
 
-	nodes = (node*)calloc(n + 2, sizeof(node));
-	arcs = (arc*)calloc(2 * m + 1, sizeof(arc));
+	//AS: reuse the arrays of the last graph if this one fits
+	if (this->arcs != NULL && n + 2 <= nodeCap && m <= arcCap) {
+		nodes = this->nodes - nMin;
+		arcs = this->arcs;
+		acap = this->cap;
+		memset(nodes, 0, (n + 2) * sizeof(node));
+		memset(arcs, 0, (2 * m + 1) * sizeof(arc));
+		memset(acap, 0, 2 * m * sizeof(long));
+	} else {
+		destroy();
+		nodes = (node*)calloc(n + 2, sizeof(node));
+		arcs = (arc*)calloc(2 * m + 1, sizeof(arc));
+		acap = (cType*)calloc(2 * m, sizeof(long));
+		nodeCap = n + 2;
+		arcCap = m;
+	}
 	arc_tail = (unsigned long*)calloc(2 * m, sizeof(unsigned long));
 	arc_first = (unsigned long*)calloc(n + 2, sizeof(unsigned long));
-	acap = (cType*)calloc(2 * m, sizeof(long));
 
 	if (nodes == NULL || arcs == NULL ||
 		arc_first == NULL || arc_tail == NULL)
@@ -318,10 +331,21 @@ template void HiPr::construct<int>(unsigned int, unsigned int, const int *, cons
 
 void HiPr::destroy()
 {
-	free(nodes - nMin);
+	if (arcs != NULL) free(nodes - nMin);
 	free(arcs);
 	free(cap);
 	free(buckets);
+	nodes = NULL;
+	arcs = NULL;
+	cap = NULL;
+	buckets = NULL;
+	nMin = nodeCap = arcCap = 0;
+};
+
+void HiPr::reset()
+{
+	n = m = 0;
+	flow = flow0 = 0;
 };
 
 void inline HiPr::add_arc(unsigned int tail, unsigned int head, cType cap1, cType cap2, unsigned long *& arc_first, unsigned long *& arc_tail, unsigned long & pos_current, arc *& arc_current, node *& nodes, unsigned long & node_min, unsigned long & node_max, unsigned long & no_alines)
@@ -103,6 +103,7 @@ operations iAdd, iDelete (from arbitrary position)
 namespace hi_pr {
 
 HiPr::HiPr()
+	: nMin(0), nodeCap(0), arcCap(0), nodes(NULL), arcs(NULL), buckets(NULL), cap(NULL)
 {};
 
 int HiPr::allocDS()
@@ -116,7 +117,13 @@ int HiPr::allocDS()
 	qLast = queue + n - 1;
 	qInit();
 	*/
-	buckets = (bucket*)calloc(n + 2, sizeof(bucket));
+	//AS: buckets of a reset graph are reused, construct has checked that they fit
+	if (buckets != NULL && n + 2 <= nodeCap) {
+		memset(buckets, 0, (n + 2) * sizeof(bucket));
+	} else {
+		free(buckets);
+		buckets = (bucket*)calloc(n + 2, sizeof(bucket));
+	}
 	if (buckets == NULL) return (1);
 
 	sentinelNode = nodes + n;
@@ -130,6 +137,7 @@ int HiPr::allocDS()
 void HiPr::init()
 
 {
+	TRACE_PHASE(INIT);
 	node  *i;        /* current node */
 	int overflowDetected;
 	bucket *l;
@@ -141,6 +149,8 @@ void HiPr::init()
 	unsigned long delta;
 #endif
 
+	pushCnt = relabelCnt = updateCnt = gapCnt = gNodeCnt = 0;
+
 	// initialize excesses
 
 	forAllNodes(i)
@@ -240,6 +250,7 @@ void HiPr::checkMax()
 void HiPr::globalUpdate()
 
 {
+	TRACE_PHASE(GLOBAL_RELABEL);
 
 	node  *i, *j;       /* node pointers */
 	arc   *a;           /* current arc pointers  */
@@ -506,6 +517,7 @@ buckets[i-nodes]->firstActive is used for DSF tree
 //
 int HiPr::gap(bucket *emptyB)
 {
+	TRACE_PHASE(GAP);
 
 	bucket *l;
 	node  *i;
@@ -594,6 +606,7 @@ unsigned long HiPr::relabel(node *i)
 
 void HiPr::discharge(node  *i)
 {
+	TRACE_PHASE(DISCHARGE);
 
 	node  *j;                 /* sucsessor of i */
 	unsigned long  jD;                 /* d of the next bucket */
@@ -687,6 +700,7 @@ void HiPr::wave()
 void HiPr::stageOne()
 
 {
+	TRACE_PHASE(SOLVE);
 
 	node   *i;
 	bucket  *l;             /* current bucket */
@@ -901,6 +915,24 @@ bool HiPr::is_weak_source(node * v)
 	return v->d >= n;
 };
 
+void HiPr::get_cut(std::vector<uint8_t>& cut) const
+{
+	cut.resize(n);
+	for (unsigned long i = 0; i < n; i++) {
+		cut[i] = nodes[i].d >= n ? 1 : 0;
+	}
+}
+
+OpStats HiPr::get_op_stats() const
+{
+	OpStats stats;
+	stats.pushes = pushCnt;
+	stats.relabels = relabelCnt;
+	stats.global_updates = updateCnt;
+	stats.gaps = gapCnt;
+	return stats;
+}
+
 long long HiPr::cut_cost()
 {
 	long long cost = flow;
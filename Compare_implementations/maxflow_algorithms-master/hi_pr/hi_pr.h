@@ -16,10 +16,13 @@
 #include <string.h>
 #include <assert.h>
 #include <stdint.h>
+#include <vector>
 
 #include "values.h"
 #include "types.h"          /* type definitions */
 #include "timer.h"          /* timing routine */
+#include "../op_stats.h"
+#include "../phase_trace.h"
 
 #define GLOB_UPDT_FREQ 0.5 //default value
 #define WAVE_INIT
@@ -37,6 +40,8 @@ public:
 	unsigned long   m;                    /* number of arcs */
 	unsigned long   nm;                   /* n + ALPHA * m */
 	unsigned long   nMin;                 /* smallest node id */
+	unsigned long   nodeCap;              /* size of the node array allocated by construct */
+	unsigned long   arcCap;               /* number of arcs m the arc arrays of construct have room for */
 	node   *nodes;               /* array of nodes */
 	arc    *arcs;                /* array of arcs */
 	bucket *buckets;             /* array of buckets */
@@ -74,6 +79,8 @@ public:
 	long long cut_cost();
 	int main(int argc, char *argv[]);
 	bool is_weak_source(node * v);
+	void get_cut(std::vector<uint8_t>& cut) const;/*!< is_weak_source for all nodes, 1 for the source side */
+	OpStats get_op_stats() const;/*!< the counters above as OpStats, they are always on */
 public:
 	template<typename tcap>
 	void construct(unsigned int nV, unsigned int nE, const int * E, const tcap * cap, const tcap * excess);
@@ -83,6 +90,7 @@ public:
 		destroy();
 	};
 	void destroy();
+	void reset();/*!< empties the graph, construct reuses the arrays if the next graph has at most as many nodes and arcs */
 private:
 	/*!
 	parse (...) :
@@ -53,6 +53,7 @@ If you require another license, please contact the above.
 #include <stdio.h>
 #include <string.h>
 #include <cstdint>
+#include <vector>
 
 #if defined(_MSC_VER)
 #include <BaseTsd.h>
@@ -154,7 +155,9 @@ public:
 		verbose = a_verbose;
 	}
 	void initSize(int64_t numNodes, int64_t numEdges);
-	void reset();
+	// Empties the graph for numNodes nodes and numEdges edges, which must not be more than given to initSize.
+	// The arrays allocated by initSize are reused.
+	void reset(int64_t numNodes, int64_t numEdges);
 	void addEdge(int64_t nodeIndexFrom, int64_t nodeIndexTo, captype capacity, captype reverseCapacity);
 	void addNode(int64_t nodeIndex, tcaptype capFromSource, tcaptype capToSink);
 	void incEdge(int64_t nodeIndexFrom, int64_t nodeIndexTo, captype capacity, captype reverseCapacity);
@@ -191,6 +194,12 @@ public:
 		return arcEnd - arcs;
 	}
 	int isNodeOnSrcSide(int64_t nodeIndex, int freeNodeValue = 0);
+	// Side of nodes in neither tree after computeMaxFlow. The tree which stopped growing is complete, so
+	// free nodes are on the side of the other one.
+	inline int freeNodeSide() const { return activeS1.len == 0 ? 0 : 1; }
+	// Same as isNodeOnSrcSide for all nodes, with free nodes on freeNodeSide(): cut[i] = 1 if node i is on
+	// the source side and 0 otherwise
+	void getCut(std::vector<uint8_t>& cut) const;
 
 
 	struct Node;
@@ -834,6 +843,16 @@ inline int IBFSGraph<captype, tcaptype, flowtype>::isNodeOnSrcSide(int64_t nodeI
 	return (nodes[nodeIndex].label > 0 ? 1 : 0);
 }
 
+template <typename captype, typename tcaptype, typename flowtype>
+inline void IBFSGraph<captype, tcaptype, flowtype>::getCut(std::vector<uint8_t>& cut) const
+{
+	const uint8_t freeValue = freeNodeSide();
+	cut.resize(nodeEnd - nodes);
+	for (const Node *x = nodes; x != nodeEnd; x++) {
+		cut[x - nodes] = x->label == 0 ? freeValue : (x->label > 0 ? 1 : 0);
+	}
+}
+
 
 #define REMOVE_SIBLING(x, tmp) \
 	{ (tmp) = (x)->parent->head->firstSon; \
@@ -970,9 +989,9 @@ inline void IBFSGraph<captype, tcaptype, flowtype>::initSize(int64_t numNodes, i
 	}
 }
 template <typename captype, typename tcaptype, typename flowtype>
-inline  void IBFSGraph<captype, tcaptype, flowtype>::reset()
+inline  void IBFSGraph<captype, tcaptype, flowtype>::reset(int64_t numNodes, int64_t numEdges)
 {
-	// compute allocation size
+	// compute allocation size of initSize
 	uint64_t arcTmpMemsize = (uint64_t)sizeof(TmpEdge) * (uint64_t)init_n_edges;
 	uint64_t arcRealMemsize = (uint64_t)sizeof(Arc) * (uint64_t)(init_n_edges * 2);
 	uint64_t nodeMemsize = (uint64_t)sizeof(Node**) * (uint64_t)(init_n_nodes * 3) +
@@ -988,49 +1007,46 @@ inline  void IBFSGraph<captype, tcaptype, flowtype>::reset()
 		arcMemsize = (arcRealMemsize + nodeMemsize);
 	}
 
-	// alocate arcs
-	if (verbose) {
-		fprintf(stdout, "c allocating arcs... \t [%lu MB]\n", (uint64_t)arcMemsize / (1 << 20));
-		fflush(stdout);
-	}
+	// lay out the arcs for the new size, all parts shrink with it
+	arcRealMemsize = (uint64_t)sizeof(Arc) * (uint64_t)(numEdges * 2);
 	memset(memArcs, 0, (uint64_t)sizeof(char) * arcMemsize);
 	if (initMode == IB_INIT_FAST) {
 		tmpEdges = (TmpEdge*)(memArcs + arcRealMemsize);
 	} else if (initMode == IB_INIT_COMPACT) {
 		tmpEdges = (TmpEdge*)(memArcs);
-		tmpArcs = (TmpArc*)(memArcs + arcMemsize - (uint64_t)sizeof(TmpArc) * (uint64_t)(init_n_edges * 2));
+		tmpArcs = (TmpArc*)(memArcs + arcMemsize - (uint64_t)sizeof(TmpArc) * (uint64_t)(numEdges * 2));
 	}
 	tmpEdgeLast = tmpEdges; // will advance as edges are added
 	arcs = (Arc*)memArcs;
-	arcEnd = arcs + init_n_edges * 2;
+	arcEnd = arcs + numEdges * 2;
 
-	// allocate nodes
-	//	if (verbose) {
-	//		fprintf(stdout, "c allocating nodes... \t [%lu MB]\n", (unsigned long)sizeof(Node)*(unsigned long)(init_n_nodes+1) / (1<<20));
-	//		fflush(stdout);
-	//	}
-	this->init_n_nodes = init_n_nodes;
-	//nodes = new Node[init_n_nodes + 1];
-	memset(nodes, 0, sizeof(Node) * (init_n_nodes + 1));
-	nodeEnd = nodes + init_n_nodes;
+	// nodes
+	this->numNodes = numNodes;
+	memset(nodes, 0, sizeof(Node) * (numNodes + 1));
+	nodeEnd = nodes + numNodes;
 	active0.init((Node**)(arcEnd));
-	activeS1.init((Node**)(arcEnd)+init_n_nodes);
-	activeT1.init((Node**)(arcEnd)+(2 * init_n_nodes));
+	activeS1.init((Node**)(arcEnd)+numNodes);
+	activeT1.init((Node**)(arcEnd)+(2 * numNodes));
+	// The bucket arrays are sized by allocate for the levels of the last graph, so they are allocated again
 	if (IB_EXCESSES) {
-		ptrs = (Node**)(arcEnd)+(3 * init_n_nodes);
-		excessBuckets.init_NoAlloc(nodes, ptrs, init_n_nodes);
+		ptrs = (Node**)(arcEnd)+(3 * numNodes);
+		excessBuckets.free();
+		excessBuckets.init(nodes, ptrs, numNodes);
 	}
-	orphan3PassBuckets.init_NoAlloc(nodes, init_n_nodes);
-	orphanBuckets.init_NoAlloc(nodes, init_n_nodes);
+	orphan3PassBuckets.free();
+	orphan3PassBuckets.init(nodes, numNodes);
+	orphanBuckets.free();
+	orphanBuckets.init(nodes, numNodes);
 
-	// init members
+	// init members like the constructor
+	arcIter = NULL;
+	incLen = incIteration = 0;
+	uniqOrphansS = uniqOrphansT = 0;
+	augTimestamp = 0;
+	topLevelS = topLevelT = 0;
 	flow = 0;
-
-	if (verbose) {
-		fprintf(stdout, "c sizeof(ptr) = %d bytes\n", (int)sizeof(Node*));
-		fprintf(stdout, "c sizeof(node) = %d bytes\n", (int)sizeof(Node));
-		fprintf(stdout, "c sizeof(arc) = %d bytes\n", (int)sizeof(Arc));
-	}
+	testFlow = 0;
+	testExcess = 0;
 }
 template <typename captype, typename tcaptype, typename flowtype>
 inline void IBFSGraph<captype, tcaptype, flowtype>::initNodes()
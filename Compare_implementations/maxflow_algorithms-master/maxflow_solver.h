@@ -0,0 +1,682 @@
+#ifndef MAXFLOW_SOLVER_H__
+#define MAXFLOW_SOLVER_H__
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "graph_io.h"
+
+#include "bk/graph.h"
+#include "nbk/graph.h"
+#include "reimpls/mbk.h"
+#include "reimpls/mbk_r.h"
+#include "reimpls/eibfs_i.h"
+#include "reimpls/eibfs_i_nr.h"
+#include "reimpls/hpf.h"
+#include "ibfs/ibfs.h"
+#include "hi_pr/hi_pr.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Solver interface
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Wall clock time in seconds spent in each phase of the last build, solve and get_cut. */
+struct SolverTimings {
+    double build_time = 0;
+    double solve_time = 0;
+    double extract_time = 0;
+};
+
+/**
+ * Common interface for all serial max-flow solvers, so a solver can be chosen by name at runtime. Typical use:
+ *
+ *   auto solver = SolverRegistry<int, int, int64_t>::instance().create("mbk_r");
+ *   solver->build(bkg);
+ *   int64_t flow = solver->solve();
+ *   solver->get_cut(labels);
+ *
+ * Graphs are given in BK form, i.e. anything visit_graph accepts: a BkGraph, a BkGraphView or a GraphStream.
+ * A solver can be rebuilt with a new graph after solving. The BK style solvers then reuse their memory.
+ */
+template <class Cap, class Term, class Flow>
+class MaxflowSolver {
+public:
+    virtual ~MaxflowSolver() = default;
+
+    /** Name the solver is registered under. */
+    virtual const char *name() const = 0;
+
+    /** Build the solver graph, replacing any previous one. */
+    template <class Graph>
+    void build(const Graph& graph)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        num_nodes_ = 0;
+        solved_ = false;
+        visit_graph(graph, make_visitor(
+            [this](uint64_t num_nodes, uint64_t num_term_arcs, uint64_t num_nbor_arcs) {
+                num_nodes_ = num_nodes;
+                init_graph(num_nodes, num_term_arcs, num_nbor_arcs);
+            },
+            [this](const BkTermArc<Term>& tarc) { add_terminal_arc(tarc); },
+            [this](const BkNborArc<Cap>& narc) { add_neighbor_arc(narc); }));
+        finish_graph();
+        timings_.build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    /** Compute the maximum flow of the built graph. */
+    Flow solve()
+    {
+        auto begin = std::chrono::steady_clock::now();
+        flow_ = compute_maxflow();
+        solved_ = true;
+        timings_.solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return flow_;
+    }
+
+    /** Flow value found by the last call to solve. */
+    Flow flow() const
+    {
+        return flow_;
+    }
+
+    /** Store the minimum cut in cut, with cut[i] = 1 if node i is on the source side and 0 otherwise. */
+    void get_cut(std::vector<uint8_t>& cut)
+    {
+        if (!solved_) {
+            throw std::logic_error("Cannot get cut before the graph is solved.");
+        }
+        auto begin = std::chrono::steady_clock::now();
+        extract_cut(cut);
+        timings_.extract_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    const SolverTimings& timings() const
+    {
+        return timings_;
+    }
+
+    uint64_t num_nodes() const
+    {
+        return num_nodes_;
+    }
+
+protected:
+    /** Allocate the graph. Called before any arcs are added. */
+    virtual void init_graph(uint64_t num_nodes, uint64_t num_term_arcs, uint64_t num_nbor_arcs) = 0;
+    virtual void add_terminal_arc(const BkTermArc<Term>& tarc) = 0;
+    virtual void add_neighbor_arc(const BkNborArc<Cap>& narc) = 0;
+    /** Called after all arcs are added. */
+    virtual void finish_graph() {}
+    virtual Flow compute_maxflow() = 0;
+    /** Store the cut for get_cut. Uses the bulk cut function of the wrapped solver, so it is one pass over the nodes. */
+    virtual void extract_cut(std::vector<uint8_t>& cut) const = 0;
+
+private:
+    uint64_t num_nodes_ = 0;
+    Flow flow_ = 0;
+    bool solved_ = false;
+    SolverTimings timings_;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Adapters
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace solver_detail {
+
+/** Adapter for the BK style graphs: bk::Graph, nbk::Graph, reimpls::Graph and reimpls::Graph2. */
+template <class Cap, class Term, class Flow, class Graph>
+class BkStyleSolver : public MaxflowSolver<Cap, Term, Flow> {
+public:
+    explicit BkStyleSolver(const char *name) : name_(name) {}
+
+    const char *name() const override { return name_; }
+
+protected:
+    void init_graph(uint64_t num_nodes, uint64_t /*num_term_arcs*/, uint64_t num_nbor_arcs) override
+    {
+        if (graph_) {
+            // Rebuilding, so keep the node and arc arrays of the last graph
+            graph_->reset();
+        } else {
+            graph_ = std::make_unique<Graph>(num_nodes, num_nbor_arcs);
+        }
+        graph_->add_node(num_nodes);
+    }
+
+    void add_terminal_arc(const BkTermArc<Term>& tarc) override
+    {
+        graph_->add_tweights(tarc.node, tarc.source_cap, tarc.sink_cap);
+    }
+
+    void add_neighbor_arc(const BkNborArc<Cap>& narc) override
+    {
+        if constexpr (has_merge_flag) {
+            graph_->add_edge(narc.i, narc.j, narc.cap, narc.rev_cap, false);
+        } else {
+            graph_->add_edge(narc.i, narc.j, narc.cap, narc.rev_cap);
+        }
+    }
+
+    void finish_graph() override
+    {
+        if constexpr (std::is_same<Graph, reimpls::Graph2<Cap, Term, Flow, uint32_t, uint32_t>>::value) {
+            graph_->init_maxflow();
+        }
+    }
+
+    Flow compute_maxflow() override { return graph_->maxflow(); }
+
+    void extract_cut(std::vector<uint8_t>& cut) const override { graph_->get_cut(cut); }
+
+private:
+    // The reimplementations take a flag for merging duplicate edges, which is not needed for BK graphs
+    static constexpr bool has_merge_flag =
+        std::is_same<Graph, reimpls::Graph<Cap, Term, Flow, uint32_t, uint32_t>>::value ||
+        std::is_same<Graph, reimpls::Graph2<Cap, Term, Flow, uint32_t, uint32_t>>::value;
+
+    const char *name_;
+    std::unique_ptr<Graph> graph_;
+};
+
+/** Adapter for the incremental breadth first search graphs: reimpls::IBFSGraph, reimpls::IBFSGraph2 and ibfs. */
+template <class Cap, class Term, class Flow, class Graph>
+class IbfsSolver : public MaxflowSolver<Cap, Term, Flow> {
+public:
+    explicit IbfsSolver(const char *name) : name_(name) {}
+
+    const char *name() const override { return name_; }
+
+protected:
+    void init_graph(uint64_t num_nodes, uint64_t /*num_term_arcs*/, uint64_t num_nbor_arcs) override
+    {
+        if (graph_ && num_nodes <= alloc_nodes_ && num_nbor_arcs <= alloc_arcs_) {
+            // Rebuilding a graph which fits, so keep the node and arc arrays of the last graph
+            graph_->reset(num_nodes, num_nbor_arcs);
+            return;
+        }
+        if constexpr (std::is_same<Graph, ibfs::IBFSGraph<Cap, Term, Flow>>::value) {
+            graph_ = std::make_unique<Graph>(Graph::IB_INIT_FAST);
+            graph_->initSize(num_nodes, num_nbor_arcs);
+        } else {
+            graph_ = std::make_unique<Graph>(num_nodes, num_nbor_arcs);
+        }
+        alloc_nodes_ = num_nodes;
+        alloc_arcs_ = num_nbor_arcs;
+    }
+
+    void add_terminal_arc(const BkTermArc<Term>& tarc) override
+    {
+        graph_->addNode(tarc.node, tarc.source_cap, tarc.sink_cap);
+    }
+
+    void add_neighbor_arc(const BkNborArc<Cap>& narc) override
+    {
+        graph_->addEdge(narc.i, narc.j, narc.cap, narc.rev_cap);
+    }
+
+    void finish_graph() override { graph_->initGraph(); }
+
+    Flow compute_maxflow() override { return graph_->computeMaxFlow(); }
+
+    void extract_cut(std::vector<uint8_t>& cut) const override { graph_->getCut(cut); }
+
+private:
+    const char *name_;
+    std::unique_ptr<Graph> graph_;
+    // Sizes graph_ was allocated for
+    uint64_t alloc_nodes_ = 0;
+    uint64_t alloc_arcs_ = 0;
+};
+
+/** Adapter for HPF. Source and sink are nodes 0 and 1, so all other nodes are shifted by two. */
+template <class Cap, class Term, class Flow, reimpls::LabelOrder LO, reimpls::RootOrder RO>
+class HpfSolver : public MaxflowSolver<Cap, Term, Flow> {
+public:
+    using Graph = reimpls::Hpf<Cap, LO, RO>;
+
+    explicit HpfSolver(const char *name) : name_(name) {}
+
+    const char *name() const override { return name_; }
+
+protected:
+    void init_graph(uint64_t num_nodes, uint64_t num_term_arcs, uint64_t num_nbor_arcs) override
+    {
+        if (graph_ && num_nodes <= alloc_nodes_ && num_nbor_arcs + num_term_arcs <= alloc_arcs_) {
+            // Rebuilding a graph which fits, so keep the node and arc arrays of the last graph
+            graph_->reset();
+        } else {
+            graph_ = std::make_unique<Graph>(num_nodes + 2, num_nbor_arcs + num_term_arcs);
+            alloc_nodes_ = num_nodes;
+            alloc_arcs_ = num_nbor_arcs + num_term_arcs;
+        }
+        graph_->set_source(0);
+        graph_->set_sink(1);
+        graph_->add_node(num_nodes + 2);
+    }
+
+    void add_terminal_arc(const BkTermArc<Term>& tarc) override
+    {
+        graph_->add_edge(0, tarc.node + 2, tarc.source_cap);
+        graph_->add_edge(tarc.node + 2, 1, tarc.sink_cap);
+    }
+
+    void add_neighbor_arc(const BkNborArc<Cap>& narc) override
+    {
+        if (narc.cap) {
+            graph_->add_edge(narc.i + 2, narc.j + 2, narc.cap);
+        }
+        if (narc.rev_cap) {
+            graph_->add_edge(narc.j + 2, narc.i + 2, narc.rev_cap);
+        }
+    }
+
+    Flow compute_maxflow() override
+    {
+        graph_->mincut();
+        return graph_->compute_maxflow();
+    }
+
+    void extract_cut(std::vector<uint8_t>& cut) const override
+    {
+        graph_->get_cut(cut);
+        cut.erase(cut.begin(), cut.begin() + 2);
+    }
+
+private:
+    const char *name_;
+    std::unique_ptr<Graph> graph_;
+    // Sizes graph_ was allocated for
+    uint64_t alloc_nodes_ = 0;
+    uint64_t alloc_arcs_ = 0;
+};
+
+/**
+ * Adapter for HI_PR. HI_PR is built from complete arrays, so arcs are collected during the build and the graph is
+ * constructed in finish_graph. Only int capacities are supported by the HI_PR library.
+ */
+template <class Cap, class Term, class Flow>
+class HiPrSolver : public MaxflowSolver<Cap, Term, Flow> {
+public:
+    const char *name() const override { return "hi_pr"; }
+
+protected:
+    void init_graph(uint64_t num_nodes, uint64_t /*num_term_arcs*/, uint64_t num_nbor_arcs) override
+    {
+        if (graph_ && num_nodes <= alloc_nodes_ && num_nbor_arcs <= alloc_arcs_) {
+            // Rebuilding a graph which fits, construct then reuses the arrays of the last graph
+            graph_->reset();
+        } else {
+            graph_ = std::make_unique<hi_pr::HiPr>();
+            alloc_nodes_ = num_nodes;
+            alloc_arcs_ = num_nbor_arcs;
+        }
+        num_nodes_ = num_nodes;
+        endpoints_.clear();
+        capacities_.clear();
+        endpoints_.reserve(2 * num_nbor_arcs);
+        capacities_.reserve(2 * num_nbor_arcs);
+        source_caps_.assign(num_nodes, 0);
+        sink_caps_.assign(num_nodes, 0);
+    }
+
+    void add_terminal_arc(const BkTermArc<Term>& tarc) override
+    {
+        // A node may have several terminal arcs, e.g. one for each terminal in DIMACS files
+        source_caps_[tarc.node] += tarc.source_cap;
+        sink_caps_[tarc.node] += tarc.sink_cap;
+    }
+
+    void add_neighbor_arc(const BkNborArc<Cap>& narc) override
+    {
+        endpoints_.push_back(narc.i);
+        endpoints_.push_back(narc.j);
+        capacities_.push_back(narc.cap);
+        capacities_.push_back(narc.rev_cap);
+    }
+
+    void finish_graph() override
+    {
+        // HI_PR only takes the net excess of each node, so flow going straight from source to sink through a node
+        // is added to the result separately
+        std::vector<int> excesses(num_nodes_);
+        terminal_flow_ = 0;
+        for (uint64_t i = 0; i < num_nodes_; ++i) {
+            excesses[i] = source_caps_[i] - sink_caps_[i];
+            terminal_flow_ += std::min(source_caps_[i], sink_caps_[i]);
+        }
+        graph_->construct(num_nodes_, capacities_.size() / 2, endpoints_.data(), capacities_.data(),
+            excesses.data());
+        endpoints_ = std::vector<int>();
+        capacities_ = std::vector<int>();
+        source_caps_ = std::vector<Term>();
+        sink_caps_ = std::vector<Term>();
+    }
+
+    Flow compute_maxflow() override
+    {
+        graph_->stageOne();
+        return terminal_flow_ + graph_->flow - graph_->flow0;
+    }
+
+    // After stage one, nodes which cannot reach the sink have a label of at least n. The explicit source and sink
+    // nodes come last and are dropped.
+    void extract_cut(std::vector<uint8_t>& cut) const override
+    {
+        graph_->get_cut(cut);
+        cut.resize(num_nodes_);
+    }
+
+private:
+    std::unique_ptr<hi_pr::HiPr> graph_;
+    // Sizes graph_ was allocated for
+    uint64_t alloc_nodes_ = 0;
+    uint64_t alloc_arcs_ = 0;
+    uint64_t num_nodes_ = 0;
+    Flow terminal_flow_ = 0;
+    std::vector<int> endpoints_; // [from, to, from, to, ...]
+    std::vector<int> capacities_; // [cap, rev_cap, cap, rev_cap, ...]
+    std::vector<Term> source_caps_;
+    std::vector<Term> sink_caps_;
+};
+
+} // namespace solver_detail
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Registry
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Maps solver names to factories. instance() comes with all serial solvers of this repository registered under the
+ * names used by bench (bk, nbk, mbk, mbk_r, eibfs, eibfs_i, eibfs_i_nr, hpf, hpf_hf, hpf_hl, hpf_lf, hpf_ll and,
+ * for int capacities, hi_pr). Further solvers can be added with add.
+ */
+template <class Cap, class Term, class Flow>
+class SolverRegistry {
+public:
+    using Solver = MaxflowSolver<Cap, Term, Flow>;
+    using Factory = std::function<std::unique_ptr<Solver>()>;
+
+    static SolverRegistry& instance()
+    {
+        static SolverRegistry registry = with_default_solvers();
+        return registry;
+    }
+
+    /** Register factory under name, replacing any solver already registered with that name. */
+    void add(const std::string& name, Factory factory)
+    {
+        factories_[name] = std::move(factory);
+    }
+
+    bool contains(const std::string& name) const
+    {
+        return factories_.count(name) != 0;
+    }
+
+    std::unique_ptr<Solver> create(const std::string& name) const
+    {
+        auto it = factories_.find(name);
+        if (it == factories_.end()) {
+            throw std::invalid_argument("Unknown solver: " + name);
+        }
+        return it->second();
+    }
+
+    /** Names of all registered solvers in alphabetical order. */
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> out;
+        for (const auto& f : factories_) {
+            out.push_back(f.first);
+        }
+        return out;
+    }
+
+private:
+    static SolverRegistry with_default_solvers()
+    {
+        using namespace solver_detail;
+        using reimpls::LabelOrder;
+        using reimpls::RootOrder;
+
+        SolverRegistry r;
+        r.add_adapter<BkStyleSolver<Cap, Term, Flow, bk::Graph<Cap, Term, Flow>>>("bk");
+        r.add_adapter<BkStyleSolver<Cap, Term, Flow, nbk::Graph<Cap, Term, Flow>>>("nbk");
+        r.add_adapter<BkStyleSolver<Cap, Term, Flow, reimpls::Graph<Cap, Term, Flow, uint32_t, uint32_t>>>("mbk");
+        r.add_adapter<BkStyleSolver<Cap, Term, Flow, reimpls::Graph2<Cap, Term, Flow, uint32_t, uint32_t>>>("mbk_r");
+        r.add_adapter<IbfsSolver<Cap, Term, Flow, reimpls::IBFSGraph<Cap, Term, Flow, uint32_t, uint32_t>>>("eibfs_i");
+        r.add_adapter<IbfsSolver<Cap, Term, Flow, reimpls::IBFSGraph2<Cap, Term, Flow>>>("eibfs_i_nr");
+        r.add_adapter<IbfsSolver<Cap, Term, Flow, ibfs::IBFSGraph<Cap, Term, Flow>>>("eibfs");
+        r.add_adapter<HpfSolver<Cap, Term, Flow, LabelOrder::HIGHEST_FIRST, RootOrder::FIFO>>("hpf");
+        r.add_adapter<HpfSolver<Cap, Term, Flow, LabelOrder::HIGHEST_FIRST, RootOrder::FIFO>>("hpf_hf");
+        r.add_adapter<HpfSolver<Cap, Term, Flow, LabelOrder::HIGHEST_FIRST, RootOrder::LIFO>>("hpf_hl");
+        r.add_adapter<HpfSolver<Cap, Term, Flow, LabelOrder::LOWEST_FIRST, RootOrder::FIFO>>("hpf_lf");
+        r.add_adapter<HpfSolver<Cap, Term, Flow, LabelOrder::LOWEST_FIRST, RootOrder::LIFO>>("hpf_ll");
+        if constexpr (std::is_same<Cap, int>::value && std::is_same<Term, int>::value) {
+            r.add("hi_pr", []() { return std::unique_ptr<Solver>(new HiPrSolver<Cap, Term, Flow>()); });
+        }
+        return r;
+    }
+
+    template <class Adapter>
+    void add_adapter(const char *name)
+    {
+        add(name, [name]() { return std::unique_ptr<Solver>(new Adapter(name)); });
+    }
+
+    std::map<std::string, Factory> factories_;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Automatic selection
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Cheap structural features of a graph. See compute_graph_features. */
+struct GraphFeatures {
+    uint64_t num_nodes = 0;
+    uint64_t num_term_arcs = 0;
+    uint64_t num_nbor_arcs = 0;
+
+    double avg_degree = 0.0; // Neighbor arcs per node, counting both ends of each arc
+    uint64_t max_degree = 0;
+    double degree_cv = 0.0; // Coefficient of variation (stddev / mean) of the node degrees
+    double terminal_ratio = 0.0; // Fraction of nodes with a non-zero terminal capacity
+
+    bool is_grid = false;
+    double locality = 0.0; // Median index offset |j - i| of the neighbor arcs relative to the number of nodes
+
+    double min_cap = 0.0; // Smallest and largest non-zero capacity of any arc
+    double max_cap = 0.0;
+
+    double cap_range() const { return min_cap > 0.0 ? max_cap / min_cap : 0.0; }
+};
+
+namespace solver_detail {
+
+// Number of neighbor arcs sampled for grid detection
+constexpr size_t GRID_SAMPLE_SIZE = 1 << 16;
+
+/**
+ * Grids store their arcs with a handful of fixed index offsets (1 and width for a 4-connected 2D grid, 1, width
+ * and width * height for 3D, etc.), so a graph is taken to be a grid if four offsets cover nearly all sampled arcs.
+ */
+inline bool looks_like_grid(const std::map<uint64_t, size_t>& offsets, size_t num_sampled, uint64_t max_degree)
+{
+    if (num_sampled == 0 || max_degree > 26) {
+        return false;
+    }
+    std::vector<size_t> counts;
+    for (const auto& o : offsets) {
+        counts.push_back(o.second);
+    }
+    std::sort(counts.begin(), counts.end(), std::greater<size_t>());
+    size_t covered = 0;
+    for (size_t i = 0; i < std::min<size_t>(4, counts.size()); ++i) {
+        covered += counts[i];
+    }
+    return covered >= 0.95 * num_sampled;
+}
+
+inline uint64_t median_offset(const std::map<uint64_t, size_t>& offsets, size_t num_sampled)
+{
+    size_t seen = 0;
+    for (const auto& o : offsets) {
+        seen += o.second;
+        if (2 * seen >= num_sampled) {
+            return o.first;
+        }
+    }
+    return 0;
+}
+
+} // namespace solver_detail
+
+/**
+ * Compute the features of graph, which may be anything visit_graph accepts, in a single pass over its arcs. If
+ * known_grid is false, grid structure is detected from the index offsets of the neighbor arcs.
+ */
+template <class Graph>
+GraphFeatures compute_graph_features(const Graph& graph, bool known_grid = false)
+{
+    GraphFeatures f;
+    std::vector<uint32_t> degrees;
+    std::vector<uint8_t> has_terminal;
+    std::map<uint64_t, size_t> offsets;
+    size_t num_sampled = 0;
+    double min_cap = std::numeric_limits<double>::infinity();
+    double max_cap = 0.0;
+    auto add_cap = [&](double cap) {
+        cap = std::abs(cap);
+        if (cap > 0.0) {
+            min_cap = std::min(min_cap, cap);
+            max_cap = std::max(max_cap, cap);
+        }
+    };
+
+    visit_graph(graph, make_visitor(
+        [&](uint64_t num_nodes, uint64_t num_term_arcs, uint64_t num_nbor_arcs) {
+            f.num_nodes = num_nodes;
+            f.num_term_arcs = num_term_arcs;
+            f.num_nbor_arcs = num_nbor_arcs;
+            degrees.assign(num_nodes, 0);
+            has_terminal.assign(num_nodes, 0);
+        },
+        [&](const auto& tarc) {
+            add_cap(tarc.source_cap);
+            add_cap(tarc.sink_cap);
+            if (tarc.source_cap != 0 || tarc.sink_cap != 0) {
+                has_terminal[tarc.node] = 1;
+            }
+        },
+        [&](const auto& narc) {
+            add_cap(narc.cap);
+            add_cap(narc.rev_cap);
+            degrees[narc.i]++;
+            degrees[narc.j]++;
+            if (num_sampled < solver_detail::GRID_SAMPLE_SIZE) {
+                offsets[narc.i < narc.j ? narc.j - narc.i : narc.i - narc.j]++;
+                num_sampled++;
+            }
+        }));
+
+    if (f.num_nodes > 0) {
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        uint64_t num_terminal = 0;
+        for (uint64_t i = 0; i < f.num_nodes; ++i) {
+            sum += degrees[i];
+            sum_sq += double(degrees[i]) * degrees[i];
+            f.max_degree = std::max<uint64_t>(f.max_degree, degrees[i]);
+            num_terminal += has_terminal[i];
+        }
+        f.avg_degree = sum / f.num_nodes;
+        double var = std::max(0.0, sum_sq / f.num_nodes - f.avg_degree * f.avg_degree);
+        f.degree_cv = f.avg_degree > 0.0 ? std::sqrt(var) / f.avg_degree : 0.0;
+        f.terminal_ratio = double(num_terminal) / f.num_nodes;
+        f.locality = double(solver_detail::median_offset(offsets, num_sampled)) / f.num_nodes;
+    }
+    f.min_cap = max_cap > 0.0 ? min_cap : 0.0;
+    f.max_cap = max_cap;
+    f.is_grid = known_grid || solver_detail::looks_like_grid(offsets, num_sampled, f.max_degree);
+    return f;
+}
+
+/** Rule of the decision table used by select_solver. */
+struct SolverRule {
+    const char *solver;
+    const char *reason;
+    bool (*matches)(const GraphFeatures& f, unsigned int num_threads);
+};
+
+/**
+ * Decision table used by select_solver. The first matching rule wins. The rules were calibrated with demo on the DTU
+ * vision graphs, graphGen.py instances and generated dense, bipartite and layered graphs:
+ *
+ *  - HI_PR is 50x faster than the augmenting path solvers when the terminals are attached to few nodes and the
+ *    arcs are local (median index offset below 1% of the nodes), since the augmenting paths are then very long. On
+ *    random graphs with few terminal arcs it is 3-5x slower than EIBFS-I.
+ *  - HPF is slightly ahead of EIBFS-I on dense graphs.
+ *  - MBK-R is fastest on small grids, where its cheap build dominates.
+ *  - EIBFS-I is fastest or close to it on everything else, incl. large grids and graphs with hub nodes or wide
+ *    capacity ranges.
+ *
+ * Rules get the thread count, but all solvers in the table are serial.
+ */
+inline const std::vector<SolverRule>& solver_rules()
+{
+    static const std::vector<SolverRule> rules = {
+        { "hi_pr", "few terminal arcs and local arcs",
+            [](const GraphFeatures& f, unsigned int) { return f.terminal_ratio < 0.01 && f.locality < 0.01; } },
+        { "hpf", "dense graph",
+            [](const GraphFeatures& f, unsigned int) { return !f.is_grid && f.avg_degree >= 64.0; } },
+        { "mbk_r", "small grid",
+            [](const GraphFeatures& f, unsigned int) { return f.is_grid && f.num_nodes < (1 << 20); } },
+        { "eibfs_i", "default",
+            [](const GraphFeatures&, unsigned int) { return true; } },
+    };
+    return rules;
+}
+
+/**
+ * Return the rule of solver_rules to use for a graph with features f. Rules whose solver is not in registry are skipped,
+ * e.g. hi_pr for other than int capacities.
+ */
+template <class Cap, class Term, class Flow>
+inline const SolverRule& select_solver_rule(
+    const GraphFeatures& f, const SolverRegistry<Cap, Term, Flow>& registry, unsigned int num_threads = 1)
+{
+    for (const auto& rule : solver_rules()) {
+        if (registry.contains(rule.solver) && rule.matches(f, num_threads)) {
+            return rule;
+        }
+    }
+    return solver_rules().back();
+}
+
+/** As above, for the solvers of SolverRegistry<Cap, Term, Flow>::instance(). */
+template <class Cap, class Term, class Flow>
+inline const SolverRule& select_solver_rule(const GraphFeatures& f, unsigned int num_threads = 1)
+{
+    return select_solver_rule(f, SolverRegistry<Cap, Term, Flow>::instance(), num_threads);
+}
+
+/** Name of the solver to use for a graph with features f, e.g. for SolverRegistry<Cap, Term, Flow>::create or bench. */
+template <class Cap, class Term, class Flow>
+inline std::string select_solver(const GraphFeatures& f, unsigned int num_threads = 1)
+{
+    return select_solver_rule<Cap, Term, Flow>(f, num_threads).solver;
+}
+
+#endif // MAXFLOW_SOLVER_H__
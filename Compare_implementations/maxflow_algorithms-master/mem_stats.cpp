@@ -0,0 +1,159 @@
+#include "mem_stats.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Sanitizers replace malloc themselves and crash if it is taken over once more, so their builds go without the hooks
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define MEM_STATS_SANITIZER_BUILD
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define MEM_STATS_SANITIZER_BUILD
+#endif
+#endif
+
+// The hooks put every allocation of the process through shared atomics, so they are only compiled in on request
+#if defined(MEM_STATS_TRACK_HEAP) && defined(__GLIBC__) && !defined(MEM_STATS_SANITIZER_BUILD)
+#include <cerrno>
+#include <malloc.h>
+
+// glibc's own allocator, which the hooks below forward to. Replacing malloc this way is supported by glibc, and
+// malloc_usable_size keeps working since the blocks still come from glibc.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+
+namespace {
+
+// Signed, since blocks from allocation functions which are not hooked (e.g. valloc) may still be freed through free
+std::atomic<int64_t> current_bytes(0);
+std::atomic<int64_t> peak_bytes(0);
+
+void on_alloc(void *ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    const int64_t size = static_cast<int64_t>(malloc_usable_size(ptr));
+    const int64_t now = current_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+void on_free(void *ptr)
+{
+    if (ptr != nullptr) {
+        current_bytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    on_alloc(ptr);
+    return ptr;
+}
+
+void *calloc(size_t num, size_t size)
+{
+    void *ptr = __libc_calloc(num, size);
+    on_alloc(ptr);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    const size_t old_size = ptr != nullptr ? malloc_usable_size(ptr) : 0;
+    void *out = __libc_realloc(ptr, size);
+    if (out != nullptr || size == 0) {
+        // The old block is gone, either moved, resized in place or freed by realloc(ptr, 0)
+        current_bytes.fetch_sub(old_size, std::memory_order_relaxed);
+        on_alloc(out);
+    }
+    return out;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+    on_alloc(ptr);
+    return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size)
+{
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *ptr = memalign(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+void free(void *ptr)
+{
+    on_free(ptr);
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+bool mem_stats::heap_tracking_available() { return true; }
+int64_t mem_stats::heap_bytes() { return current_bytes.load(std::memory_order_relaxed); }
+int64_t mem_stats::heap_peak_bytes() { return peak_bytes.load(std::memory_order_relaxed); }
+void mem_stats::reset_heap_peak() { peak_bytes.store(heap_bytes(), std::memory_order_relaxed); }
+#else
+bool mem_stats::heap_tracking_available() { return false; }
+int64_t mem_stats::heap_bytes() { return 0; }
+int64_t mem_stats::heap_peak_bytes() { return 0; }
+void mem_stats::reset_heap_peak() {}
+#endif
+
+bool mem_stats::reset_peak_rss()
+{
+#ifdef __linux__
+    // Writing 5 resets VmHWM to the current RSS (Linux 4.0 and later)
+    FILE *file = std::fopen("/proc/self/clear_refs", "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool ok = std::fputs("5", file) >= 0;
+    return std::fclose(file) == 0 && ok;
+#else
+    return false;
+#endif
+}
+
+int64_t mem_stats::peak_rss_bytes()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stoll(line.substr(6)) * 1024;
+        }
+    }
+#endif
+    return -1;
+}
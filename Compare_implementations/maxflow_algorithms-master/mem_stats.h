@@ -0,0 +1,38 @@
+#ifndef MEM_STATS_H__
+#define MEM_STATS_H__
+
+#include <cstdint>
+
+/**
+ * Memory use of the process. Heap bytes are counted by malloc hooks in mem_stats.cpp, which the program must be linked
+ * with. They see everything allocated with malloc, calloc, realloc, the aligned variants and operator new, i.e. all
+ * solvers and std containers, but not memory mapped directly (e.g. by TBB's scalable allocator). The hooks are only
+ * compiled in if MEM_STATS_TRACK_HEAP is defined, and only available with glibc and not in sanitizer builds, which bring
+ * their own malloc. Resident set size is read from /proc on Linux.
+ */
+namespace mem_stats {
+
+/** True if the malloc hooks are installed, so the heap byte counts are meaningful. */
+bool heap_tracking_available();
+
+/** Bytes currently allocated on the heap. */
+int64_t heap_bytes();
+
+/** Largest heap_bytes() since the last reset_heap_peak(). */
+int64_t heap_peak_bytes();
+
+/** Restart tracking the heap peak from the bytes allocated now. */
+void reset_heap_peak();
+
+/**
+ * Restart tracking the peak resident set size. Returns false if the kernel does not allow it, in which case
+ * peak_rss_bytes() is the peak over the lifetime of the process.
+ */
+bool reset_peak_rss();
+
+/** Peak resident set size since the last reset_peak_rss() in bytes, or -1 if it cannot be read. */
+int64_t peak_rss_bytes();
+
+} // namespace mem_stats
+
+#endif // MEM_STATS_H__
@@ -62,7 +62,10 @@
 #define __NBK_GRAPH_H__
 
 #include <string.h>
+#include <stdint.h>
+#include <vector>
 #include "block.h"
+#include "../op_stats.h"
 
 #include <assert.h>
 // NOTE: in UNIX you need to use -DNDEBUG preprocessor option to supress assert's!!!
@@ -79,9 +82,10 @@ typedef int node_id;
 // captype: type of edge capacities (excluding t-links)
 // tcaptype: type of t-links (edges between nodes and terminals)
 // flowtype: type of total flow
+// count_ops: if true, maxflow() counts its operations (see get_op_stats())
 //
 // Current instantiations are in instances.inc
-template <typename captype, typename tcaptype, typename flowtype> class Graph
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops = false> class Graph
 {
 public:
 
@@ -136,12 +140,23 @@ public:
 	flowtype maxflow(bool reuse_trees = false, Block<node_id>* changed_list = NULL);
 
 	// After the maxflow is computed, this function returns to which
-	// segment the node 'i' belongs (Graph<captype,tcaptype,flowtype>::SOURCE or Graph<captype,tcaptype,flowtype>::SINK).
+	// segment the node 'i' belongs (Graph<captype,tcaptype,flowtype,count_ops>::SOURCE or Graph<captype,tcaptype,flowtype,count_ops>::SINK).
 	//
 	// Occasionally there may be several minimum cuts. If a node can be assigned
 	// to both the source and the sink, then default_segm is returned.
 	termtype what_segment(node_id i, termtype default_segm = SOURCE);
 
+	// Same as calling what_segment() for all nodes, but in one pass over the nodes: cut[i] is set to 1
+	// if node 'i' belongs to the SOURCE segment and 0 otherwise. cut is resized to the number of nodes.
+	void get_cut(std::vector<uint8_t>& cut, termtype default_segm = SOURCE);
+
+	// Residual capacities of all arcs in the order the edges were added: for the k-th call of
+	// add_edge(i,j,cap,rev_cap), res[2k] is the residual capacity of i->j and res[2k+1] that of j->i.
+	template <class T> void get_residual_caps(std::vector<T>& res) const;
+
+	// Operation counts of the last maxflow() call. All zero unless count_ops is true.
+	OpStats get_op_stats() const { return op_counter.get(); }
+
 
 
 	//////////////////////////////////////////////
@@ -345,6 +360,7 @@ private:
 	node				*queue_first[2], *queue_last[2];	// list of active nodes
 	nodeptr				*orphan_first, *orphan_last;		// list of pointers to orphans
 	long long			TIME;								// monotonically increasing global counter
+	OpCounter<count_ops>	op_counter;
 
 	/////////////////////////////////////////////////////////////////////////
 
@@ -386,8 +402,8 @@ private:
 
 
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline node_id Graph<captype,tcaptype,flowtype>::add_node(int num)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline node_id Graph<captype,tcaptype,flowtype,count_ops>::add_node(int num)
 {
 	assert(num > 0);
 
@@ -401,8 +417,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	return i;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::add_tweights(node_id i, tcaptype cap_source, tcaptype cap_sink)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::add_tweights(node_id i, tcaptype cap_source, tcaptype cap_sink)
 {
 	assert(i >= 0 && i < node_num);
 
@@ -413,8 +429,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	nodes[i].tr_cap = cap_source - cap_sink;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::add_edge(node_id _i, node_id _j, captype cap, captype rev_cap)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::add_edge(node_id _i, node_id _j, captype cap, captype rev_cap)
 {
 	assert(_i >= 0 && _i < node_num);
 	assert(_j >= 0 && _j < node_num);
@@ -440,57 +456,57 @@ template <typename captype, typename tcaptype, typename flowtype>
 	a_rev -> r_cap = rev_cap;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline typename Graph<captype,tcaptype,flowtype>::arc* Graph<captype,tcaptype,flowtype>::get_first_arc()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline typename Graph<captype,tcaptype,flowtype,count_ops>::arc* Graph<captype,tcaptype,flowtype,count_ops>::get_first_arc()
 {
 	return arcs;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline typename Graph<captype,tcaptype,flowtype>::arc* Graph<captype,tcaptype,flowtype>::get_next_arc(arc* a) 
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline typename Graph<captype,tcaptype,flowtype,count_ops>::arc* Graph<captype,tcaptype,flowtype,count_ops>::get_next_arc(arc* a) 
 {
 	return a + 1; 
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::get_arc_ends(arc* a, node_id& i, node_id& j)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::get_arc_ends(arc* a, node_id& i, node_id& j)
 {
 	assert(a >= arcs && a < arc_last);
 	i = (node_id) (get_sister_arc(a)->head - nodes);
 	j = (node_id) (a->head - nodes);
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline tcaptype Graph<captype,tcaptype,flowtype>::get_trcap(node_id i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline tcaptype Graph<captype,tcaptype,flowtype,count_ops>::get_trcap(node_id i)
 {
 	assert(i>=0 && i<node_num);
 	return nodes[i].tr_cap;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline captype Graph<captype,tcaptype,flowtype>::get_rcap(arc* a)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline captype Graph<captype,tcaptype,flowtype,count_ops>::get_rcap(arc* a)
 {
 	assert(a >= arcs && a < arc_last);
 	return a->r_cap;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::set_trcap(node_id i, tcaptype trcap)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::set_trcap(node_id i, tcaptype trcap)
 {
 	assert(i>=0 && i<node_num); 
 	nodes[i].tr_cap = trcap;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::set_rcap(arc* a, captype rcap)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::set_rcap(arc* a, captype rcap)
 {
 	assert(a >= arcs && a < arc_last);
 	a->r_cap = rcap;
 }
 
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline termtype Graph<captype,tcaptype,flowtype>::what_segment(node_id i, termtype default_segm)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline termtype Graph<captype,tcaptype,flowtype,count_ops>::what_segment(node_id i, termtype default_segm)
 {
 	if (nodes[i].parent)
 	{
@@ -502,8 +518,30 @@ template <typename captype, typename tcaptype, typename flowtype>
 	}
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::mark_node(node_id _i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::get_cut(std::vector<uint8_t>& cut, termtype default_segm)
+{
+	uint8_t default_value = (default_segm == SOURCE) ? 1 : 0;
+
+	cut.resize(node_last - nodes);
+	for (node *i = nodes; i < node_last; i++)
+	{
+		cut[i - nodes] = (i->parent) ? !i->is_sink : default_value;
+	}
+}
+
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> template <class T>
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::get_residual_caps(std::vector<T>& res) const
+{
+	res.resize(arc_last - arcs);
+	for (arc *a = arcs; a < arc_last; a++)
+	{
+		res[a - arcs] = a->r_cap;
+	}
+}
+
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::mark_node(node_id _i)
 {
 	node* i = nodes + _i;
 	if (!i->next)
@@ -517,8 +555,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	i->is_marked = true;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline typename Graph<captype,tcaptype,flowtype>::arc* Graph<captype,tcaptype,flowtype>::get_sister_arc(arc* a) 
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline typename Graph<captype,tcaptype,flowtype,count_ops>::arc* Graph<captype,tcaptype,flowtype,count_ops>::get_sister_arc(arc* a) 
 {
 	// Sisters are always adjacent.
 	// We calculate the arc number. If it's even the sister is next. Uneven the sister i previous.
@@ -30,8 +30,8 @@
 */
 
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::set_active(node *i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::set_active(node *i)
 {
 	if (!i->next)
 	{
@@ -48,8 +48,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	If it is connected to the sink, it stays in the list,
 	otherwise it is removed from the list
 */
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline typename Graph<captype,tcaptype,flowtype>::node* Graph<captype,tcaptype,flowtype>::next_active()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline typename Graph<captype,tcaptype,flowtype,count_ops>::node* Graph<captype,tcaptype,flowtype,count_ops>::next_active()
 {
 	node *i;
 
@@ -76,8 +76,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 /***********************************************************************/
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::set_orphan_front(node *i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::set_orphan_front(node *i)
 {
 	nodeptr *np;
 	i -> parent = ORPHAN;
@@ -87,8 +87,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	orphan_first = np;
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::set_orphan_rear(node *i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::set_orphan_rear(node *i)
 {
 	nodeptr *np;
 	i -> parent = ORPHAN;
@@ -102,8 +102,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 /***********************************************************************/
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	inline void Graph<captype,tcaptype,flowtype>::add_to_changed_list(node *i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	inline void Graph<captype,tcaptype,flowtype,count_ops>::add_to_changed_list(node *i)
 {
 	if (changed_list && !i->is_in_changed_list)
 	{
@@ -115,8 +115,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 /***********************************************************************/
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::maxflow_init()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::maxflow_init()
 {
 	node *i;
 
@@ -155,8 +155,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	}
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::maxflow_reuse_trees_init()
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::maxflow_reuse_trees_init()
 {
 	node* i;
 	node* j;
@@ -240,12 +240,13 @@ template <typename captype, typename tcaptype, typename flowtype>
 	//test_consistency();
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::augment(arc *middle_arc)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::augment(arc *middle_arc)
 {
 	node *i;
 	arc *a;
 	tcaptype bottleneck;
+	int length = 3; /* middle arc and the two terminal arcs */
 
 
 	/* 1. Finding bottleneck capacity */
@@ -255,6 +256,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 	{
 		a = i -> parent;
 		if (a == TERMINAL) break;
+		length ++;
 		if (bottleneck > get_sister_arc(a)->r_cap) bottleneck = get_sister_arc(a) -> r_cap;
 	}
 	if (bottleneck > i->tr_cap) bottleneck = i -> tr_cap;
@@ -263,6 +265,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 	{
 		a = i -> parent;
 		if (a == TERMINAL) break;
+		length ++;
 		if (bottleneck > a->r_cap) bottleneck = a -> r_cap;
 	}
 	if (bottleneck > - i->tr_cap) bottleneck = - i -> tr_cap;
@@ -308,19 +311,21 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 
 	flow += bottleneck;
+	op_counter.augmentation(length);
 }
 
 /***********************************************************************/
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::process_source_orphan(node *i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::process_source_orphan(node *i)
 {
 	node *j;
 	arc *a0, *a0_min = NULL, *a;
 	int d, d_min = INFINITE_D;
+	op_counter.orphan();
 
 	/* trying to find a new parent */
-	for (a0=i->first; a0; a0=a0->next)
+	for (a0=i->first; a0; a0=a0->next) { op_counter.arcs_scanned();
 	if (get_sister_arc(a0)->r_cap)
 	{
 		j = a0 -> head;
@@ -361,10 +366,11 @@ template <typename captype, typename tcaptype, typename flowtype>
 				}
 			}
 		}
-	}
+	} }
 
 	if (i->parent = a0_min)
 	{
+		op_counter.adoption();
 		i -> TS = TIME;
 		i -> DIST = d_min + 1;
 	}
@@ -376,6 +382,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 		/* process neighbors */
 		for (a0=i->first; a0; a0=a0->next)
 		{
+			op_counter.arcs_scanned();
 			j = a0 -> head;
 			if (!j->is_sink && (a=j->parent))
 			{
@@ -389,15 +396,16 @@ template <typename captype, typename tcaptype, typename flowtype>
 	}
 }
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::process_sink_orphan(node *i)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::process_sink_orphan(node *i)
 {
 	node *j;
 	arc *a0, *a0_min = NULL, *a;
 	int d, d_min = INFINITE_D;
+	op_counter.orphan();
 
 	/* trying to find a new parent */
-	for (a0=i->first; a0; a0=a0->next)
+	for (a0=i->first; a0; a0=a0->next) { op_counter.arcs_scanned();
 	if (a0->r_cap)
 	{
 		j = a0 -> head;
@@ -438,10 +446,11 @@ template <typename captype, typename tcaptype, typename flowtype>
 				}
 			}
 		}
-	}
+	} }
 
 	if (i->parent = a0_min)
 	{
+		op_counter.adoption();
 		i -> TS = TIME;
 		i -> DIST = d_min + 1;
 	}
@@ -453,6 +462,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 		/* process neighbors */
 		for (a0=i->first; a0; a0=a0->next)
 		{
+			op_counter.arcs_scanned();
 			j = a0 -> head;
 			if (j->is_sink && (a=j->parent))
 			{
@@ -468,8 +478,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 /***********************************************************************/
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	flowtype Graph<captype,tcaptype,flowtype>::maxflow(bool reuse_trees, Block<node_id>* _changed_list)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	flowtype Graph<captype,tcaptype,flowtype,count_ops>::maxflow(bool reuse_trees, Block<node_id>* _changed_list)
 {
 	node *i, *j, *current_node = NULL;
 	arc *a;
@@ -484,6 +494,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 	if (maxflow_iteration == 0 && reuse_trees) { if (error_function) (*error_function)("reuse_trees cannot be used in the first call to maxflow()!"); exit(1); }
 	if (changed_list && !reuse_trees) { if (error_function) (*error_function)("changed_list cannot be used without reuse_trees!"); exit(1); }
 
+	op_counter.reset();
 	if (reuse_trees) maxflow_reuse_trees_init();
 	else             maxflow_init();
 
@@ -503,10 +514,11 @@ template <typename captype, typename tcaptype, typename flowtype>
 		}
 
 		/* growth */
+		op_counter.growth_step();
 		if (!i->is_sink)
 		{
 			/* grow source tree */
-			for (a=i->first; a; a=a->next)
+			for (a=i->first; a; a=a->next) { op_counter.arcs_scanned();
 			if (a->r_cap)
 			{
 				j = a -> head;
@@ -528,12 +540,12 @@ template <typename captype, typename tcaptype, typename flowtype>
 					j -> TS = i -> TS;
 					j -> DIST = i -> DIST + 1;
 				}
-			}
+			} }
 		}
 		else
 		{
 			/* grow sink tree */
-			for (a=i->first; a; a=a->next)
+			for (a=i->first; a; a=a->next) { op_counter.arcs_scanned();
 			if (get_sister_arc(a)->r_cap)
 			{
 				j = a -> head;
@@ -555,7 +567,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 					j -> TS = i -> TS;
 					j -> DIST = i -> DIST + 1;
 				}
-			}
+			} }
 		}
 
 		TIME ++;
@@ -606,8 +618,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 /***********************************************************************/
 
 
-template <typename captype, typename tcaptype, typename flowtype> 
-	void Graph<captype,tcaptype,flowtype>::test_consistency(node* current_node)
+template <typename captype, typename tcaptype, typename flowtype, bool count_ops> 
+	void Graph<captype,tcaptype,flowtype,count_ops>::test_consistency(node* current_node)
 {
 	node *i;
 	arc *a;
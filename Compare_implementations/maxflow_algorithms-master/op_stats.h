@@ -0,0 +1,108 @@
+#ifndef OP_STATS_H__
+#define OP_STATS_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Operation counts of one maxflow call. Each solver only fills the counters which apply to it, e.g. the augmenting
+ * path solvers never push or relabel and the push-relabel solvers never augment, so the other counters stay zero.
+ * This header has no dependencies, so the solvers outside this project (maxflow-master, Dinitz_Compare) report their
+ * statistics with the same names.
+ */
+struct OpStats {
+    uint64_t augmentations = 0; // Augmenting paths
+    uint64_t path_length = 0; // Sum of the arc counts of all augmenting paths
+    uint64_t pushes = 0;
+    uint64_t relabels = 0;
+    uint64_t global_updates = 0; // Global relabels
+    uint64_t gaps = 0; // Gap heuristic applications
+    uint64_t orphans = 0; // Orphans processed
+    uint64_t adoptions = 0; // Orphans which found a new parent
+    uint64_t growth_steps = 0; // Nodes expanded while growing search trees or BFS layers
+    uint64_t arcs_scanned = 0; // Arcs looked at while growing, adopting or relabelling
+    uint64_t phases = 0; // Rounds of the phase based solvers, e.g. blocking flows of Dinic
+
+    OpStats& operator+=(const OpStats& other)
+    {
+        augmentations += other.augmentations;
+        path_length += other.path_length;
+        pushes += other.pushes;
+        relabels += other.relabels;
+        global_updates += other.global_updates;
+        gaps += other.gaps;
+        orphans += other.orphans;
+        adoptions += other.adoptions;
+        growth_steps += other.growth_steps;
+        arcs_scanned += other.arcs_scanned;
+        phases += other.phases;
+        return *this;
+    }
+};
+
+/** Names of the OpStats counters, in the order of op_stats_values. These are the column names of the output. */
+inline const std::vector<std::string> op_stats_names = {
+    "augmentations", "path_length", "pushes", "relabels", "global_updates", "gaps", "orphans", "adoptions",
+    "growth_steps", "arcs_scanned", "phases"
+};
+
+inline std::vector<uint64_t> op_stats_values(const OpStats& stats)
+{
+    return {
+        stats.augmentations, stats.path_length, stats.pushes, stats.relabels, stats.global_updates, stats.gaps,
+        stats.orphans, stats.adoptions, stats.growth_steps, stats.arcs_scanned, stats.phases
+    };
+}
+
+/**
+ * Counts operations into an OpStats if Enabled. Solvers take it as a bool template flag, so with the flag off every
+ * call is an empty inline function and the counting compiles out completely.
+ */
+template <bool Enabled>
+class OpCounter;
+
+template <>
+class OpCounter<false> {
+public:
+    void reset() {}
+    OpStats get() const { return OpStats(); }
+    void add(const OpStats&) {}
+
+    void augmentation(uint64_t) {}
+    void push() {}
+    void relabel() {}
+    void global_update() {}
+    void gap() {}
+    void orphan() {}
+    void adoption() {}
+    void growth_step() {}
+    void arcs_scanned(uint64_t = 1) {}
+};
+
+template <>
+class OpCounter<true> {
+public:
+    void reset() { stats = OpStats(); }
+    OpStats get() const { return stats; }
+    void add(const OpStats& other) { stats += other; }
+
+    void augmentation(uint64_t length)
+    {
+        stats.augmentations++;
+        stats.path_length += length;
+    }
+    void push() { stats.pushes++; }
+    void relabel() { stats.relabels++; }
+    void global_update() { stats.global_updates++; }
+    void gap() { stats.gaps++; }
+    void orphan() { stats.orphans++; }
+    void adoption() { stats.adoptions++; }
+    void growth_step() { stats.growth_steps++; }
+    void arcs_scanned(uint64_t num = 1) { stats.arcs_scanned += num; }
+
+private:
+    OpStats stats;
+};
+
+#endif // OP_STATS_H__
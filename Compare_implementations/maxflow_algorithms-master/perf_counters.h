@@ -0,0 +1,221 @@
+#ifndef PERF_COUNTERS_H__
+#define PERF_COUNTERS_H__
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Hardware and software event counters for the calling thread, read with perf_event_open on Linux. Threads created
+ * while counting are included, but threads of a pool which already exists (e.g. TBB workers) are not.
+ *
+ * Hardware events are opened as one group so they are always scheduled together and ratios like instructions per
+ * cycle are meaningful. If the kernel has to multiplex them, values are scaled up by the fraction of time they ran.
+ * Events which cannot be opened (e.g. no PMU access in a VM) are skipped with a warning and read as -1.
+ */
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+        close_all();
+    }
+
+    /** Select the counters to read. Each is opened once to check that it is available. */
+    void open(const std::vector<std::string>& names)
+    {
+        for (const auto& name : names) {
+            find_event(name);
+        }
+        names_ = names;
+        values_.assign(names.size(), -1);
+        available_.assign(names.size(), false);
+#ifdef __linux__
+        for (size_t i = 0; i < names.size(); ++i) {
+            int fd = open_event(find_event(names[i]), -1);
+            if (fd < 0) {
+                std::cerr << "Could not open counter " << names[i] << ": " << std::strerror(errno)
+                    << ", it is reported as empty" << std::endl;
+                continue;
+            }
+            close(fd);
+            available_[i] = true;
+        }
+#else
+        if (!names.empty()) {
+            std::cerr << "counters are only supported on Linux, they are reported as empty" << std::endl;
+        }
+#endif
+    }
+
+    const std::vector<std::string>& names() const
+    {
+        return names_;
+    }
+
+    /** Values counted between the last start and stop, or -1 for counters which could not be opened. */
+    const std::vector<int64_t>& values() const
+    {
+        return values_;
+    }
+
+    /** Forget the values of the last solve, so a run which is not counted reports them as empty. */
+    void clear()
+    {
+        values_.assign(names_.size(), -1);
+    }
+
+    /**
+     * The counters are opened here and closed in stop. Resetting an inherited counter does not reset the copies
+     * in threads created while it was enabled, so reusing the counters would add up threads from earlier solves.
+     */
+    void start()
+    {
+#ifdef __linux__
+        fds_.assign(names_.size(), -1);
+        int group_fd = -1;
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (!available_[i]) {
+                continue;
+            }
+            const EventDesc& ev = find_event(names_[i]);
+            bool is_hw = ev.type != PERF_TYPE_SOFTWARE;
+            fds_[i] = open_event(ev, is_hw ? group_fd : -1);
+            if (is_hw && group_fd < 0) {
+                group_fd = fds_[i];
+            }
+        }
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop()
+    {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (size_t i = 0; i < fds_.size(); ++i) {
+            values_[i] = -1;
+            uint64_t buf[3]; // value, time enabled, time running
+            if (fds_[i] >= 0 && read(fds_[i], buf, sizeof(buf)) == sizeof(buf)) {
+                if (buf[2] == 0) {
+                    values_[i] = 0;
+                } else if (buf[2] < buf[1]) {
+                    values_[i] = static_cast<int64_t>(static_cast<double>(buf[0]) * buf[1] / buf[2]);
+                } else {
+                    values_[i] = static_cast<int64_t>(buf[0]);
+                }
+            }
+        }
+#endif
+        close_all();
+    }
+
+private:
+    struct EventDesc {
+        const char *name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    static const std::vector<EventDesc>& events()
+    {
+#ifdef __linux__
+        auto cache = [](uint64_t cache, uint64_t op, uint64_t result) {
+            return cache | (op << 8) | (result << 16);
+        };
+        static const std::vector<EventDesc> evs = {
+            { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { "cache_references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+            { "llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+            { "branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+            { "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { "l1d_misses", PERF_TYPE_HW_CACHE,
+                cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+            { "dtlb_misses", PERF_TYPE_HW_CACHE,
+                cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+            { "task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+            { "page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+            { "context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+            { "cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS }
+        };
+#else
+        // Same names so configs stay portable, the counters are just never opened
+        static const std::vector<EventDesc> evs = {
+            { "cycles", 0, 0 }, { "instructions", 0, 0 }, { "cache_references", 0, 0 }, { "llc_misses", 0, 0 },
+            { "branches", 0, 0 }, { "branch_misses", 0, 0 }, { "l1d_misses", 0, 0 }, { "dtlb_misses", 0, 0 },
+            { "task_clock_ns", 0, 0 }, { "page_faults", 0, 0 }, { "context_switches", 0, 0 },
+            { "cpu_migrations", 0, 0 }
+        };
+#endif
+        return evs;
+    }
+
+    static const EventDesc& find_event(const std::string& name)
+    {
+        for (const auto& ev : events()) {
+            if (name == ev.name) {
+                return ev;
+            }
+        }
+        throw std::invalid_argument("Invalid counter: " + name);
+    }
+
+#ifdef __linux__
+    static int open_event(const EventDesc& ev, int group_fd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = ev.type;
+        attr.config = ev.config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+#endif
+
+    void close_all()
+    {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+        fds_.clear();
+    }
+
+    std::vector<std::string> names_;
+    std::vector<bool> available_;
+    std::vector<int> fds_;
+    std::vector<int64_t> values_;
+};
+
+#endif // PERF_COUNTERS_H__
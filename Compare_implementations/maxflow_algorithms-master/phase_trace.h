@@ -0,0 +1,204 @@
+#ifndef PHASE_TRACE_H__
+#define PHASE_TRACE_H__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+ * Phases of a solve which can be marked with TRACE_PHASE. Not every solver has every phase: the augmenting path
+ * solvers grow, augment and adopt, the push-relabel solvers discharge, relabel globally and apply the gap heuristic.
+ */
+enum class Phase : uint8_t {
+    SOLVE,
+    INIT,
+    GROWTH,
+    AUGMENT,
+    ADOPT,
+    GLOBAL_RELABEL,
+    GAP,
+    DISCHARGE
+};
+
+inline const char *phase_name(Phase phase)
+{
+    switch (phase) {
+    case Phase::SOLVE: return "solve";
+    case Phase::INIT: return "init";
+    case Phase::GROWTH: return "growth";
+    case Phase::AUGMENT: return "augment";
+    case Phase::ADOPT: return "adopt";
+    case Phase::GLOBAL_RELABEL: return "global_relabel";
+    case Phase::GAP: return "gap";
+    case Phase::DISCHARGE: return "discharge";
+    }
+    return "unknown";
+}
+
+inline uint64_t phase_clock_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct PhaseEvent {
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    Phase phase;
+};
+
+/**
+ * Phase events of one thread. It is a ring buffer, so once it is full the oldest events are overwritten and a long
+ * solve keeps its last events. Only the owning thread records into it.
+ */
+class PhaseBuffer {
+public:
+    PhaseBuffer(uint32_t tid, size_t capacity) : tid_(tid), capacity_(std::max<size_t>(capacity, 1)) {}
+
+    void record(Phase phase, uint64_t begin_ns, uint64_t end_ns)
+    {
+        if (events_.empty()) {
+            // Allocated on the first event, so threads which never trace cost nothing
+            events_.resize(capacity_);
+        }
+        events_[count_ % capacity_] = { begin_ns, end_ns, phase };
+        count_++;
+    }
+
+    void clear() { count_ = 0; }
+
+    uint32_t tid() const { return tid_; }
+    size_t size() const { return static_cast<size_t>(std::min<uint64_t>(count_, capacity_)); }
+    uint64_t dropped() const { return count_ - size(); }
+
+    /** Call func(event) for the kept events, oldest first. */
+    template <class Func>
+    void for_each(Func func) const
+    {
+        const uint64_t first = count_ - size();
+        for (uint64_t i = first; i < count_; ++i) {
+            func(events_[i % capacity_]);
+        }
+    }
+
+private:
+    uint32_t tid_;
+    size_t capacity_;
+    uint64_t count_ = 0;
+    std::vector<PhaseEvent> events_;
+};
+
+/**
+ * Registry of the phase buffers of all threads which have recorded events. Buffers stay registered after their
+ * thread exits, so events of short lived worker threads can still be written out after the solve.
+ */
+class PhaseTrace {
+public:
+    static PhaseTrace& instance()
+    {
+        static PhaseTrace trace;
+        return trace;
+    }
+
+    PhaseBuffer& thread_buffer()
+    {
+        thread_local PhaseBuffer *buffer = nullptr;
+        if (buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(std::make_unique<PhaseBuffer>(static_cast<uint32_t>(buffers_.size()), capacity_));
+            buffer = buffers_.back().get();
+        }
+        return *buffer;
+    }
+
+    /** Events kept per thread by buffers created from now on. */
+    void set_capacity(size_t events_per_thread)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = events_per_thread;
+    }
+
+    /** Drop the events of all threads. No thread may record at the same time. */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& buffer : buffers_) {
+            buffer->clear();
+        }
+    }
+
+    /** Events which were overwritten since the last clear, summed over all threads. */
+    uint64_t dropped() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t out = 0;
+        for (const auto& buffer : buffers_) {
+            out += buffer->dropped();
+        }
+        return out;
+    }
+
+    /**
+     * Write the kept events of all threads as complete ("X") events of the Chrome trace format, under the given
+     * process id. Timestamps are in microseconds from the first kept event. Each event is preceded by a comma unless
+     * first is true, which is then cleared. Returns the number of events written.
+     */
+    size_t write_chrome_events(std::ostream& os, int pid, bool& first) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t origin = UINT64_MAX;
+        for (const auto& buffer : buffers_) {
+            buffer->for_each([&](const PhaseEvent& e) { origin = std::min(origin, e.begin_ns); });
+        }
+        size_t count = 0;
+        for (const auto& buffer : buffers_) {
+            buffer->for_each([&](const PhaseEvent& e) {
+                os << (first ? "" : ",\n") << "{\"name\":\"" << phase_name(e.phase) << "\",\"cat\":\"phase\",\"ph\":\"X\""
+                    << ",\"ts\":" << (e.begin_ns - origin) / 1000.0 << ",\"dur\":" << (e.end_ns - e.begin_ns) / 1000.0
+                    << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid() << "}";
+                first = false;
+                count++;
+            });
+        }
+        return count;
+    }
+
+private:
+    PhaseTrace() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<PhaseBuffer>> buffers_;
+    size_t capacity_ = 1 << 18;
+};
+
+/** Records the time from its construction to its destruction as one event of the calling thread. */
+class PhaseScope {
+public:
+    explicit PhaseScope(Phase phase) : phase_(phase), begin_ns_(phase_clock_ns()) {}
+    ~PhaseScope() { PhaseTrace::instance().thread_buffer().record(phase_, begin_ns_, phase_clock_ns()); }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    Phase phase_;
+    uint64_t begin_ns_;
+};
+
+// TRACE_PHASE(GROWTH) marks the rest of the enclosing scope as the given phase. The markers are compiled in only if
+// MAXFLOW_TRACE_PHASES is defined (CMake option maxflow_algos_trace_phases), and are empty statements otherwise.
+#ifdef MAXFLOW_TRACE_PHASES
+#define PHASE_TRACE_CONCAT_(a, b) a##b
+#define PHASE_TRACE_CONCAT(a, b) PHASE_TRACE_CONCAT_(a, b)
+#define TRACE_PHASE(phase) PhaseScope PHASE_TRACE_CONCAT(phase_scope_, __LINE__)(Phase::phase)
+constexpr bool phase_trace_enabled = true;
+#else
+#define TRACE_PHASE(phase) ((void)0)
+constexpr bool phase_trace_enabled = false;
+#endif
+
+#endif // PHASE_TRACE_H__
@@ -58,12 +58,15 @@ If you require another license, please contact the above.
 #include <algorithm>
 #include <type_traits>
 #include <cassert>
+#include <vector>
 
 #include "util.h"
+#include "../op_stats.h"
+#include "../phase_trace.h"
 
 namespace reimpls {
 
-template <class Cap, class Term, class Flow, class NodeIdx = uint32_t, class ArcIdx = uint32_t>
+template <class Cap, class Term, class Flow, class NodeIdx = uint32_t, class ArcIdx = uint32_t, bool CountOps = false>
 class IBFSGraph {
     static constexpr size_t ALLOC_INIT_LEVELS = 4096;
 
@@ -88,7 +91,9 @@ public:
     IBFSGraph(int64_t numNodes, int64_t numEdges);
     ~IBFSGraph();
     void initSize(int64_t numNodes, int64_t numEdges);
-    void reset();
+    // Empties the graph for numNodes nodes and numEdges edges, which must not be more than given to initSize. The
+    // arrays allocated by initSize are reused.
+    void reset(int64_t numNodes, int64_t numEdges);
     void addEdge(NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity);
     void addNode(NodeIdx node, Term capSource, Term capSink);
     void incEdge(NodeIdx from, NodeIdx fo, Cap capacity, Cap revCapacity);
@@ -101,9 +106,17 @@ public:
     void resetTrees();
 
     inline Flow getFlow() const noexcept { return flow; }
+    // Operation counts of the last computeMaxFlow, all zero unless CountOps is true
+    inline OpStats getOpStats() const { return opCounter.get(); }
     inline size_t getNumNodes() const noexcept { return nodeEnd - nodes; }
     inline size_t getNumArcs() const noexcept { return arcEnd - arcs; }
     int isNodeOnSrcSide(NodeIdx node, int freeNodeValue = 0) const;
+    // Side of nodes in neither tree after computeMaxFlow. The tree which stopped growing is complete, so
+    // free nodes are on the side of the other one.
+    inline int freeNodeSide() const { return activeS1.len == 0 ? 0 : 1; }
+    // Same as isNodeOnSrcSide for all nodes, with free nodes on freeNodeSide(): cut[i] = 1 if node i is on
+    // the source side and 0 otherwise
+    void getCut(std::vector<uint8_t>& cut) const;
 
 #pragma pack (1)
     struct REIMPLS_PACKED Arc {
@@ -145,6 +158,7 @@ private:
     Buckets3Pass orphan3PassBuckets;
     BucketsOneSided orphanBuckets;
     ExcessBuckets excessBuckets;
+    OpCounter<CountOps> opCounter;
     Flow testFlow;
     double testExcess;
     char *memArcs;
@@ -596,8 +610,8 @@ private:
     void initNodes();
 };
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::IBFSGraph() :
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IBFSGraph() :
     init_n_nodes(0),
     init_n_edges(0),
     arcIter(NULL),
@@ -623,15 +637,15 @@ inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::IBFSGraph() :
     testExcess(0)
 {}
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::IBFSGraph(int64_t numNodes, int64_t numEdges) :
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IBFSGraph(int64_t numNodes, int64_t numEdges) :
     IBFSGraph()
 {
     initSize(numNodes, numEdges);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::~IBFSGraph()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::~IBFSGraph()
 {
     delete[]nodes;
     delete[]memArcs;
@@ -640,8 +654,8 @@ inline IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::~IBFSGraph()
     excessBuckets.free();
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::addNode(NodeIdx node, Term capSource, Term capSink)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::addNode(NodeIdx node, Term capSource, Term capSink)
 {
     Cap f = nodes[node].excess;
     if (f > 0) {
@@ -658,15 +672,15 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::addNode(NodeIdx node, T
 }
 
 // @pre: activeS1.len == 0 && activeT1.len == 0
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::resetTrees()
 {
     resetTrees(1, 1);
 }
 
 // @pre: activeS1.len == 0 && activeT1.len == 0
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::resetTrees(
     int64_t newTopLevelS, int64_t newTopLevelT)
 {
     uniqOrphansS = uniqOrphansT = 0;
@@ -696,8 +710,8 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::remove_sibling(NodeIdx i)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::remove_sibling(NodeIdx i)
 {
     // TODO: This can very likely be made more readable!
     Node& parent = parent_node(i);
@@ -712,15 +726,15 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::remove_sibling(NodeIdx
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::add_sibling(NodeIdx i, NodeIdx parent)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::add_sibling(NodeIdx i, NodeIdx parent)
 {
     nodes[i].nextNode = nodes[parent].firstSon;
     nodes[parent].firstSon = i;
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::print_graph(std::FILE *file) const
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::print_graph(std::FILE *file) const
 {
     const NodeIdx num_nodes = nodeEnd - nodes;
     const NodeIdx num_arcs = arcEnd - arcs;
@@ -738,15 +752,15 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::print_graph(std::FILE *
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline bool IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incShouldResetTrees()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline bool IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incShouldResetTrees()
 {
     // TODO: Make sure uniqOrphansS + uniqOrphansT can be compared to int64_t
     return (uniqOrphansS + uniqOrphansT) >= 2 * numNodes;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incNode(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incNode(
     NodeIdx node, Term deltaCapSource, Term deltaCapSink)
 {
     Node& x = nodes[node];
@@ -785,8 +799,8 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incNode(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incArc(ArcIdx ai, Cap deltaCap)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incArc(ArcIdx ai, Cap deltaCap)
 {
     if (deltaCap == 0) {
         return;
@@ -835,8 +849,8 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incArc(ArcIdx ai, Cap d
     a.isRevResidual = sister.rCap != 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::addEdge(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::addEdge(
     NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity)
 {
     tmpEdgeLast->tail = from;
@@ -851,8 +865,8 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::addEdge(
     nodes[to].label++;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incEdge(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incEdge(
     NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity)
 {
     Node& x = nodes[from];
@@ -878,8 +892,8 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::incEdge(
     incArc(arcIter->rev, revCapacity);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline int IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::isNodeOnSrcSide(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline int IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::isNodeOnSrcSide(
     NodeIdx node, int freeNodeValue) const
 {
     if (nodes[node].label == 0) {
@@ -888,15 +902,25 @@ inline int IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::isNodeOnSrcSide(
     return (nodes[node].label > 0 ? 1 : 0);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraph()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::getCut(std::vector<uint8_t>& cut) const
+{
+    const uint8_t freeValue = freeNodeSide();
+    cut.resize(nodeEnd - nodes);
+    for (const Node *x = nodes; x != nodeEnd; ++x) {
+        cut[x - nodes] = x->label == 0 ? freeValue : (x->label > 0 ? 1 : 0);
+    }
+}
+
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initGraph()
 {
     initGraphFast();
     topLevelS = topLevelT = 1;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initSize(int64_t numNodes, int64_t numEdges)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initSize(int64_t numNodes, int64_t numEdges)
 {
     init_n_nodes = numNodes;
     init_n_edges = numEdges;
@@ -935,44 +959,46 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initSize(int64_t numNod
     flow = 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::reset()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::reset(int64_t numNodes, int64_t numEdges)
 {
-    // compute allocation size
-    uint64_t arcTmpMemsize = (uint64_t)sizeof(TmpEdge) * (uint64_t)init_n_edges;
-    uint64_t arcRealMemsize = (uint64_t)sizeof(Arc) * (uint64_t)(init_n_edges * 2);
-    uint64_t nodeMemsize = (uint64_t)sizeof(NodeIdx) * (uint64_t)(init_n_nodes * 5);
-    uint64_t arcMemsize = 0;
-    arcMemsize = arcRealMemsize + arcTmpMemsize;
-    if (arcMemsize < (arcRealMemsize + nodeMemsize)) {
-        arcMemsize = (arcRealMemsize + nodeMemsize);
-    }
-
-    // alocate arcs
+    assert(isInitializedGraph() && numNodes <= init_n_nodes && numEdges <= init_n_edges);
+    // Same layout as initSize. All parts shrink with the sizes, so they fit the arrays allocated there.
+    uint64_t arcRealMemsize = (uint64_t)sizeof(Arc) * (uint64_t)(numEdges * 2);
     tmpEdges = (TmpEdge*)(memArcs + arcRealMemsize);
     tmpEdgeLast = tmpEdges; // will advance as edges are added
     arcs = (Arc*)memArcs;
-    arcEnd = arcs + init_n_edges * 2;
+    arcEnd = arcs + numEdges * 2;
 
-    // allocate nodes
-    this->init_n_nodes = init_n_nodes;
-    memset(nodes, 0, sizeof(Node) * (init_n_nodes + 1));
-    nodeEnd = nodes + init_n_nodes;
-    // TODO: This likely uses too much memory
+    this->numNodes = numNodes;
+    memset(nodes, 0, sizeof(Node) * (numNodes + 1));
+    nodeEnd = nodes + numNodes;
     active0.init((NodeIdx*)(arcEnd));
-    activeS1.init((NodeIdx*)(arcEnd)+init_n_nodes);
-    activeT1.init((NodeIdx*)(arcEnd)+(2 * init_n_nodes));
-    ptrs = (NodeIdx*)(arcEnd)+(3 * init_n_nodes);
-    excessBuckets.init_NoAlloc(nodes, ptrs, init_n_nodes);
-    orphan3PassBuckets.init_NoAlloc(nodes, init_n_nodes);
-    orphanBuckets.init_NoAlloc(nodes, init_n_nodes);
+    activeS1.init((NodeIdx*)(arcEnd)+numNodes);
+    activeT1.init((NodeIdx*)(arcEnd)+(2 * numNodes));
+    ptrs = (NodeIdx*)(arcEnd)+(3 * numNodes);
+    // The bucket arrays are sized by allocate for the levels of the last graph, so they are allocated again
+    excessBuckets.free();
+    excessBuckets.init(nodes, ptrs, numNodes);
+    orphan3PassBuckets.free();
+    orphan3PassBuckets.init(nodes, numNodes);
+    orphanBuckets.free();
+    orphanBuckets.init(nodes, numNodes);
 
-    // init members
+    // init members like the constructor
+    arcIter = NULL;
+    incLen = 0;
+    incIteration = 0;
+    uniqOrphansS = uniqOrphansT = 0;
+    augTimestamp = 0;
+    topLevelS = topLevelT = 0;
     flow = 0;
+    testFlow = 0;
+    testExcess = 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initNodes()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initNodes()
 {
     NodeIdx i = 0;
     for (Node *x = nodes; x <= nodeEnd; ++x, ++i) {
@@ -994,9 +1020,10 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initNodes()
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraphFast()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initGraphFast()
 {
+    TRACE_PHASE(INIT);
     Node *x;
     TmpEdge *te;
 
@@ -1030,9 +1057,9 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraphFast()
 }
 
 // @ret: minimum orphan level
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  int64_t IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentPath(NodeIdx i, Cap push)
+inline  int64_t IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentPath(NodeIdx i, Cap push)
 {
     int64_t orphanMinLevel = (sTree ? topLevelS : topLevelT) + 1;
 
@@ -1078,9 +1105,9 @@ inline  int64_t IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentPath(NodeIdx
 }
 
 // @ret: minimum level in which created an orphan
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  int64_t IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcess(NodeIdx i, Cap push)
+inline  int64_t IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentExcess(NodeIdx i, Cap push)
 {
     int64_t orphanMinLevel = (sTree ? topLevelS : topLevelT) + 1;
     augTimestamp++;
@@ -1172,9 +1199,9 @@ inline  int64_t IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcess(NodeI
     return orphanMinLevel;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcesses()
+inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentExcesses()
 {
     NodeIdx i;
     int64_t minOrphanLevel;
@@ -1203,11 +1230,14 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcesses()
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augment(ArcIdx bridge_idx)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augment(ArcIdx bridge_idx)
 {
+    TRACE_PHASE(AUGMENT);
     Arc& bridge = arcs[bridge_idx];
     Arc& sister_bridge = sister(bridge_idx);
+    // Labels are the distances to the terminals, so this includes the bridge and the terminal arcs
+    opCounter.augmentation(int64_t(nodes[sister_bridge.head].label) - nodes[bridge.head].label + 1);
     Cap bottleneck, bottleneckT, bottleneckS;
     bool forceBottleneck = false;
 
@@ -1294,10 +1324,11 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augment(ArcIdx bridge_
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromLevel, bool toTop)
+inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::adoption(int64_t fromLevel, bool toTop)
 {
+    TRACE_PHASE(ADOPT);
     ArcIdx ai;
     int64_t threePassLevel;
     int64_t minLabel, numOrphans, numOrphansUniq;
@@ -1312,6 +1343,7 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromL
         NodeIdx i;
         while ((i = orphanBuckets.popFront(level)) != INVALID_NODE) {
             Node& x = nodes[i];
+            opCounter.orphan();
             numOrphans++;
             if (x.lastAugTimestamp != augTimestamp) {
                 x.lastAugTimestamp = augTimestamp;
@@ -1341,6 +1373,7 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromL
             if (x.label != (sTree ? 1 : -1)) {
                 minLabel = x.label - (sTree ? 1 : -1);
                 for (; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     Node& y = nodes[a.head];
                     if ((sTree ? a.isRevResidual : a.rCap) != 0 && y.label == minLabel) {
@@ -1351,6 +1384,7 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromL
                 }
             }
             if (x.parent != INVALID_ARC) {
+                opCounter.adoption();
                 if (x.excess) {
                     excessBuckets.template add<sTree>(i);
                 }
@@ -1397,6 +1431,7 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromL
             minLabel = (sTree ? topLevelS : -topLevelT);
             if (x.label != minLabel) {
                 for (ai = x.firstArc; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     const Node& y = nodes[a.head];
                     if ((sTree ? a.isRevResidual : a.rCap) &&
@@ -1416,6 +1451,8 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromL
             // (3) relabel onto new parent
             //
             if (x.parent != INVALID_ARC) {
+                opCounter.adoption();
+                opCounter.relabel();
                 x.label = minLabel + (sTree ? 1 : -1);
                 add_sibling(i, arcs[x.parent].head);
                 // add to active list of the next growth phase
@@ -1445,9 +1482,9 @@ inline  void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromL
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t minBucket)
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::adoption3Pass(int64_t minBucket)
 {
     int64_t minLabel, destLabel;
 
@@ -1462,6 +1499,7 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t m
                 minLabel = (sTree ? topLevelS : -topLevelT);
                 destLabel = x.label - (sTree ? 1 : -1);
                 for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     Arc& a = arcs[ai];
                     const Node& y = nodes[a.head];
                     if ((sTree ? a.isRevResidual : a.rCap) &&
@@ -1493,6 +1531,7 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t m
             if (x.label != (sTree ? topLevelS : -topLevelT)) {
                 minLabel = x.label + (sTree ? 1 : -1);
                 for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     Node& y = nodes[a.head];
 
@@ -1513,6 +1552,8 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t m
             }
 
             // relabel onto new parent
+            opCounter.adoption();
+            opCounter.relabel();
             add_sibling(i, arcs[x.parent].head);
             x.isParentCurr = false;
             if (x.excess) {
@@ -1535,10 +1576,11 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t m
     orphan3PassBuckets.maxBucket = 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool dirS>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::growth()
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::growth()
 {
+    TRACE_PHASE(GROWTH);
     // TODO: This loop could be written in a better way
     for (NodeIdx *active = active0.list; active != (active0.list + active0.len); active++) {
         // get active node
@@ -1549,10 +1591,12 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::growth()
         if (x.label != (dirS ? (topLevelS - 1) : -(topLevelT - 1))) {
             continue;
         }
+        opCounter.growth_step();
 
         // grow or augment
         ArcIdx a_end = nodes[i + 1].firstArc;
         for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
+            opCounter.arcs_scanned();
             Arc& a = arcs[ai];
             if (!(dirS ? a.rCap : a.isRevResidual)) {
                 continue;
@@ -1585,9 +1629,9 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::growth()
     active0.clear();
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentIncrements()
+inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentIncrements()
 {
     NodeIdx *end = incList + incLen;
     int64_t minOrphanLevel = 1 << 30;
@@ -1642,22 +1686,24 @@ inline void IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentIncrements()
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow()
 {
     return computeMaxFlow(true, false);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow(bool allowIncrements)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow(bool allowIncrements)
 {
     return computeMaxFlow(true, allowIncrements);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow IBFSGraph<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow(
     bool initialDirS, bool allowIncrements)
 {
+    opCounter.reset();
+    TRACE_PHASE(SOLVE);
     // incremental?
     if (incIteration >= 1 && incList != NULL) {
         augmentIncrements<true>();
@@ -58,12 +58,15 @@ If you require another license, please contact the above.
 #include <algorithm>
 #include <type_traits>
 #include <cassert>
+#include <vector>
 
 #include "util.h"
+#include "../op_stats.h"
+#include "../phase_trace.h"
 
 namespace reimpls {
 
-template <class Cap, class Term, class Flow, class NodeIdx = uint32_t, class ArcIdx = uint32_t>
+template <class Cap, class Term, class Flow, class NodeIdx = uint32_t, class ArcIdx = uint32_t, bool CountOps = false>
 class IBFSGraph2 {
     static constexpr size_t ALLOC_INIT_LEVELS = 4096;
 
@@ -87,7 +90,9 @@ public:
     IBFSGraph2(int64_t numNodes, int64_t numEdges);
     ~IBFSGraph2();
     void initSize(int64_t numNodes, int64_t numEdges);
-    void reset();
+    // Empties the graph for numNodes nodes and numEdges edges, which must not be more than given to initSize. The
+    // arrays allocated by initSize are reused.
+    void reset(int64_t numNodes, int64_t numEdges);
     void addEdge(NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity);
     void addNode(NodeIdx node, Term capSource, Term capSink);
     void incEdge(NodeIdx from, NodeIdx fo, Cap capacity, Cap revCapacity);
@@ -100,9 +105,17 @@ public:
     void resetTrees();
 
     inline Flow getFlow() const noexcept { return flow; }
+    // Operation counts of the last computeMaxFlow, all zero unless CountOps is true
+    inline OpStats getOpStats() const { return opCounter.get(); }
     inline size_t getNumNodes() const noexcept { return nodeEnd - nodes; }
     inline size_t getNumArcs() const noexcept { return arcEnd - arcs; }
     int isNodeOnSrcSide(NodeIdx node, int freeNodeValue = 0);
+    // Side of nodes in neither tree after computeMaxFlow. The tree which stopped growing is complete, so
+    // free nodes are on the side of the other one.
+    inline int freeNodeSide() const { return activeS1.len == 0 ? 0 : 1; }
+    // Same as isNodeOnSrcSide for all nodes, with free nodes on freeNodeSide(): cut[i] = 1 if node i is on
+    // the source side and 0 otherwise
+    void getCut(std::vector<uint8_t>& cut) const;
 
 #pragma pack (1)
     struct REIMPLS_PACKED Arc {
@@ -143,6 +156,7 @@ private:
     Buckets3Pass orphan3PassBuckets;
     BucketsOneSided orphanBuckets;
     ExcessBuckets excessBuckets;
+    OpCounter<CountOps> opCounter;
     char *memArcs;
 
     void add_half_edge(NodeIdx from, NodeIdx to, Cap cap);
@@ -593,8 +607,8 @@ private:
     void initNodes();
 };
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::IBFSGraph2() :
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IBFSGraph2() :
     init_n_nodes(0),
     init_n_edges(0),
     arcIter(NULL),
@@ -616,15 +630,15 @@ inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::IBFSGraph2() :
     ptrs(NULL)
 {}
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::IBFSGraph2(int64_t numNodes, int64_t numEdges) :
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IBFSGraph2(int64_t numNodes, int64_t numEdges) :
     IBFSGraph2()
 {
     initSize(numNodes, numEdges);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::~IBFSGraph2()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::~IBFSGraph2()
 {
     delete[]nodes;
     delete[]memArcs;
@@ -633,8 +647,8 @@ inline IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::~IBFSGraph2()
     excessBuckets.free();
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::addNode(NodeIdx node, Term capSource, Term capSink)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::addNode(NodeIdx node, Term capSource, Term capSink)
 {
     Cap f = nodes[node].excess;
     if (f > 0) {
@@ -652,15 +666,15 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::addNode(NodeIdx node,
 }
 
 // @pre: activeS1.len == 0 && activeT1.len == 0
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::resetTrees()
 {
     resetTrees(1, 1);
 }
 
 // @pre: activeS1.len == 0 && activeT1.len == 0
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::resetTrees(
     int64_t newTopLevelS, int64_t newTopLevelT)
 {
     uniqOrphansS = uniqOrphansT = 0;
@@ -690,8 +704,8 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::remove_sibling(NodeIdx i)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::remove_sibling(NodeIdx i)
 {
     // TODO: This can very likely be made more readable!
     Node& parent = parent_node(i);
@@ -706,15 +720,15 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::remove_sibling(NodeIdx
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::add_sibling(NodeIdx i, NodeIdx parent)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::add_sibling(NodeIdx i, NodeIdx parent)
 {
     nodes[i].nextNode = nodes[parent].firstSon;
     nodes[parent].firstSon = i;
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::print_graph(std::FILE *file) const
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::print_graph(std::FILE *file) const
 {
     const NodeIdx num_nodes = nodeEnd - nodes;
     const NodeIdx num_arcs = arcEnd - arcs;
@@ -732,15 +746,15 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::print_graph(std::FILE
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline bool IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incShouldResetTrees()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline bool IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incShouldResetTrees()
 {
     // TODO: Make sure uniqOrphansS + uniqOrphansT can be compared to int64_t
     return (uniqOrphansS + uniqOrphansT) >= 2 * numNodes;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incNode(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incNode(
     NodeIdx node, Term deltaCapSource, Term deltaCapSink)
 {
     Node& x = nodes[node];
@@ -779,8 +793,8 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incNode(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incArc(ArcIdx ai, Cap deltaCap)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incArc(ArcIdx ai, Cap deltaCap)
 {
     if (deltaCap == 0) {
         return;
@@ -829,8 +843,8 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incArc(ArcIdx ai, Cap
     a.isRevResidual = sister.rCap != 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::addEdge(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::addEdge(
     NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity)
 {
     assert((arcEnd - arcs) % 2 == 0);
@@ -838,8 +852,8 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::addEdge(
     add_half_edge(to, from, revCapacity);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incEdge(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incEdge(
     NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity)
 {
     Node& x = nodes[from];
@@ -865,8 +879,8 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::incEdge(
     incArc(arcIter->rev, revCapacity);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline int IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::isNodeOnSrcSide(NodeIdx node, int freeNodeValue)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline int IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::isNodeOnSrcSide(NodeIdx node, int freeNodeValue)
 {
     if (nodes[node].label == 0) {
         return freeNodeValue;
@@ -874,15 +888,25 @@ inline int IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::isNodeOnSrcSide(NodeIdx
     return (nodes[node].label > 0 ? 1 : 0);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraph()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::getCut(std::vector<uint8_t>& cut) const
+{
+    const uint8_t freeValue = freeNodeSide();
+    cut.resize(nodeEnd - nodes);
+    for (const Node *x = nodes; x != nodeEnd; ++x) {
+        cut[x - nodes] = x->label == 0 ? freeValue : (x->label > 0 ? 1 : 0);
+    }
+}
+
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initGraph()
 {
     initGraphFast();
     topLevelS = topLevelT = 1;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::initSize(int64_t numNodes, int64_t numEdges)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initSize(int64_t numNodes, int64_t numEdges)
 {
     init_n_nodes = numNodes;
     init_n_edges = numEdges;
@@ -912,45 +936,42 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::initSize(int64_t numNo
     arcEnd = arcs;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::reset()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::reset(int64_t numNodes, int64_t numEdges)
 {
-    // compute allocation size
-    // uint64_t arcTmpMemsize = (uint64_t)sizeof(TmpEdge) * (uint64_t)init_n_edges;
-    //uint64_t arcMemsize = (uint64_t)sizeof(Arc) * (uint64_t)(init_n_edges * 2);
-    //uint64_t nodeMemsize = (uint64_t)sizeof(NodeIdx) * (uint64_t)(init_n_nodes * 5);
-    //uint64_t arcMemsize = 0;
-    //arcMemsize = arcRealMemsize + arcTmpMemsize;
-    //if (arcMemsize < (arcRealMemsize + nodeMemsize)) {
-    //    arcMemsize = (arcRealMemsize + nodeMemsize);
-    //}
-
-    // alocate arcs
-    //tmpEdges = (TmpEdge*)(memArcs + arcRealMemsize);
-    //tmpEdgeLast = tmpEdges; // will advance as edges are added
+    assert(isInitializedGraph() && numNodes <= init_n_nodes && numEdges <= init_n_edges);
+    // Same layout as initSize. Both parts shrink with the sizes, so they fit the arrays allocated there.
     arcs = (Arc*)memArcs;
-    arcEnd = arcs + init_n_edges * 2;
+    arcEnd = arcs + numEdges * 2;
 
-    // allocate nodes
-    this->init_n_nodes = init_n_nodes;
-    //memset(nodes, 0, sizeof(Node) * (init_n_nodes + 1));
-    nodeEnd = nodes + init_n_nodes;
-    // TODO: This likely uses too much memory
+    this->numNodes = numNodes;
+    std::fill(nodes, nodes + numNodes + 1, Node());
+    nodeEnd = nodes + numNodes;
     active0.init((NodeIdx*)(arcEnd));
-    activeS1.init((NodeIdx*)(arcEnd)+init_n_nodes);
-    activeT1.init((NodeIdx*)(arcEnd)+(2 * init_n_nodes));
-    ptrs = (NodeIdx*)(arcEnd)+(3 * init_n_nodes);
-    excessBuckets.init_NoAlloc(nodes, ptrs, init_n_nodes);
-    orphan3PassBuckets.init_NoAlloc(nodes, init_n_nodes);
-    orphanBuckets.init_NoAlloc(nodes, init_n_nodes);
+    activeS1.init((NodeIdx*)(arcEnd)+numNodes);
+    activeT1.init((NodeIdx*)(arcEnd)+(2 * numNodes));
+    ptrs = (NodeIdx*)(arcEnd)+(3 * numNodes);
+    // The bucket arrays are sized by allocate for the levels of the last graph, so they are allocated again
+    excessBuckets.free();
+    excessBuckets.init(nodes, ptrs, numNodes);
+    orphan3PassBuckets.free();
+    orphan3PassBuckets.init(nodes, numNodes);
+    orphanBuckets.free();
+    orphanBuckets.init(nodes, numNodes);
 
-    // init members
+    // init members like the constructor
+    arcIter = NULL;
+    incLen = 0;
+    incIteration = 0;
+    uniqOrphansS = uniqOrphansT = 0;
+    augTimestamp = 0;
+    topLevelS = topLevelT = 0;
     flow = 0;
     arcEnd = arcs;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::initNodes()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initNodes()
 {
     NodeIdx i = 0;
     for (Node *x = nodes; x <= nodeEnd; ++x, ++i) {
@@ -969,16 +990,17 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::initNodes()
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraphFast()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initGraphFast()
 {
+    TRACE_PHASE(INIT);
     initNodes();
 }
 
 // @ret: minimum orphan level
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  int64_t IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentPath(NodeIdx i, Cap push)
+inline  int64_t IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentPath(NodeIdx i, Cap push)
 {
     int64_t orphanMinLevel = (sTree ? topLevelS : topLevelT) + 1;
 
@@ -1017,9 +1039,9 @@ inline  int64_t IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentPath(NodeId
 }
 
 // @ret: minimum level in which created an orphan
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  int64_t IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcess(NodeIdx i, Cap push)
+inline  int64_t IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentExcess(NodeIdx i, Cap push)
 {
     int64_t orphanMinLevel = (sTree ? topLevelS : topLevelT) + 1;
     augTimestamp++;
@@ -1104,9 +1126,9 @@ inline  int64_t IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcess(Node
     return orphanMinLevel;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcesses()
+inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentExcesses()
 {
     NodeIdx i;
     int64_t minOrphanLevel;
@@ -1135,8 +1157,8 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentExcesses()
     }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::add_half_edge(NodeIdx from, NodeIdx to, Cap cap)
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::add_half_edge(NodeIdx from, NodeIdx to, Cap cap)
 {
     arcEnd->head = to;
     arcEnd->next = nodes[from].firstArc;
@@ -1146,11 +1168,14 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::add_half_edge(NodeIdx
     arcEnd++;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augment(ArcIdx bridge_idx)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augment(ArcIdx bridge_idx)
 {
+    TRACE_PHASE(AUGMENT);
     Arc& bridge = arcs[bridge_idx];
     Arc& sister_bridge = sister(bridge_idx);
+    // Labels are the distances to the terminals, so this includes the bridge and the terminal arcs
+    opCounter.augmentation(int64_t(nodes[sister_bridge.head].label) - nodes[bridge.head].label + 1);
     Cap bottleneck, bottleneckT, bottleneckS;
     bool forceBottleneck = false;
 
@@ -1233,10 +1258,11 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augment(ArcIdx bridge
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t fromLevel, bool toTop)
+inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::adoption(int64_t fromLevel, bool toTop)
 {
+    TRACE_PHASE(ADOPT);
     ArcIdx ai;
     int64_t threePassLevel;
     int64_t minLabel, numOrphans, numOrphansUniq;
@@ -1251,6 +1277,7 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t from
         NodeIdx i;
         while ((i = orphanBuckets.popFront(level)) != INVALID_NODE) {
             Node& x = nodes[i];
+            opCounter.orphan();
             numOrphans++;
             if (x.lastAugTimestamp != augTimestamp) {
                 x.lastAugTimestamp = augTimestamp;
@@ -1281,6 +1308,7 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t from
                 minLabel = x.label - (sTree ? 1 : -1);
                 //for (; ai != a_end; ai++) {
                 for (; ai != INVALID_ARC; ai = arcs[ai].next) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     Node& y = nodes[a.head];
                     if (sister_or_arc(ai, sTree).rCap && y.label == minLabel) {
@@ -1291,6 +1319,7 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t from
                 }
             }
             if (x.parent != INVALID_ARC) {
+                opCounter.adoption();
                 if (x.excess) {
                     excessBuckets.template add<sTree>(i);
                 }
@@ -1338,6 +1367,7 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t from
             if (x.label != minLabel) {
                 //for (ai = x.firstArc; ai != a_end; ai++) {
                 for (ai = x.firstArc; ai != INVALID_ARC; ai = arcs[ai].next) {
+                    opCounter.arcs_scanned();
                     const Node& y = head_node(ai);
                     if (sister_or_arc(ai, sTree).rCap &&
                         // y->label != 0 ---> holds implicitly
@@ -1356,6 +1386,8 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t from
             // (3) relabel onto new parent
             //
             if (x.parent != INVALID_ARC) {
+                opCounter.adoption();
+                opCounter.relabel();
                 x.label = minLabel + (sTree ? 1 : -1);
                 add_sibling(i, arcs[x.parent].head);
                 // add to active list of the next growth phase
@@ -1385,9 +1417,9 @@ inline  void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption(int64_t from
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t minBucket)
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::adoption3Pass(int64_t minBucket)
 {
     int64_t minLabel, destLabel;
 
@@ -1402,6 +1434,7 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t
                 destLabel = x.label - (sTree ? 1 : -1);
                 //for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
                 for (ArcIdx ai = x.firstArc; ai != INVALID_ARC; ai = arcs[ai].next) {
+                    opCounter.arcs_scanned();
                     Arc& a = arcs[ai];
                     const Node& y = nodes[a.head];
                     if (sister_or_arc(ai, sTree).rCap &&
@@ -1434,6 +1467,7 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t
                 minLabel = x.label + (sTree ? 1 : -1);
                 //for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
                 for (ArcIdx ai = x.firstArc; ai != INVALID_ARC; ai = arcs[ai].next) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     Node& y = nodes[a.head];
 
@@ -1453,6 +1487,8 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t
             }
 
             // relabel onto new parent
+            opCounter.adoption();
+            opCounter.relabel();
             add_sibling(i, arcs[x.parent].head);
             x.isParentCurr = false;
             if (x.excess) {
@@ -1475,10 +1511,11 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::adoption3Pass(int64_t
     orphan3PassBuckets.maxBucket = 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool dirS>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::growth()
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::growth()
 {
+    TRACE_PHASE(GROWTH);
     // TODO: This loop could be written in a better way
     for (NodeIdx *active = active0.list; active != (active0.list + active0.len); active++) {
         // get active node
@@ -1489,12 +1526,14 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::growth()
         if (x.label != (dirS ? (topLevelS - 1) : -(topLevelT - 1))) {
             continue;
         }
+        opCounter.growth_step();
 
         // grow or augment
         //ArcIdx a_end = nodes[i + 1].firstArc;
         //for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
         ArcIdx next;
         for (ArcIdx ai = x.firstArc; ai != INVALID_ARC; ai = next) {
+            opCounter.arcs_scanned();
             Arc& a = arcs[ai];
             next = a.next;
             //if (!(dirS ? a.rCap : a.isRevResidual)) {
@@ -1531,9 +1570,9 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::growth()
     active0.clear();
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentIncrements()
+inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::augmentIncrements()
 {
     NodeIdx *end = incList + incLen;
     int64_t minOrphanLevel = 1 << 30;
@@ -1589,22 +1628,24 @@ inline void IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::augmentIncrements()
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow()
 {
     return computeMaxFlow(true, false);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow(bool allowIncrements)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow(bool allowIncrements)
 {
     return computeMaxFlow(true, allowIncrements);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow IBFSGraph2<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow(
     bool initialDirS, bool allowIncrements)
 {
+    opCounter.reset();
+    TRACE_PHASE(SOLVE);
     // incremental?
     if (incIteration >= 1 && incList != NULL) {
         augmentIncrements<true>();
@@ -35,6 +35,9 @@
 #include <vector>
 #include <cinttypes>
 
+#include "../op_stats.h"
+#include "../phase_trace.h"
+
 namespace reimpls {
 
 enum class LabelOrder {
@@ -48,7 +51,7 @@ enum class RootOrder {
 };
 
 template <class Cap, LabelOrder LABEL_ORDER = LabelOrder::HIGHEST_FIRST,
-    RootOrder ROOT_ORDER = RootOrder::FIFO>
+    RootOrder ROOT_ORDER = RootOrder::FIFO, bool COUNT_OPS = false>
 class Hpf {
     // Forward decls.
     struct Node;
@@ -63,6 +66,9 @@ public:
 
     Hpf(size_t expectedNodes = 0, size_t expectedArcs = 0);
 
+    // Removes all nodes and edges but keeps the memory, so a graph of the same size can be built again
+    void reset();
+
     void reserve_nodes(size_t num);
     void reserve_edges(size_t num);
 
@@ -73,9 +79,14 @@ public:
     void mincut();
 
     TermType what_label(uint32_t node) const;
+    // Same as what_label for all nodes: cut[i] = 1 if node i is on the SOURCE side and 0 otherwise
+    void get_cut(std::vector<uint8_t>& cut) const;
     Cap compute_maxflow() const noexcept;
     void recover_flow();
 
+    // Operation counts of the last mincut, all zero unless COUNT_OPS is true
+    OpStats get_op_stats() const { return opCounter.get(); }
+
     inline void set_source(uint32_t s) { source = s; }
     inline void set_sink(uint32_t t) { sink = t; }
 
@@ -97,6 +108,8 @@ private:
     std::vector<Arc> arcList;
     std::vector<Arc *> outOfTreePtrs;
 
+    OpCounter<COUNT_OPS> opCounter;
+
     void init_mincut();
 
     uint32_t gap() const noexcept;
@@ -188,8 +201,8 @@ private:
     };
 };
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Hpf(size_t expectedNodes, size_t expectedArcs) :
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::Hpf(size_t expectedNodes, size_t expectedArcs) :
     numNodes(0),
     numArcs(0),
     source(0),
@@ -208,23 +221,41 @@ inline Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Hpf(size_t expectedNodes, size_t expec
     reserve_edges(expectedArcs);
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::reserve_nodes(size_t num)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::reset()
+{
+    numNodes = 0;
+    numArcs = 0;
+    source = 0;
+    sink = 0;
+    first = 0;
+    last = 0;
+    highestStrongLabel = 1;
+    lowestStrongLabel = 1;
+    adjacencyList.clear();
+    strongRoots.clear();
+    labelCount.clear();
+    arcList.clear();
+    outOfTreePtrs.clear();
+}
+
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::reserve_nodes(size_t num)
 {
     adjacencyList.reserve(num);
     strongRoots.reserve(num);
     labelCount.reserve(num);
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::reserve_edges(size_t num)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::reserve_edges(size_t num)
 {
     arcList.reserve(num);
     outOfTreePtrs.reserve(num * 2);
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline uint32_t Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::add_node(uint32_t num)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline uint32_t Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::add_node(uint32_t num)
 {
     numNodes += num;
     adjacencyList.resize(numNodes);
@@ -233,8 +264,8 @@ inline uint32_t Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::add_node(uint32_t num)
     return numNodes;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::add_edge(uint32_t from, uint32_t to, Cap capacity)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::add_edge(uint32_t from, uint32_t to, Cap capacity)
 {
     arcList.emplace_back(
         &adjacencyList[from],
@@ -246,9 +277,11 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::add_edge(uint32_t from, uint32_t
     numArcs++;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::mincut()
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::mincut()
 {
+    opCounter.reset();
+    TRACE_PHASE(SOLVE);
     init_mincut();
 
     // pseudoflowPhase1
@@ -259,15 +292,25 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::mincut()
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::TermType Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::what_label(
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::TermType Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::what_label(
     uint32_t node) const
 {
     return adjacencyList[node].label >= gap() ? SOURCE : SINK;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline Cap Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::compute_maxflow() const noexcept
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::get_cut(std::vector<uint8_t>& cut) const
+{
+    const uint32_t g = gap();
+    cut.resize(numNodes);
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        cut[i] = adjacencyList[i].label >= g ? 1 : 0;
+    }
+}
+
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline Cap Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::compute_maxflow() const noexcept
 {
     Cap cut = 0;
 
@@ -281,8 +324,8 @@ inline Cap Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::compute_maxflow() const noexcept
     return cut;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::recover_flow()
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::recover_flow()
 {
     uint32_t i, j, iteration = 1;
     Arc *tempArc;
@@ -345,9 +388,10 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::recover_flow()
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::init_mincut()
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::init_mincut()
 {
+    TRACE_PHASE(INIT);
     outOfTreePtrs.resize(2 * arcList.size());
     Arc **crntOutOfTree = outOfTreePtrs.data();
     for (uint32_t i = 0; i < numNodes; ++i) {
@@ -406,14 +450,14 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::init_mincut()
     labelCount[0] = (numNodes - 2) - labelCount[1];
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline uint32_t Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::gap() const noexcept
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline uint32_t Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::gap() const noexcept
 {
     return LABEL_ORDER == LabelOrder::LOWEST_FIRST ? lowestStrongLabel : numNodes;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::decompose(
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::decompose(
     Node * excessNode, const uint32_t source, uint32_t * iteration)
 {
     Node *current = excessNode;
@@ -479,8 +523,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::decompose(
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::sort(Node * current)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::sort(Node * current)
 {
     // TODO: Just use the sort algorithm from the standard, since that's also quicksort
     if (current->numOutOfTree > 1) {
@@ -488,8 +532,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::sort(Node * current)
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::minisort(Node * current)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::minisort(Node * current)
 {
     Arc *temp = current->outOfTree[current->nextArc];
     uint32_t i, size = current->numOutOfTree, tempflow = temp->flow;
@@ -500,8 +544,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::minisort(Node * current)
     current->outOfTree[i - 1] = temp;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::quickSort(
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::quickSort(
     Arc * *arr, const uint32_t first, const uint32_t last)
 {
     uint32_t i, j, left = first, right = last, x1, x2, x3, mid, pivot, pivotval;
@@ -584,8 +628,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::quickSort(
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::addToStrongBucket(Node *newRoot, Root *rootBucket)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::addToStrongBucket(Node *newRoot, Root *rootBucket)
 {
     if (ROOT_ORDER == RootOrder::FIFO) {
         if (rootBucket->start) {
@@ -603,9 +647,9 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::addToStrongBucket(Node *newRoot,
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Node *
-Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getHighestStrongRoot()
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::Node *
+Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::getHighestStrongRoot()
 {
     uint32_t i;
     Node *strongRoot;
@@ -620,6 +664,7 @@ Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getHighestStrongRoot()
                 return strongRoot;
             }
 
+            opCounter.gap();
             while (strongRoots[i].start) {
                 strongRoot = strongRoots[i].start;
                 strongRoots[i].start = strongRoot->next;
@@ -651,9 +696,9 @@ Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getHighestStrongRoot()
     return strongRoot;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Node *
-Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getLowestStrongRoot()
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::Node *
+Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::getLowestStrongRoot()
 {
     uint32_t i;
     Node *strongRoot;
@@ -679,6 +724,7 @@ Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getLowestStrongRoot()
             lowestStrongLabel = i;
 
             if (labelCount[i - 1] == 0) {
+                opCounter.gap();
                 return nullptr;
             }
 
@@ -693,9 +739,9 @@ Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getLowestStrongRoot()
     return nullptr;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Node *
-Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getNextStrongRoot()
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::Node *
+Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::getNextStrongRoot()
 {
     if (LABEL_ORDER == LabelOrder::LOWEST_FIRST) {
         return getLowestStrongRoot();
@@ -704,9 +750,10 @@ Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::getNextStrongRoot()
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::processRoot(Node *strongRoot)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::processRoot(Node *strongRoot)
 {
+    TRACE_PHASE(DISCHARGE);
     Node *temp, *strongNode = strongRoot, *weakNode;
     Arc *out;
 
@@ -748,8 +795,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::processRoot(Node *strongRoot)
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Arc *Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::findWeakNode(
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::Arc *Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::findWeakNode(
     Node *strongNode, Node **weakNode)
 {
     uint32_t i, size;
@@ -759,7 +806,9 @@ inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Arc *Hpf<Cap, LABEL_ORDER, RO
         lowestStrongLabel : highestStrongLabel;
     size = strongNode->numOutOfTree;
 
+    opCounter.growth_step();
     for (i = strongNode->nextArc; i < size; ++i) {
+        opCounter.arcs_scanned();
         if (strongNode->outOfTree[i]->to->label == (extremumStrongLabel - 1)) {
             strongNode->nextArc = i;
             out = strongNode->outOfTree[i];
@@ -782,8 +831,8 @@ inline typename Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Arc *Hpf<Cap, LABEL_ORDER, RO
     return nullptr;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::merge(Node *parent, Node *child, Arc *newArc)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::merge(Node *parent, Node *child, Arc *newArc)
 {
     Arc *oldArc;
     Node *current = child, *oldParent, *newParent = parent;
@@ -804,16 +853,16 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::merge(Node *parent, Node *child,
     addRelationship(newParent, current);
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::addRelationship(Node * newParent, Node * child)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::addRelationship(Node * newParent, Node * child)
 {
     child->parent = newParent;
     child->next = newParent->childList;
     newParent->childList = child;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::breakRelationship(Node * oldParent, Node * child)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::breakRelationship(Node * oldParent, Node * child)
 {
     Node *current;
 
@@ -833,9 +882,10 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::breakRelationship(Node * oldParen
     child->next = nullptr;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::pushExcess(Node *strongRoot)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::pushExcess(Node *strongRoot)
 {
+    TRACE_PHASE(AUGMENT);
     Node *current, *parent;
     Arc *arcToParent;
     int prevEx = 1;
@@ -861,10 +911,11 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::pushExcess(Node *strongRoot)
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::pushUpward(
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::pushUpward(
     Arc *currentArc, Node *child, Node *parent, Cap resCap)
 {
+    opCounter.push();
     if (resCap >= child->excess) {
         parent->excess += child->excess;
         currentArc->flow += child->excess;
@@ -887,10 +938,11 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::pushUpward(
     addToStrongBucket(child, &strongRoots[child->label]);
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::pushDownward(
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::pushDownward(
     Arc *currentArc, Node *child, Node *parent, Cap flow)
 {
+    opCounter.push();
     if (flow >= child->excess) {
         parent->excess += child->excess;
         currentArc->flow -= child->excess;
@@ -913,8 +965,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::pushDownward(
     addToStrongBucket(child, &strongRoots[child->label]);
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::checkChildren(Node *curNode)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::checkChildren(Node *curNode)
 {
     for (; curNode->nextScan; curNode->nextScan = curNode->nextScan->next) {
         if (curNode->nextScan->label == curNode->label) {
@@ -922,6 +974,7 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::checkChildren(Node *curNode)
         }
     }
 
+    opCounter.relabel();
     --labelCount[curNode->label];
     ++curNode->label;
     ++labelCount[curNode->label];
@@ -929,9 +982,10 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::checkChildren(Node *curNode)
     curNode->nextArc = 0;
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::liftAll(Node *rootNode)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::liftAll(Node *rootNode)
 {
+    TRACE_PHASE(GAP);
     Node *temp, *current = rootNode;
 
     current->nextScan = current->childList;
@@ -952,8 +1006,8 @@ inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::liftAll(Node *rootNode)
     }
 }
 
-template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER>
-inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER>::Node::addOutOfTree(Arc *out)
+template <class Cap, LabelOrder LABEL_ORDER, RootOrder ROOT_ORDER, bool COUNT_OPS>
+inline void Hpf<Cap, LABEL_ORDER, ROOT_ORDER, COUNT_OPS>::Node::addOutOfTree(Arc *out)
 {
     outOfTree[numOutOfTree] = out;
     numOutOfTree++;
@@ -14,6 +14,7 @@
 #include <type_traits>
 
 #include "util.h"
+#include "../op_stats.h"
 
 namespace std {
 
@@ -53,7 +54,7 @@ enum NodeArcSorting : int32_t {
     CLUSTER = 6
 };
 
-template <class Cap, class Term, class Flow, class ArcIdx = uint32_t, class NodeIdx = uint32_t>
+template <class Cap, class Term, class Flow, class ArcIdx = uint32_t, class NodeIdx = uint32_t, bool CountOps = false>
 class ParallelGraph {
     static_assert(std::is_integral<ArcIdx>::value, "ArcIdx must be an integer type");
     static_assert(std::is_integral<NodeIdx>::value, "NodeIdx must be an integer type");
@@ -82,10 +83,15 @@ public:
     void add_edge(NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap, bool merge_duplicates = true);
 
     TermType what_segment(NodeIdx i, TermType default_segment = SOURCE) const;
+    // Same as what_segment for all nodes: cut[i] = 1 if node i is in the SOURCE segment and 0 otherwise
+    void get_cut(std::vector<uint8_t>& cut, TermType default_segment = SOURCE) const;
 
     Flow maxflow();
     void init_maxflow();
 
+    // Operation counts of the last maxflow call summed over all blocks, all zero unless CountOps is true
+    OpStats get_op_stats() const;
+
     inline size_t get_node_num() const noexcept { return nodes.size(); }
     inline size_t get_arc_num() const noexcept { return arcs.size(); }
 
@@ -136,6 +142,8 @@ private:
 
         Time time;
 
+        OpCounter<CountOps> op_counter;
+
         GraphBlock(std::vector<Node>& nodes, std::vector<Arc>& arcs, std::vector<BlockIdx>& node_blocks,
             BlockIdx self) :
             nodes(nodes),
@@ -148,7 +156,8 @@ private:
             first_active(INVALID_NODE),
             last_active(INVALID_NODE),
             orphan_nodes(),
-            time(0) {}
+            time(0),
+            op_counter() {}
 
         Flow maxflow();
         void init_maxflow();
@@ -161,7 +170,7 @@ private:
 
         void augment(ArcIdx middle);
         Term tree_bottleneck(NodeIdx start, bool source_tree) const;
-        void augment_tree(NodeIdx start, Term bottleneck, bool source_tree);
+        size_t augment_tree(NodeIdx start, Term bottleneck, bool source_tree);
 
         ArcIdx grow_search_tree(NodeIdx start);
         template <bool source> ArcIdx grow_search_tree_impl(NodeIdx start);
@@ -244,8 +253,8 @@ private:
 };
 
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::ParallelGraph(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::ParallelGraph(
     size_t expected_nodes, size_t expected_arcs, size_t expected_blocks) :
     ph1_dur(),
     bs_dur(),
@@ -266,8 +275,8 @@ ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::ParallelGraph(
 }
 
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline NodeIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_node(size_t num, BlockIdx block)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline NodeIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_node(size_t num, BlockIdx block)
 {
     assert(nodes.size() == node_blocks.size());
     NodeIdx crnt = nodes.size();
@@ -291,8 +300,8 @@ inline NodeIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_node(size_t
     return crnt;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_tweights(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_tweights(
     NodeIdx i, Term cap_source, Term cap_sink)
 {
     assert(i >= 0 && i < nodes.size());
@@ -307,8 +316,8 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_tweights(
     nodes[i].tr_cap = cap_source - cap_sink;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_edge(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_edge(
     NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap, bool merge_duplicates)
 {
     assert(i >= 0 && i < nodes.size());
@@ -342,8 +351,8 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_edge(
     }
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_half_edge(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_half_edge(
     NodeIdx from, NodeIdx to, Cap cap, bool merge_duplicates)
 {
     ArcIdx ai;
@@ -414,8 +423,8 @@ inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_half_edge(
     // return ai;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline TermType ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::what_segment(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline TermType ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::what_segment(
     NodeIdx i, TermType default_segment) const
 {
     assert(i >= 0 && i < nodes.size());
@@ -426,8 +435,20 @@ inline TermType ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::what_segment(
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow()
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::get_cut(
+    std::vector<uint8_t>& cut, TermType default_segment) const
+{
+    const uint8_t default_value = default_segment == SOURCE ? 1 : 0;
+    cut.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Node& n = nodes[i];
+        cut[i] = n.parent != INVALID_ARC ? !n.is_sink : default_value;
+    }
+}
+
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::maxflow()
 {
     auto ph1_begin = std::chrono::system_clock::now();
 
@@ -437,6 +458,9 @@ inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow()
     std::vector<std::thread> threads;
 
     init_maxflow();
+    for (auto& b : blocks) {
+        b.op_counter.reset();
+    }
 
     // Solve all base blocks.
     for (unsigned int i = 0; i < num_threads; ++i) {
@@ -555,17 +579,27 @@ inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow()
     return flow;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline std::pair<BlockIdx, BlockIdx> ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::block_key(
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline OpStats ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::get_op_stats() const
+{
+    OpCounter<CountOps> total;
+    for (const auto& b : blocks) {
+        total.add(b.op_counter.get());
+    }
+    return total.get();
+}
+
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline std::pair<BlockIdx, BlockIdx> ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::block_key(
     BlockIdx i, BlockIdx j) const noexcept
 {
     return i < j ? std::make_pair(i, j) : std::make_pair(j, i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 inline std::pair<
-    std::list<typename ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::BoundarySegment>, BlockIdx>
-ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::next_boundary_segment_set()
+    std::list<typename ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::BoundarySegment>, BlockIdx>
+ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::next_boundary_segment_set()
 {
     // NOTE: We assume the global lock is grabbed at this point so no other threads are scanning
     std::list<BoundarySegment> out;
@@ -602,8 +636,8 @@ ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::next_boundary_segment_set()
     return std::make_pair(out, out_idx);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::maxflow()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::maxflow()
 {
     NodeIdx crnt_node = INVALID_NODE;
 
@@ -668,8 +702,8 @@ inline Flow ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::maxflow
     return flow;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::init_maxflow()
 {
     assert(nodes.size() == node_blocks.size());
 
@@ -710,8 +744,8 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow()
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::init_maxflow()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::init_maxflow()
 {
     assert(nodes.size() == node_blocks.size());
 
@@ -744,8 +778,8 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::init_ma
     initialized = true;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::make_active(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::make_active(NodeIdx i)
 {
     if (nodes[i].next_active == INVALID_NODE) {
         // It's not in the active list yet
@@ -759,22 +793,22 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::make_ac
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::make_front_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::make_front_orphan(NodeIdx i)
 {
     nodes[i].parent = ORPHAN_ARC;
     orphan_nodes.push_front(i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::make_back_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::make_back_orphan(NodeIdx i)
 {
     nodes[i].parent = ORPHAN_ARC;
     orphan_nodes.push_back(i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline NodeIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::next_active()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline NodeIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::next_active()
 {
     NodeIdx i;
     // Pop nodes from the active list until we find a valid one or run out of nodes
@@ -798,8 +832,8 @@ inline NodeIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::next
     return i;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::augment(ArcIdx middle_idx)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::augment(ArcIdx middle_idx)
 {
     Arc &middle = arcs[middle_idx];
     Arc &middle_sister = sister(middle_idx);
@@ -811,15 +845,17 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::augment
     // Step  2: Augment along source and sink tree
     middle_sister.r_cap += bottleneck;
     middle.r_cap -= bottleneck;
-    augment_tree(middle_sister.head, bottleneck, true);
-    augment_tree(middle.head, bottleneck, false);
+    size_t length = 3; // Middle arc and the two terminal arcs
+    length += augment_tree(middle_sister.head, bottleneck, true);
+    length += augment_tree(middle.head, bottleneck, false);
+    op_counter.augmentation(length);
 
     // Step 3: Add bottleneck to overall flow
     flow += bottleneck;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Term ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::tree_bottleneck(
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Term ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::tree_bottleneck(
     NodeIdx start, bool source_tree) const
 {
     NodeIdx i = start;
@@ -837,11 +873,12 @@ inline Term ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::tree_bo
     return std::min<Term>(bottleneck, source_tree ? tr_cap : -tr_cap);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::augment_tree(
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline size_t ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::augment_tree(
     NodeIdx start, Term bottleneck, bool source_tree)
 {
     NodeIdx i = start;
+    size_t length = 0;
     while (true) {
         ArcIdx ai = nodes[i].parent;
         if (ai == TERMINAL_ARC) {
@@ -855,28 +892,32 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::augment
             make_front_orphan(i);
         }
         i = arcs[ai].head;
+        length++;
     }
     nodes[i].tr_cap += source_tree ? -bottleneck : bottleneck;
     if (nodes[i].tr_cap == 0) {
         make_front_orphan(i);
     }
+    return length;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::grow_search_tree(NodeIdx start)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::grow_search_tree(NodeIdx start)
 {
     return nodes[start].is_sink ? grow_search_tree_impl<false>(start) : grow_search_tree_impl<true>(start);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 template<bool source>
-inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::grow_search_tree_impl(
+inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::grow_search_tree_impl(
     NodeIdx start_idx)
 {
     const Node& start = nodes[start_idx];
     ArcIdx ai;
+    op_counter.growth_step();
     // Add neighbor nodes search tree until we find a node from the other search tree or run out of neighbors
     for (ai = start.first; ai != INVALID_ARC; ai = arcs[ai].next) {
+        op_counter.arcs_scanned();
         if (sister_or_arc(ai, !source).r_cap > 0) {
             Node& n = head_node(ai);
             if (n.parent == INVALID_ARC) {
@@ -904,8 +945,8 @@ inline ArcIdx ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::grow_
     return ai;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::process_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::process_orphan(NodeIdx i)
 {
     if (nodes[i].is_sink) {
         process_orphan_impl<false>(i);
@@ -914,16 +955,18 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::process
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 template<bool source>
-inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::process_orphan_impl(NodeIdx i)
+inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::GraphBlock::process_orphan_impl(NodeIdx i)
 {
     Node &n = nodes[i];
     static const int32_t INF_DIST = std::numeric_limits<int32_t>::max();
     int32_t min_d = INF_DIST;
     ArcIdx min_a0 = INVALID_ARC;
+    op_counter.orphan();
     // Try to find a new parent
     for (ArcIdx a0 = n.first; a0 != INVALID_ARC; a0 = arcs[a0].next) {
+        op_counter.arcs_scanned();
         if (sister_or_arc(a0, source).r_cap > 0) {
             NodeIdx j = arcs[a0].head;
             ArcIdx a = nodes[j].parent;
@@ -969,11 +1012,13 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::process
     }
     n.parent = min_a0;
     if (min_a0 != INVALID_ARC) {
+        op_counter.adoption();
         n.timestamp = time;
         n.dist = min_d + 1;
     } else {
         // No parent was found so process neighbors
         for (ArcIdx a0 = n.first; a0 != INVALID_ARC; a0 = arcs[a0].next) {
+            op_counter.arcs_scanned();
             if (arcs[a0].r_cap != INACTIVE_ARC) {
                 NodeIdx j = arcs[a0].head;
                 Node &m = nodes[j];
@@ -991,8 +1036,8 @@ inline void ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::GraphBlock::process
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline bool ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx>::should_activate(NodeIdx i, NodeIdx j)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline bool ParallelGraph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::should_activate(NodeIdx i, NodeIdx j)
 {
     Node &ni = nodes[i];
     Node &nj = nodes[j];
@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <type_traits>
 
+#include "../op_stats.h"
+#include "../phase_trace.h"
+
 #include "util.h"
 
 namespace reimpls {
@@ -15,7 +18,7 @@ namespace reimpls {
 using Time = uint32_t;
 using Dist = uint16_t;
 
-template <class Cap, class Term, class Flow, class ArcIdx = int32_t, class NodeIdx = int32_t>
+template <class Cap, class Term, class Flow, class ArcIdx = int32_t, class NodeIdx = int32_t, bool CountOps = false>
 class Graph {
     static_assert(std::is_integral<ArcIdx>::value, "ArcIdx must be an integer type");
     static_assert(std::is_integral<NodeIdx>::value, "NodeIdx must be an integer type");
@@ -42,6 +45,9 @@ public:
     void reserve_nodes(size_t num);
     void reserve_edges(size_t num);
 
+    // Remove all nodes and arcs but keep the allocated memory, so the graph can be rebuilt without reallocating
+    void reset();
+
     NodeIdx add_node(size_t num = 1);
 
     void add_tweights(NodeIdx i, Term cap_source, Term cap_sink);
@@ -53,10 +59,19 @@ public:
     Flow get_maxflow() const noexcept { return flow; }
 
     TermType what_segment(NodeIdx i, TermType default_segment = SOURCE) const;
+    // Same as what_segment for all nodes: cut[i] = 1 if node i is in the SOURCE segment and 0 otherwise
+    void get_cut(std::vector<uint8_t>& cut, TermType default_segment = SOURCE) const;
+    // Residual capacities in the order arcs were added: res[2k] is i->j and res[2k+1] is j->i for the k-th
+    // add_edge(i, j, ...) call. Only meaningful if no edges were merged.
+    template <class T>
+    void get_residual_caps(std::vector<T>& res) const;
 
     inline size_t get_node_num() const noexcept { return nodes.size(); }
     inline size_t get_arc_num() const noexcept { return arcs.size(); }
 
+    // Operation counts of the last maxflow call, all zero unless CountOps is true
+    OpStats get_op_stats() const { return op_counter.get(); }
+
     void mark_node(NodeIdx i);
 
 private:
@@ -71,6 +86,8 @@ private:
 
     Time time;
 
+    OpCounter<CountOps> op_counter;
+
 #pragma pack (1)
     struct REIMPLS_PACKED Node {
         ArcIdx first; // First out-going arc.
@@ -127,7 +144,7 @@ private:
 
     void augment(ArcIdx middle);
     Term tree_bottleneck(NodeIdx start, bool source_tree) const;
-    void augment_tree(NodeIdx start, Term bottleneck, bool source_tree);
+    size_t augment_tree(NodeIdx start, Term bottleneck, bool source_tree);
 
     ArcIdx grow_search_tree(NodeIdx start);
     template <bool source> ArcIdx grow_search_tree_impl(NodeIdx start);
@@ -150,8 +167,8 @@ private:
 };
 
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::Graph() :
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::Graph() :
     nodes(),
     arcs(),
     flow(0),
@@ -162,28 +179,41 @@ Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::Graph() :
     time(0)
 {}
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::Graph(size_t expected_nodes, size_t expected_arcs) :
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::Graph(size_t expected_nodes, size_t expected_arcs) :
     Graph()
 {
     reserve_nodes(expected_nodes);
     reserve_edges(expected_arcs);
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::reserve_nodes(size_t num)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::reserve_nodes(size_t num)
 {
     nodes.reserve(num);
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::reserve_edges(size_t num)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::reserve_edges(size_t num)
 {
     arcs.reserve(2 * num);
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline NodeIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_node(size_t num)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::reset()
+{
+    nodes.clear();
+    arcs.clear();
+    flow = 0;
+    maxflow_iteration = 0;
+    first_active = INVALID_NODE;
+    last_active = INVALID_NODE;
+    orphan_nodes.clear();
+    time = 0;
+}
+
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline NodeIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_node(size_t num)
 {
     NodeIdx crnt = nodes.size();
 
@@ -198,8 +228,8 @@ inline NodeIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_node(size_t num)
     return crnt;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_tweights(NodeIdx i, Term cap_source, Term cap_sink)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_tweights(NodeIdx i, Term cap_source, Term cap_sink)
 {
     assert(i >= 0 && i < nodes.size());
     Term delta = nodes[i].tr_cap;
@@ -212,8 +242,8 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_tweights(NodeIdx i, Ter
     nodes[i].tr_cap = cap_source - cap_sink;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_edge(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_edge(
     NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap, bool merge_duplicates)
 {
     assert(i >= 0 && i < nodes.size());
@@ -237,8 +267,8 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_edge(
     add_half_edge(j, i, rev_cap, merge_duplicates);
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_half_edge(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_half_edge(
     NodeIdx from, NodeIdx to, Cap cap, bool merge_duplicates)
 {
     ArcIdx ai;
@@ -263,9 +293,9 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::add_half_edge(
     nodes[from].first = ai;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline typename Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::TermType
-Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::what_segment(NodeIdx i, TermType default_segment) const
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline typename Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::TermType
+Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::what_segment(NodeIdx i, TermType default_segment) const
 {
     if (nodes[i].parent != INVALID_ARC) {
         return (nodes[i].is_sink) ? SINK : SOURCE;
@@ -274,16 +304,39 @@ Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::what_segment(NodeIdx i, TermType defaul
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::mark_node(NodeIdx i)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::get_cut(std::vector<uint8_t>& cut, TermType default_segment) const
+{
+    const uint8_t default_value = default_segment == SOURCE ? 1 : 0;
+    cut.resize(get_node_num());
+    for (size_t i = 0; i < cut.size(); ++i) {
+        const Node& n = nodes[i];
+        cut[i] = n.parent != INVALID_ARC ? !n.is_sink : default_value;
+    }
+}
+
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+template <class T>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::get_residual_caps(std::vector<T>& res) const
+{
+    res.resize(arcs.size());
+    for (size_t a = 0; a < arcs.size(); ++a) {
+        res[a] = arcs[a].r_cap;
+    }
+}
+
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::mark_node(NodeIdx i)
 {
     make_active(i);
     nodes[i].is_marked = true;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Flow Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow(bool reuse_trees)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Flow Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::maxflow(bool reuse_trees)
 {
+    op_counter.reset();
+    TRACE_PHASE(SOLVE);
     if (reuse_trees) {
         init_maxflow_reuse_trees();
     } else {
@@ -333,6 +386,7 @@ inline Flow Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow(bool reuse_trees)
 
             augment(source_sink_connector);
 
+            TRACE_PHASE(ADOPT);
             std::deque<NodeIdx> crnt_orphan_nodes = std::move(orphan_nodes); // Snapshot of current ophans
             for (NodeIdx orphan : crnt_orphan_nodes) {
                 process_orphan(orphan);
@@ -354,9 +408,10 @@ inline Flow Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow(bool reuse_trees)
     return flow;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::init_maxflow()
 {
+    TRACE_PHASE(INIT);
     first_active = INVALID_NODE;
     last_active = INVALID_NODE;
     orphan_nodes.clear();
@@ -379,9 +434,10 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow()
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow_reuse_trees()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::init_maxflow_reuse_trees()
 {
+    TRACE_PHASE(INIT);
     NodeIdx i = first_active;
 
     // Reset queues as we are going to re-add to them during initialization
@@ -457,8 +513,8 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow_reuse_trees()
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::make_active(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::make_active(NodeIdx i)
 {
     if (nodes[i].next_active == INVALID_NODE) {
         // It's not in the active list yet
@@ -473,22 +529,22 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::make_active(NodeIdx i)
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::make_front_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::make_front_orphan(NodeIdx i)
 {
     nodes[i].parent = ORPHAN_ARC;
     orphan_nodes.push_front(i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::make_back_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::make_back_orphan(NodeIdx i)
 {
     nodes[i].parent = ORPHAN_ARC;
     orphan_nodes.push_back(i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline NodeIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::next_active()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline NodeIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::next_active()
 {
     NodeIdx i;
     // Pop nodes from the active list until we find a valid one or run out of nodes
@@ -512,9 +568,10 @@ inline NodeIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::next_active()
     return i;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::augment(ArcIdx middle_idx)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::augment(ArcIdx middle_idx)
 {
+    TRACE_PHASE(AUGMENT);
     Arc& middle = arcs[middle_idx];
     Arc& middle_sister = sister(middle_idx);
     // Step 1: Find bottleneck capacity
@@ -525,15 +582,17 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::augment(ArcIdx middle_idx)
     // Step  2: Augment along source and sink tree
     middle_sister.r_cap += bottleneck;
     middle.r_cap -= bottleneck;
-    augment_tree(middle_sister.head, bottleneck, true);
-    augment_tree(middle.head, bottleneck, false);
+    size_t length = 3; // Middle arc and the two terminal arcs
+    length += augment_tree(middle_sister.head, bottleneck, true);
+    length += augment_tree(middle.head, bottleneck, false);
+    op_counter.augmentation(length);
 
     // Step 3: Add bottleneck to overall flow
     flow += bottleneck;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Term Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::tree_bottleneck(NodeIdx start, bool source_tree) const
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Term Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::tree_bottleneck(NodeIdx start, bool source_tree) const
 {
     NodeIdx i = start;
     Term bottleneck = std::numeric_limits<Term>::max();
@@ -550,11 +609,12 @@ inline Term Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::tree_bottleneck(NodeIdx sta
     return std::min<Term>(bottleneck, source_tree ? tr_cap : -tr_cap);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::augment_tree(
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline size_t Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::augment_tree(
     NodeIdx start, Term bottleneck, bool source_tree)
 {
     NodeIdx i = start;
+    size_t length = 0;
     while (true) {
         ArcIdx ai = nodes[i].parent;
         if (ai == TERMINAL_ARC) {
@@ -568,27 +628,32 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::augment_tree(
             make_front_orphan(i);
         }
         i = arcs[ai].head;
+        length++;
     }
     nodes[i].tr_cap += source_tree ? -bottleneck : bottleneck;
     if (nodes[i].tr_cap == 0) {
         make_front_orphan(i);
     }
+    return length;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline ArcIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree(NodeIdx start)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline ArcIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::grow_search_tree(NodeIdx start)
 {
+    TRACE_PHASE(GROWTH);
+    op_counter.growth_step();
     return nodes[start].is_sink ? grow_search_tree_impl<false>(start) : grow_search_tree_impl<true>(start);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 template<bool source>
-inline ArcIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree_impl(NodeIdx start_idx)
+inline ArcIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::grow_search_tree_impl(NodeIdx start_idx)
 {
     const Node& start = nodes[start_idx];
     ArcIdx ai;
     // Add neighbor nodes search tree until we find a node from the other search tree or run out of neighbors
     for (ai = start.first; ai != INVALID_ARC; ai = arcs[ai].next) {
+        op_counter.arcs_scanned();
         if (sister_or_arc(ai, !source).r_cap > 0) {
             Node& n = head_node(ai);
             if (n.parent == INVALID_ARC) {
@@ -616,8 +681,8 @@ inline ArcIdx Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree_impl(Nod
     return ai;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::process_orphan(NodeIdx i)
 {
     if (nodes[i].is_sink) {
         process_orphan_impl<false>(i);
@@ -626,16 +691,18 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan(NodeIdx i)
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 template<bool source>
-inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan_impl(NodeIdx i)
+inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::process_orphan_impl(NodeIdx i)
 {
+    op_counter.orphan();
     Node &n = nodes[i];
     static const int32_t INF_DIST = std::numeric_limits<int32_t>::max();
     int32_t min_d = INF_DIST;
     ArcIdx min_a0 = INVALID_ARC;
     // Try to find a new parent
     for (ArcIdx a0 = n.first; a0 != INVALID_ARC; a0 = arcs[a0].next) {
+        op_counter.arcs_scanned();
         if (sister_or_arc(a0, source).r_cap > 0) {
             NodeIdx j = arcs[a0].head;
             ArcIdx a = nodes[j].parent;
@@ -681,11 +748,13 @@ inline void Graph<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan_impl(NodeIdx
     }
     n.parent = min_a0;
     if (min_a0 != INVALID_ARC) {
+        op_counter.adoption();
         n.timestamp = time;
         n.dist = min_d + 1;
     } else {
         // No parent was found so process neighbors
         for (ArcIdx a0 = n.first; a0 != INVALID_ARC; a0 = arcs[a0].next) {
+        op_counter.arcs_scanned();
             NodeIdx j = arcs[a0].head;
             Node &m = nodes[j];
             if (m.is_sink != source && m.parent != INVALID_ARC) {
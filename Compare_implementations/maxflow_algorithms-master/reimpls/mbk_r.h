@@ -8,12 +8,15 @@
 #include <algorithm>
 #include <type_traits>
 
+#include "../op_stats.h"
+#include "../phase_trace.h"
+
 namespace reimpls {
 
 using Time = uint32_t;
 using Dist = uint16_t;
 
-template <class Cap, class Term, class Flow, class ArcIdx = int32_t, class NodeIdx = int32_t>
+template <class Cap, class Term, class Flow, class ArcIdx = int32_t, class NodeIdx = int32_t, bool CountOps = false>
 class Graph2 {
     static_assert(std::is_integral<ArcIdx>::value, "ArcIdx must be an integer type");
     static_assert(std::is_integral<NodeIdx>::value, "NodeIdx must be an integer type");
@@ -36,6 +39,9 @@ public:
 
     Graph2(size_t expected_nodes, size_t expected_arcs);
 
+    // Remove all nodes and arcs but keep the allocated memory, so the graph can be rebuilt without reallocating
+    void reset();
+
     NodeIdx add_node(size_t num = 1);
 
     void add_tweights(NodeIdx i, Term cap_source, Term cap_sink);
@@ -46,10 +52,20 @@ public:
     Flow maxflow();
 
     TermType what_segment(NodeIdx i, TermType default_segment = SOURCE) const;
+    // Same as what_segment for all nodes: cut[i] = 1 if node i is in the SOURCE segment and 0 otherwise
+    void get_cut(std::vector<uint8_t>& cut, TermType default_segment = SOURCE) const;
+    // Residual capacities in the order arcs were added: res[2k] is i->j and res[2k+1] is j->i for the k-th
+    // add_edge(i, j, ...) call. Only meaningful if no edges were merged, and only after init_maxflow, which reorders
+    // the arcs but records in arc_buffer where each one went.
+    template <class T>
+    void get_residual_caps(std::vector<T>& res) const;
 
     inline size_t get_node_num() const noexcept { return nodes.size() - 1; }
     inline size_t get_arc_num() const noexcept { return arcs.size(); }
 
+    // Operation counts of the last maxflow call, all zero unless CountOps is true
+    OpStats get_op_stats() const { return op_counter.get(); }
+
 private:
     std::vector<Node> nodes;
     std::vector<Arc> arcs;
@@ -63,6 +79,8 @@ private:
 
     Time time;
 
+    OpCounter<CountOps> op_counter;
+
 #pragma pack (1)
     struct REIMPLS_PACKED Node {
         ArcIdx first; // First out-going arc.
@@ -116,7 +134,7 @@ private:
 
     void augment(ArcIdx middle);
     Term tree_bottleneck(NodeIdx start, bool source_tree) const;
-    void augment_tree(NodeIdx start, Term bottleneck, bool source_tree);
+    size_t augment_tree(NodeIdx start, Term bottleneck, bool source_tree);
 
     ArcIdx grow_search_tree(NodeIdx start);
     template <bool source> ArcIdx grow_search_tree_impl(NodeIdx start);
@@ -139,8 +157,8 @@ private:
 };
 
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::Graph2(size_t expected_nodes, size_t expected_arcs) :
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::Graph2(size_t expected_nodes, size_t expected_arcs) :
     nodes(),
     arcs(),
     arc_buffer(),
@@ -158,8 +176,23 @@ Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::Graph2(size_t expected_nodes, size_t e
 }
 
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline NodeIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_node(size_t num)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::reset()
+{
+    nodes.clear();
+    nodes.resize(1); // Sentinel node
+    arcs.clear();
+    arc_buffer.clear();
+    flow = 0;
+    maxflow_iteration = 0;
+    first_active = INVALID_NODE;
+    last_active = INVALID_NODE;
+    orphan_nodes.clear();
+    time = 0;
+}
+
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline NodeIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_node(size_t num)
 {
     NodeIdx crnt = nodes.size();
 
@@ -174,8 +207,8 @@ inline NodeIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_node(size_t num)
     return crnt;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_tweights(NodeIdx i, Term cap_source, Term cap_sink)
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_tweights(NodeIdx i, Term cap_source, Term cap_sink)
 {
     assert(i >= 0 && i < nodes.size());
     Term delta = nodes[i].tr_cap;
@@ -188,8 +221,8 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_tweights(NodeIdx i, Te
     nodes[i].tr_cap = cap_source - cap_sink;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_edge(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_edge(
     NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap, bool merge_duplicates)
 {
     assert(i >= 0 && i < nodes.size());
@@ -213,8 +246,8 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_edge(
     add_half_edge(j, i, rev_cap, cap, merge_duplicates);
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_half_edge(
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::add_half_edge(
     NodeIdx from, NodeIdx to, Cap cap, Cap rev_cap, bool merge_duplicates)
 {
     ArcIdx ai;
@@ -239,9 +272,9 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::add_half_edge(
     nodes[from].first = ai;
 }
 
-template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline typename Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::TermType 
-Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::what_segment(NodeIdx i, TermType default_segment) const
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline typename Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::TermType 
+Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::what_segment(NodeIdx i, TermType default_segment) const
 {
     if (nodes[i].parent != INVALID_ARC) {
         return (nodes[i].is_sink) ? SINK : SOURCE;
@@ -250,9 +283,32 @@ Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::what_segment(NodeIdx i, TermType defau
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Flow Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow()
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::get_cut(std::vector<uint8_t>& cut, TermType default_segment) const
+{
+    const uint8_t default_value = default_segment == SOURCE ? 1 : 0;
+    cut.resize(get_node_num());
+    for (size_t i = 0; i < cut.size(); ++i) {
+        const Node& n = nodes[i];
+        cut[i] = n.parent != INVALID_ARC ? !n.is_sink : default_value;
+    }
+}
+
+template <class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+template <class T>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::get_residual_caps(std::vector<T>& res) const
+{
+    res.resize(arcs.size());
+    for (size_t a = 0; a < arc_buffer.size(); ++a) {
+        res[a] = arcs[arc_buffer[a].sister].r_cap;
+    }
+}
+
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Flow Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::maxflow()
 {
+    op_counter.reset();
+    TRACE_PHASE(SOLVE);
     // init_maxflow();
 
     NodeIdx crnt_node = INVALID_NODE;
@@ -298,6 +354,7 @@ inline Flow Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow()
 
             augment(source_sink_connector);
 
+            TRACE_PHASE(ADOPT);
             std::deque<NodeIdx> crnt_orphan_nodes = std::move(orphan_nodes); // Snapshot of current ophans
             for (NodeIdx orphan : crnt_orphan_nodes) {
                 process_orphan(orphan);
@@ -319,9 +376,10 @@ inline Flow Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::maxflow()
     return flow;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::init_maxflow()
 {
+    TRACE_PHASE(INIT);
     first_active = INVALID_NODE;
     last_active = INVALID_NODE;
     orphan_nodes.clear();
@@ -373,8 +431,8 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::init_maxflow()
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::make_active(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::make_active(NodeIdx i)
 {
     if (nodes[i].next_active == INVALID_NODE) {
         // It's not in the active list yet
@@ -389,22 +447,22 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::make_active(NodeIdx i)
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::make_front_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::make_front_orphan(NodeIdx i)
 {
     nodes[i].parent = ORPHAN_ARC;
     orphan_nodes.push_front(i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::make_back_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::make_back_orphan(NodeIdx i)
 {
     nodes[i].parent = ORPHAN_ARC;
     orphan_nodes.push_back(i);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline NodeIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::next_active()
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline NodeIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::next_active()
 {
     NodeIdx i;
     // Pop nodes from the active list until we find a valid one or run out of nodes
@@ -428,9 +486,10 @@ inline NodeIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::next_active()
     return i;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::augment(ArcIdx middle_idx)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::augment(ArcIdx middle_idx)
 {
+    TRACE_PHASE(AUGMENT);
     Arc& middle = arcs[middle_idx];
     Arc& middle_sister = arcs[middle.sister];
     // Step 1: Find bottleneck capacity
@@ -443,15 +502,17 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::augment(ArcIdx middle_idx)
     middle.r_cap -= bottleneck;
     middle_sister.sister_sat = middle.r_cap == 0;
     middle.sister_sat = middle_sister.r_cap == 0;
-    augment_tree(middle_sister.head, bottleneck, true);
-    augment_tree(middle.head, bottleneck, false);
+    size_t length = 3; // Middle arc and the two terminal arcs
+    length += augment_tree(middle_sister.head, bottleneck, true);
+    length += augment_tree(middle.head, bottleneck, false);
+    op_counter.augmentation(length);
 
     // Step 3: Add bottleneck to overall flow
     flow += bottleneck;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline Term Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::tree_bottleneck(NodeIdx start, bool source_tree) const
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline Term Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::tree_bottleneck(NodeIdx start, bool source_tree) const
 {
     NodeIdx i = start;
     Term bottleneck = std::numeric_limits<Term>::max();
@@ -468,11 +529,12 @@ inline Term Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::tree_bottleneck(NodeIdx st
     return std::min<Term>(bottleneck, source_tree ? tr_cap : -tr_cap);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::augment_tree(
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline size_t Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::augment_tree(
     NodeIdx start, Term bottleneck, bool source_tree)
 {
     NodeIdx i = start;
+    size_t length = 0;
     while (true) {
         ArcIdx ai = nodes[i].parent;
         if (ai == TERMINAL_ARC) {
@@ -488,22 +550,26 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::augment_tree(
             make_front_orphan(i);
         }
         i = arcs[ai].head;
+        length++;
     }
     nodes[i].tr_cap += source_tree ? -bottleneck : bottleneck;
     if (nodes[i].tr_cap == 0) {
         make_front_orphan(i);
     }
+    return length;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline ArcIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree(NodeIdx start)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline ArcIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::grow_search_tree(NodeIdx start)
 {
+    TRACE_PHASE(GROWTH);
+    op_counter.growth_step();
     return nodes[start].is_sink ? grow_search_tree_impl<false>(start) : grow_search_tree_impl<true>(start);
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 template<bool source>
-inline ArcIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree_impl(NodeIdx start_idx)
+inline ArcIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::grow_search_tree_impl(NodeIdx start_idx)
 {
     const Node& start = nodes[start_idx];
     const Node& next = nodes[start_idx + 1];
@@ -520,6 +586,7 @@ inline ArcIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree_impl(No
                 make_active(arcs[ai].head);
             } else if (n.is_sink == source) {
                 // Found a node from the other search tree so abort
+                op_counter.arcs_scanned(ai - start.first + 1);
                 if (!source) {
                     // If we are growing the sink tree we instead return the sister arc
                     ai = arcs[ai].sister;
@@ -533,11 +600,12 @@ inline ArcIdx Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::grow_search_tree_impl(No
             }
         }
     }
+    op_counter.arcs_scanned(next.first - start.first);
     return INVALID_ARC;
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan(NodeIdx i)
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::process_orphan(NodeIdx i)
 {
     if (nodes[i].is_sink) {
         process_orphan_impl<false>(i);
@@ -546,15 +614,17 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan(NodeIdx i)
     }
 }
 
-template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx>
+template<class Cap, class Term, class Flow, class ArcIdx, class NodeIdx, bool CountOps>
 template<bool source>
-inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan_impl(NodeIdx i)
+inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx, CountOps>::process_orphan_impl(NodeIdx i)
 {
+    op_counter.orphan();
     Node& n = nodes[i];
     Node& next = nodes[i + 1];
     static const int32_t INF_DIST = std::numeric_limits<int32_t>::max();
     int32_t min_d = INF_DIST;
     ArcIdx min_a0 = INVALID_ARC;
+    op_counter.arcs_scanned(next.first - n.first);
     // Try to find a new parent
     for (ArcIdx a0 = n.first; a0 != next.first; ++a0) {
         if (source ? !arcs[a0].sister_sat : arcs[a0].r_cap) {
@@ -602,10 +672,12 @@ inline void Graph2<Cap, Term, Flow, ArcIdx, NodeIdx>::process_orphan_impl(NodeId
     }
     n.parent = min_a0;
     if (min_a0 != INVALID_ARC) {
+        op_counter.adoption();
         n.timestamp = time;
         n.dist = min_d + 1;
     } else {
         // No parent was found so process neighbors
+        op_counter.arcs_scanned(next.first - n.first);
         for (ArcIdx a0 = n.first; a0 != next.first; ++a0) {
             NodeIdx j = arcs[a0].head;
             Node &m = nodes[j];
@@ -16,10 +16,11 @@
 #include <atomic>
 
 #include "util.h"
+#include "../op_stats.h"
 
 namespace reimpls {
 
-template <class Cap, class Term, class Flow, class NodeIdx = uint32_t, class ArcIdx = uint32_t>
+template <class Cap, class Term, class Flow, class NodeIdx = uint32_t, class ArcIdx = uint32_t, bool CountOps = false>
 class ParallelIbfs {
     static constexpr size_t ALLOC_INIT_LEVELS = 4096;
 
@@ -62,9 +63,13 @@ public:
     void resetTrees();
 
     inline Flow getFlow() const noexcept { return flow; }
+    // Operation counts of the last computeMaxFlow summed over all blocks, all zero unless CountOps is true
+    OpStats getOpStats() const;
     inline size_t getNumNodes() const noexcept { return nodes.size(); }
     inline size_t getNumArcs() const noexcept { return arcs.size(); }
     int isNodeOnSrcSide(NodeIdx node, int freeNodeValue = 0);
+    // Same as isNodeOnSrcSide for all nodes: cut[i] = 1 if node i is on the source side and 0 otherwise
+    void getCut(std::vector<uint8_t>& cut, int freeNodeValue = 0) const;
     unsigned int getNumThreads() const noexcept { return num_threads; }
     void setNumThreads(unsigned int threads) { num_threads = threads; }
 
@@ -143,6 +148,7 @@ private:
         Buckets3Pass orphan3PassBuckets;
         BucketsOneSided orphanBuckets;
         ExcessBuckets excessBuckets;
+        OpCounter<CountOps> opCounter;
         int64_t uniqOrphansS, uniqOrphansT;
 
         IbfsBlock(NodeIdx numNodes, ArcIdx numArcs, std::vector<Node>& nodes, std::vector<Arc>& arcs, 
@@ -164,6 +170,7 @@ private:
             orphan3PassBuckets(),
             orphanBuckets(),
             excessBuckets(),
+            opCounter(),
             uniqOrphansS(1),
             uniqOrphansT(1)
         {
@@ -604,8 +611,8 @@ private:
     ArcIdx build_arc(NodeIdx from, NodeIdx to, Cap cap, Cap revCap);
 };
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::ParallelIbfs() :
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::ParallelIbfs() :
     init_n_nodes(0),
     init_n_edges(0),
     arcIter(nullptr),
@@ -627,22 +634,22 @@ inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::ParallelIbfs() :
     block_idxs(),
     num_threads(std::thread::hardware_concurrency()) {}
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::ParallelIbfs(int64_t numNodes, int64_t numEdges) :
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::ParallelIbfs(int64_t numNodes, int64_t numEdges) :
     ParallelIbfs()
 {
     initSize(numNodes, numEdges);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::~ParallelIbfs()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::~ParallelIbfs()
 {
     /*delete[]nodes;
     delete[]memArcs;*/
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::addNode(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::addNode(
     NodeIdx node, Term capSource, Term capSink)
 {
     assert(isInitializedGraph());
@@ -662,15 +669,15 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::addNode(
 }
 
 // @pre: activeS1.empty() && activeT1.empty()
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::resetTrees()
 {
     resetTrees(1, 1);
 }
 
 // @pre: activeS1.empty() && activeT1.empty()
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::resetTrees(
     BlockIdx block, int64_t newTopLevelS, int64_t newTopLevelT)
 {
     auto& b = blocks[block];
@@ -707,8 +714,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::resetTrees(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::remove_sibling(NodeIdx i)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::remove_sibling(NodeIdx i)
 {
     // TODO: This can very likely be made more readable!
     Node& parent = parent_node(i);
@@ -723,15 +730,15 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::remove_si
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::add_sibling(NodeIdx i, NodeIdx parent)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::add_sibling(NodeIdx i, NodeIdx parent)
 {
     nodes[i].nextNode = nodes[parent].firstSon;
     nodes[parent].firstSon = i;
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::print_graph(std::FILE* file) const
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::print_graph(std::FILE* file) const
 {
     const NodeIdx num_nodes = nodes.size();
     const NodeIdx num_arcs = arcs.size();
@@ -750,14 +757,14 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::print_graph(std::FIL
 }
 
 /*template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline bool ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::incShouldResetTrees()
+inline bool ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incShouldResetTrees()
 {
     // TODO: Make sure uniqOrphansS + uniqOrphansT can be compared to int64_t
     return (uniqOrphansS + uniqOrphansT) >= 2 * numNodes;
 }*/
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::incNode(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::incNode(
     NodeIdx node, Term deltaCapSource, Term deltaCapSink)
 {
     Node& x = nodes[node];
@@ -807,8 +814,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::incNode(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::incArc(ArcIdx ai, Cap deltaCap)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::incArc(ArcIdx ai, Cap deltaCap)
 {
     if (deltaCap == 0) {
         return;
@@ -854,8 +861,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::incArc(Ar
     a.isRevResidual = sister.rCap != 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::addEdge(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::addEdge(
     NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity)
 {
     tmpEdgeLast->tail = from;
@@ -871,7 +878,7 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::addEdge(
 }
 
 /*template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::incEdge(
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::incEdge(
     NodeIdx from, NodeIdx to, Cap capacity, Cap revCapacity)
 {
     Node& x = nodes[from];
@@ -897,8 +904,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::incEdge(
     incArc(arcIter->rev, revCapacity);
 }*/
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline int ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::isNodeOnSrcSide(NodeIdx node, int freeNodeValue)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline int ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::isNodeOnSrcSide(NodeIdx node, int freeNodeValue)
 {
     if (nodes[node].label == 0) {
         return freeNodeValue;
@@ -906,14 +913,25 @@ inline int ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::isNodeOnSrcSide(NodeI
     return (nodes[node].label > 0 ? 1 : 0);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraph()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::getCut(std::vector<uint8_t>& cut, int freeNodeValue) const
+{
+    // The nodes vector holds an extra sentinel at the end
+    cut.resize(numNodes);
+    for (int64_t i = 0; i < numNodes; ++i) {
+        const auto label = nodes[i].label;
+        cut[i] = label == 0 ? freeNodeValue : (label > 0 ? 1 : 0);
+    }
+}
+
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initGraph()
 {
     initGraphFast();
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initSize(int64_t numNodes, int64_t numEdges)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initSize(int64_t numNodes, int64_t numEdges)
 {
     this->numNodes = numNodes;
     init_n_nodes = numNodes;
@@ -950,8 +968,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initSize(int64_t num
     node_blocks.resize(numNodes);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::reset()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::reset()
 {
     // compute allocation size
     /*uint64_t arcTmpMemsize = (uint64_t)sizeof(TmpEdge) * (uint64_t)init_n_edges;
@@ -986,8 +1004,8 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::reset()
     flow = 0;*/
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::registerNodes(
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::registerNodes(
     NodeIdx begin, NodeIdx end, BlockIdx block)
 {
     assert(isInitializedGraph());
@@ -1003,8 +1021,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::registerNodes(
     std::fill(node_blocks.begin() + begin, node_blocks.begin() + end, block);
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initNodes()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initNodes()
 {
     // Init active lists first
     std::fill_n(ptrs.begin(), 3 * numNodes, INVALID_NODE);
@@ -1031,8 +1049,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initNodes()
     }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline ArcIdx ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::build_arc(
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline ArcIdx ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::build_arc(
     NodeIdx from, NodeIdx to, Cap cap, Cap revCap)
 {
     ArcIdx ai = nodes[from].firstArc;
@@ -1043,8 +1061,8 @@ inline ArcIdx ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::build_arc(
     return ai;
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline bool ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::invalidates_invariants(const Node & x, const Node & y)
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline bool ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::invalidates_invariants(const Node & x, const Node & y)
 {
     return (x.label > 0 && y.label <= 0)
         || (x.label >= 0 && y.label < 0)
@@ -1052,9 +1070,9 @@ inline bool ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::invalidates_invarian
         || (x.label < (y.label - 1) && y.label < 0);
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline typename ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::BoundaryKey
-ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::block_key(BlockIdx i, BlockIdx j) const noexcept
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline typename ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::BoundaryKey
+ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::block_key(BlockIdx i, BlockIdx j) const noexcept
 {
     constexpr BoundaryKey shift = sizeof(BlockIdx) * 8;
     if (i < j) {
@@ -1064,8 +1082,8 @@ ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::block_key(BlockIdx i, BlockIdx j
     }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline std::pair<BlockIdx, BlockIdx> ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::blocks_from_key(
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline std::pair<BlockIdx, BlockIdx> ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::blocks_from_key(
     BoundaryKey key) const noexcept
 {
     static_assert(sizeof(std::pair<BlockIdx, BlockIdx>) == sizeof(BoundaryKey),
@@ -1074,10 +1092,10 @@ inline std::pair<BlockIdx, BlockIdx> ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcI
     return *reinterpret_cast<std::pair<BlockIdx, BlockIdx> *>(&key);
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 inline std::pair<std::list<
-    typename ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::BoundarySegment>, BlockIdx>
-ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::next_boundary_segment_set()
+    typename ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::BoundarySegment>, BlockIdx>
+ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::next_boundary_segment_set()
 {
     // NOTE: We assume the global lock is grabbed at this point so no other threads are scanning
     std::list<BoundarySegment> out;
@@ -1111,8 +1129,8 @@ ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::next_boundary_segment_set()
     return std::make_pair(out, out_idx);
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::unite_blocks(BlockIdx i, BlockIdx j)
+template<class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::unite_blocks(BlockIdx i, BlockIdx j)
 {
     std::replace(block_idxs.begin(), block_idxs.end(), j, i);
     auto& bi = blocks[i];
@@ -1125,8 +1143,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::unite_blocks(BlockId
     bi.uniqOrphansT += bj.uniqOrphansT;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraphFast()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::initGraphFast()
 {
     Node* x;
     TmpEdge* te;
@@ -1166,9 +1184,9 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::initGraphFast()
 }
 
 // @ret: minimum orphan level
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  int64_t ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augmentPath(NodeIdx i, Cap push)
+inline  int64_t ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::augmentPath(NodeIdx i, Cap push)
 {
     int64_t orphanMinLevel = (sTree ? topLevelS : topLevelT) + 1;
 
@@ -1214,9 +1232,9 @@ inline  int64_t ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augme
 }
 
 // @ret: minimum level in which created an orphan
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  int64_t ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augmentExcess(NodeIdx i, Cap push)
+inline  int64_t ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::augmentExcess(NodeIdx i, Cap push)
 {
     int64_t orphanMinLevel = (sTree ? topLevelS : topLevelT) + 1;
     augTimestamp++;
@@ -1308,9 +1326,9 @@ inline  int64_t ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augme
     return orphanMinLevel;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augmentExcesses()
+inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::augmentExcesses()
 {
     NodeIdx i;
     int64_t minOrphanLevel;
@@ -1339,11 +1357,13 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augmentE
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augment(ArcIdx bridge_idx)
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::augment(ArcIdx bridge_idx)
 {
     Arc& bridge = arcs[bridge_idx];
     Arc& sister_bridge = sister(bridge_idx);
+    // Labels are the distances to the terminals, so this includes the bridge and the terminal arcs
+    opCounter.augmentation(int64_t(nodes[sister_bridge.head].label) - nodes[bridge.head].label + 1);
     Cap bottleneck, bottleneckT, bottleneckS;
     bool forceBottleneck = false;
 
@@ -1430,9 +1450,9 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augment(
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption(
+inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::adoption(
     int64_t fromLevel, bool toTop)
 {
     ArcIdx ai;
@@ -1449,6 +1469,7 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption
         NodeIdx i;
         while ((i = orphanBuckets.popFront(level)) != INVALID_NODE) {
             Node& x = nodes[i];
+            opCounter.orphan();
             numOrphans++;
             if (x.lastAugTimestamp != augTimestamp) {
                 x.lastAugTimestamp = augTimestamp;
@@ -1478,6 +1499,7 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption
             if (x.label != (sTree ? 1 : -1)) {
                 minLabel = x.label - (sTree ? 1 : -1);
                 for (; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     Node& y = nodes[a.head];
                     if ((sTree ? a.isRevResidual : a.rCap) != 0 && y.label == minLabel) {
@@ -1488,6 +1510,7 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption
                 }
             }
             if (x.parent != INVALID_ARC) {
+                opCounter.adoption();
                 if (x.excess) {
                     excessBuckets.template add<sTree>(i);
                 }
@@ -1534,6 +1557,7 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption
             minLabel = (sTree ? topLevelS : -topLevelT);
             if (x.label != minLabel) {
                 for (ai = x.firstArc; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     const Node& y = nodes[a.head];
                     if ((sTree ? a.isRevResidual : a.rCap) &&
@@ -1553,6 +1577,8 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption
             // (3) relabel onto new parent
             //
             if (x.parent != INVALID_ARC) {
+                opCounter.adoption();
+                opCounter.relabel();
                 x.label = minLabel + (sTree ? 1 : -1);
                 add_sibling(i, arcs[x.parent].head);
                 // add to active list of the next growth phase
@@ -1582,9 +1608,9 @@ inline  void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption3Pass(int64_t minBucket)
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::adoption3Pass(int64_t minBucket)
 {
     int64_t minLabel, destLabel;
 
@@ -1599,6 +1625,7 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption3
                 minLabel = (sTree ? topLevelS : -topLevelT);
                 destLabel = x.label - (sTree ? 1 : -1);
                 for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     Arc& a = arcs[ai];
                     const Node& y = nodes[a.head];
                     if ((sTree ? a.isRevResidual : a.rCap) &&
@@ -1630,6 +1657,7 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption3
             if (x.label != (sTree ? topLevelS : -topLevelT)) {
                 minLabel = x.label + (sTree ? 1 : -1);
                 for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
+                    opCounter.arcs_scanned();
                     const Arc& a = arcs[ai];
                     Node& y = nodes[a.head];
 
@@ -1650,6 +1678,8 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption3
             }
 
             // relabel onto new parent
+            opCounter.adoption();
+            opCounter.relabel();
             add_sibling(i, arcs[x.parent].head);
             x.isParentCurr = false;
             if (x.excess) {
@@ -1672,9 +1702,9 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::adoption3
     orphan3PassBuckets.maxBucket = 0;
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool dirS>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::growth()
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::growth()
 {
     // TODO: This loop could be written in a better way
     NodeIdx i;
@@ -1686,10 +1716,12 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::growth()
         if (x.label != (dirS ? (topLevelS - 1) : -(topLevelT - 1))) {
             continue;
         }
+        opCounter.growth_step();
 
         // grow or augment
         ArcIdx a_end = nodes[i + 1].firstArc;
         for (ArcIdx ai = x.firstArc; ai != a_end; ai++) {
+            opCounter.arcs_scanned();
             Arc& a = arcs[ai];
             if (!(dirS ? a.rCap : a.isRevResidual)) {
                 continue;
@@ -1721,9 +1753,9 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::growth()
     }
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
 template<bool sTree>
-inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augmentIncrements()
+inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::augmentIncrements()
 {
     //NodeIdx* end = incList + incLen;
     int64_t minOrphanLevel = 1 << 30;
@@ -1785,10 +1817,13 @@ inline void ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::augmentIn
     augmentExcesses<sTree>();
 }
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow()
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::computeMaxFlow()
 {
     flow = 0;
+    for (auto& b : blocks) {
+        b.opCounter.reset();
+    }
 
     std::atomic<BlockIdx> processed_blocks = 0;
     std::vector<std::thread> threads;
@@ -1893,9 +1928,19 @@ inline Flow ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::computeMaxFlow()
     return flow;
 }
 
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline OpStats ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::getOpStats() const
+{
+    OpCounter<CountOps> total;
+    for (const auto& b : blocks) {
+        total.add(b.opCounter.get());
+    }
+    return total.get();
+}
+
 
-template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx>
-inline Flow ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx>::IbfsBlock::computeMaxFlow(
+template <class Cap, class Term, class Flow, class NodeIdx, class ArcIdx, bool CountOps>
+inline Flow ParallelIbfs<Cap, Term, Flow, NodeIdx, ArcIdx, CountOps>::IbfsBlock::computeMaxFlow(
     bool initialDirS, bool allowIncrements)
 {
     // incremental?
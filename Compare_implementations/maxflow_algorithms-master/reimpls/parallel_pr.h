@@ -56,6 +56,8 @@ public:
     void add_edge(NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap);
 
     TermType what_segment(NodeIdx i);
+    // Same as what_segment for all nodes: cut[i] = 1 if node i is on the SOURCE side and 0 otherwise
+    void get_cut(std::vector<uint8_t>& cut) const;
 
     void mincut();
     void global_relabel();
@@ -180,6 +182,16 @@ ParallelPushRelabel<Cap, Flow, ArcIdx, NodeIdx>::what_segment(NodeIdx i)
     return nodes[i].label >= nodes.size() - 2 ? SOURCE : SINK;
 }
 
+template<class Cap, class Flow, class ArcIdx, class NodeIdx>
+inline void ParallelPushRelabel<Cap, Flow, ArcIdx, NodeIdx>::get_cut(std::vector<uint8_t>& cut) const
+{
+    const size_t gap = nodes.size() - 2;
+    cut.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        cut[i] = nodes[i].label >= gap ? 1 : 0;
+    }
+}
+
 template<class Cap, class Flow, class ArcIdx, class NodeIdx>
 inline void ParallelPushRelabel<Cap, Flow, ArcIdx, NodeIdx>::mincut()
 {
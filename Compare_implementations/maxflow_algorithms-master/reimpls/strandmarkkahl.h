@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <numeric>
 #include <tuple>
+#include <utility>
 #include <thread>
 #include <iostream> // DEBUG
 #include <cassert>
@@ -16,6 +17,7 @@
 
 #include "graph.h"
 #include "util.h"
+#include "../op_stats.h"
 
 namespace reimpls {
 
@@ -24,7 +26,7 @@ namespace reimpls {
  *     Parallel and Distributed Graph Cuts by Dual Decomposition
  *     Strandmark, P., Kahl, F., 2010, CVPR
  */
-template <class Cap, class Term, class Flow, class NodeIdx = int32_t>
+template <class Cap, class Term, class Flow, class NodeIdx = int32_t, bool CountOps = false>
 class ParallelSkGraph {
     using BlockIdx = int16_t;
 
@@ -34,6 +36,8 @@ class ParallelSkGraph {
     static constexpr BlockIdx INVALID_BLOCK = std::numeric_limits<BlockIdx>::max();
     static constexpr NodeIdx INVALID_NODE = std::numeric_limits<NodeIdx>::max();
 
+    using BlockGraph = reimpls::Graph<Cap, Term, Flow, int32_t, int32_t, CountOps>;
+
     static constexpr bool INTEGER_CAPACITIES = std::is_integral<Cap>::value || std::is_integral<Term>::value;
 
 public:
@@ -46,6 +50,8 @@ public:
     void add_tweights(NodeIdx i, Term source_cap, Term sink_cap);
 
     int what_segment(NodeIdx i, int default_segment = SOURCE); // TODO: Use an enum
+    // Same as what_segment for all nodes: cut[i] = 1 if node i is in the SOURCE segment and 0 otherwise
+    void get_cut(std::vector<uint8_t>& cut, int default_segment = SOURCE) const;
 
     Flow maxflow();
 
@@ -54,13 +60,18 @@ public:
     inline unsigned int get_max_iter() const noexcept { return max_iter; }
     inline void set_max_iter(unsigned int mi) const noexcept { max_iter = mi; }
 
+    // Operation counts of all block maxflow calls of the last maxflow, all zero unless CountOps is true
+    OpStats get_op_stats() const { return op_counter.get(); }
+
 private:
     Flow flow;
 
     unsigned int iter;
     unsigned int max_iter;
 
-    std::vector<std::shared_ptr<reimpls::Graph<Cap, Term, Flow>>> blocks;
+    OpCounter<CountOps> op_counter;
+
+    std::vector<std::shared_ptr<BlockGraph>> blocks;
 
     size_t expected_edges_per_block;
     std::vector<BlockIdx> node_blocks;
@@ -73,6 +84,7 @@ private:
         BlockIdx b1, BlockIdx b2, NodeIdx offset1, NodeIdx offset2);
 
     NodeIdx shared_index(NodeIdx i) const;
+    std::pair<BlockIdx, NodeIdx> first_block_offset(NodeIdx i) const;
     inline bool is_shared(NodeIdx i) const { return node_offsets[i] < 0; }
 
     NodeIdx get_block_offset(NodeIdx node, BlockIdx b) const;
@@ -80,8 +92,8 @@ private:
 
 };
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline ParallelSkGraph<Cap, Term, Flow, NodeIdx>::ParallelSkGraph(
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::ParallelSkGraph(
     size_t expected_nodes, size_t expected_edges_per_block) :
     flow(0),
     iter(0),
@@ -98,15 +110,15 @@ inline ParallelSkGraph<Cap, Term, Flow, NodeIdx>::ParallelSkGraph(
     node_offsets.reserve(expected_nodes);
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_node(NodeIdx num)
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::add_node(NodeIdx num)
 {
     node_blocks.resize(num);
     node_offsets.resize(num, INVALID_NODE); // Need to init. so we can tell if node is shared
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_nodes_to_block(
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::add_nodes_to_block(
     NodeIdx begin, NodeIdx end, BlockIdx b)
 {
     if (b >= blocks.size()) {
@@ -114,7 +126,7 @@ inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_nodes_to_block(
     }
     if (blocks[b] == nullptr) {
         //blocks[b] = std::make_shared<bk::Graph<Cap, Term, Flow>>(end - begin, 0, bk_error_handler);
-        blocks[b] = std::make_shared<reimpls::Graph<Cap, Term, Flow>>(end - begin, expected_edges_per_block);
+        blocks[b] = std::make_shared<BlockGraph>(end - begin, expected_edges_per_block);
     }
 
     NodeIdx offset = begin - blocks[b]->add_node(end - begin);
@@ -142,8 +154,8 @@ inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_nodes_to_block(
     }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_edge(NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap)
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::add_edge(NodeIdx i, NodeIdx j, Cap cap, Cap rev_cap)
 {
     assert(i != j);
     assert(cap >= 0);
@@ -180,8 +192,8 @@ inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_edge(NodeIdx i, NodeI
     }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_tweights(
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::add_tweights(
     NodeIdx i, Term source_cap, Term sink_cap)
 {
     if (node_offsets[i] >= 0) {
@@ -210,14 +222,40 @@ inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::add_tweights(
     }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline int ParallelSkGraph<Cap, Term, Flow, NodeIdx>::what_segment(NodeIdx i, int default_segment)
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline int ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::what_segment(NodeIdx i, int default_segment)
 {
-    return blocks[node_blocks[i][0]]->what_segment(i - node_offsets[i][0], default_segment);
+    using BlockTermType = typename BlockGraph::TermType;
+    BlockIdx b;
+    NodeIdx offset;
+    std::tie(b, offset) = first_block_offset(i);
+    return blocks[b]->what_segment(i - offset, static_cast<BlockTermType>(default_segment));
+}
+
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::get_cut(std::vector<uint8_t>& cut, int default_segment) const
+{
+    using BlockTermType = typename BlockGraph::TermType;
+
+    // Once the blocks agree, every copy of a shared node is in the same segment, so the first one is used
+    std::vector<std::vector<uint8_t>> block_cuts(blocks.size());
+    for (BlockIdx b = 0; b < blocks.size(); ++b) {
+        if (blocks[b] != nullptr) {
+            blocks[b]->get_cut(block_cuts[b], static_cast<BlockTermType>(default_segment));
+        }
+    }
+
+    cut.resize(node_offsets.size());
+    for (NodeIdx i = 0; i < node_offsets.size(); ++i) {
+        BlockIdx b;
+        NodeIdx offset;
+        std::tie(b, offset) = first_block_offset(i);
+        cut[i] = block_cuts[b][i - offset];
+    }
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline Flow ParallelSkGraph<Cap, Term, Flow, NodeIdx>::maxflow()
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline Flow ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::maxflow()
 {
     Cap stepsize = 10;
 
@@ -225,6 +263,7 @@ inline Flow ParallelSkGraph<Cap, Term, Flow, NodeIdx>::maxflow()
 
     bool running = true;
     std::vector<Flow> block_flows(blocks.size(), 0);
+    std::vector<OpCounter<CountOps>> block_ops(blocks.size());
     std::vector<std::thread> threads;
 
     // Bookkeeping for steps
@@ -241,6 +280,7 @@ inline Flow ParallelSkGraph<Cap, Term, Flow, NodeIdx>::maxflow()
                 // First maxflow without reusing trees, then enable it
                 // This is essential for good performance
                 block_flows[t] = blocks[t]->maxflow(reuse_trees);
+                block_ops[t].add(blocks[t]->get_op_stats());
                 reuse_trees = true;
 
                 // Wait for all workers to finish
@@ -293,6 +333,10 @@ inline Flow ParallelSkGraph<Cap, Term, Flow, NodeIdx>::maxflow()
 
     // Sum up all subgraph flows
     flow = std::accumulate(block_flows.begin(), block_flows.end(), 0);
+    op_counter.reset();
+    for (const auto& ops : block_ops) {
+        op_counter.add(ops.get());
+    }
 
     // Wait for all theads to completely finish
     for (auto& t : threads) {
@@ -304,8 +348,8 @@ inline Flow ParallelSkGraph<Cap, Term, Flow, NodeIdx>::maxflow()
     return flow;
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::update_graph(
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::update_graph(
     NodeIdx i, int diff, int prev_diff, Cap& step, uint8_t& has_flipped,
     BlockIdx b1, BlockIdx b2, NodeIdx offset1, NodeIdx offset2)
 {
@@ -335,15 +379,26 @@ inline void ParallelSkGraph<Cap, Term, Flow, NodeIdx>::update_graph(
     blocks[b2]->mark_node(i - offset2);
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline NodeIdx ParallelSkGraph<Cap, Term, Flow, NodeIdx>::shared_index(NodeIdx i) const
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline NodeIdx ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::shared_index(NodeIdx i) const
 {
     assert(is_shared(i));
     return -node_offsets[i] - 1;
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
-inline NodeIdx ParallelSkGraph<Cap, Term, Flow, NodeIdx>::get_block_offset(NodeIdx node, BlockIdx b) const
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline std::pair<typename ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::BlockIdx, NodeIdx>
+ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::first_block_offset(NodeIdx i) const
+{
+    if (is_shared(i)) {
+        NodeIdx si = shared_index(i);
+        return std::make_pair(shared_node_blocks[si][0], shared_node_offsets[si][0]);
+    }
+    return std::make_pair(node_blocks[i], node_offsets[i]);
+}
+
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
+inline NodeIdx ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::get_block_offset(NodeIdx node, BlockIdx b) const
 {
     NodeIdx si = shared_index(node);
     for (int i = 0; i < shared_node_blocks[si].size(); ++i) {
@@ -355,10 +410,10 @@ inline NodeIdx ParallelSkGraph<Cap, Term, Flow, NodeIdx>::get_block_offset(NodeI
     throw std::runtime_error("Node is not in given block");
 }
 
-template<class Cap, class Term, class Flow, class NodeIdx>
+template<class Cap, class Term, class Flow, class NodeIdx, bool CountOps>
 inline std::vector<
-    std::tuple<typename ParallelSkGraph<Cap, Term, Flow, NodeIdx>::BlockIdx, NodeIdx, NodeIdx>>
-ParallelSkGraph<Cap, Term, Flow, NodeIdx>::get_shared_block_offsets(NodeIdx i, NodeIdx j) const
+    std::tuple<typename ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::BlockIdx, NodeIdx, NodeIdx>>
+ParallelSkGraph<Cap, Term, Flow, NodeIdx, CountOps>::get_shared_block_offsets(NodeIdx i, NodeIdx j) const
 {
     std::vector<std::tuple<BlockIdx, NodeIdx, NodeIdx>> out;
     // We just use a naive search since all vectors are very short
@@ -76,6 +76,7 @@ mutex globalMx;
 #include "sequence.h"
 #include "parallel.h"
 #include "maxFlow.h"
+#include "../phase_trace.h"
 //#include "blockRadixSort.h"
 
 #ifdef SPPR_HAS_TBB
@@ -301,6 +302,7 @@ void increaseArcFlow(Arc& a, Cap delta) {
 //#include "dinic.C"
 
 void init() {
+    TRACE_PHASE(INIT);
     // n, m, source, sink and the graph structure stored in nodes, arcs must be
     // initialized already
     pushBuffer = new pair<ll,Cap>[m + n];
@@ -449,6 +451,7 @@ void revBfs(intT *frontier, intT sz, intT d, intT exclude) {
 }
 
 void globalRelabel() {
+    TRACE_PHASE(GLOBAL_RELABEL);
     //cout << "global relabeling (low = " << lowestChangedLabel << ") ... " << flush;
     //cout << "hiLabel=" << hiLabel <<    endl;
     workSinceUpdate = 0;
@@ -691,6 +694,9 @@ array<ll, 2> processNode(intT i, intT vi) {
 #endif
         intT newh = hiLabel;
         bool skipped = 0;
+        // An active neighbor may push to v in this round, after v has been relabeled. That push needs its label to
+        // be vorig.h + 1 and makes the arc back to it residual, so v may not be relabeled above vorig.h + 2
+        bool mayReceive = 0;
         //for_arcs(for, v, cur, {
         for (intT _i = v.first; _i < v.last(); ++_i) {
             Arc& cur = arcs[_i];
@@ -717,6 +723,8 @@ array<ll, 2> processNode(intT i, intT vi) {
                     skipped = 1;
                     continue;
                 }
+                if (cur.revResCap && wi != sink && w.h < hiLabel)
+                    mayReceive = 1;
             }
 //#endif
 
@@ -801,6 +809,12 @@ array<ll, 2> processNode(intT i, intT vi) {
             });
 #endif
 
+            if (mayReceive) {
+                newh = min(newh, vorig.h + 2);
+                // Wait for the next round, which sees the pushes of this one
+                if (newh <= v.h) goto done;
+            }
+
 #if GAP_HEURISTIC
             if (newh < hiLabel) {
                 *v.relabels++ = v.h;
@@ -845,6 +859,7 @@ done:
 #endif
 
 void run() {
+    TRACE_PHASE(SOLVE);
 #if !_OPENMP
     otherWork.set_value(0);
     satPushes.set_value(0);
@@ -960,10 +975,13 @@ void run() {
         //cout << "ITER" << endl;
         discharges += wSetSize;
         array<ll,2> *infos = new array<ll,2>[wSetSize];
-        sppr_parallel_for (intT i = 0; i < wSetSize; ++i) {
-            intT vi = wSet[i];
-            infos[i] = processNode(i, vi);
-            bufSize[i] = nodes[vi].pushesEnd - nodes[vi].pushes;
+        {
+            TRACE_PHASE(DISCHARGE);
+            sppr_parallel_for (intT i = 0; i < wSetSize; ++i) {
+                intT vi = wSet[i];
+                infos[i] = processNode(i, vi);
+                bufSize[i] = nodes[vi].pushesEnd - nodes[vi].pushes;
+            }
         }
         phaseTime[0].stop();
         phaseTime[7].stop();
@@ -1175,7 +1193,7 @@ void prepareMaxFlow(FlowGraph<intT>& g) {
             //cout << i << " -> " << to << " (" << c << ")" << endl;
         //}
     //}
-    sppr_parallel_for (intT i = 1; i < n; ++i) {
+    sppr_parallel_for (intT i = 1; i < g.g.n; ++i) {
         ass(g.g.V[i].Neighbors == g.g.V[i - 1].Neighbors + g.g.V[i - 1].degree);
         ass(g.g.V[i].nghWeights == g.g.V[i - 1].nghWeights + g.g.V[i - 1].degree);
     }
@@ -1260,6 +1278,26 @@ void prepareMaxFlow(FlowGraph<intT>& g) {
     //cout << "init time: " << timeInit.total() << endl;
 }
 
+intT solveMaxFlow() {
+    run();
+    return nodes[sink].e;
+}
+
+void getMinCut(unsigned char *cut) {
+    // The nodes which cannot reach the sink in the residual graph are on the
+    // source side. A full global relabel is a parallel backward BFS from the
+    // sink which leaves exactly those at hiLabel
+    lowestChangedLabel = 0;
+    globalRelabel();
+    sppr_parallel_for (intT i = 0; i < n; ++i) cut[i] = nodes[i].h >= hiLabel;
+}
+
+void freeMaxFlow() {
+    deinit();
+    delete[] nodes;
+    delete[] arcs;
+}
+
 intT maxFlow() {
     //beforeHook();
     run();
@@ -16,6 +16,16 @@ void prepareMaxFlow(FlowGraph<intT>& g);
 // maximum flow / minimum cut
 intT maxFlow();
 
+// Same as maxFlow(), but keeps the graph and work buffers so the minimum
+// cut can be read with getMinCut. freeMaxFlow must be called afterwards
+intT solveMaxFlow();
+
+// Stores the minimum cut found by solveMaxFlow in cut[0..n-1]: cut[i] is 1
+// if node i is on the source side and 0 otherwise
+void getMinCut(unsigned char *cut);
+
+void freeMaxFlow();
+
 // g will be modified by the algorithm to contain the flow values
 // on each edge, the return value will be the value of the
 // maximum flow / minimum cut
@@ -0,0 +1,112 @@
+#!/bin/bash
+
+# Thread-Sweep fuer die parallelen Solver von maxflow-master (ppr, prs, aos).
+# Jeder Solver wird fuer jede Threadanzahl mehrmals mit "-p <threads>" gestartet. Die CSV-Datei hat dieselben
+# Spalten wie die scaling_file von bench (maxflow_algorithms-master), damit beide Tabellen zusammen ausgewertet
+# werden koennen.
+#
+# maxflow gibt die Zeiten in ganzen ms aus, die Instanzen sollten also deutlich laenger laufen. Bei einer Zeit von
+# 0 ms bleiben speedup und efficiency leer.
+#
+# Aufruf: run_maxflow_scaling.sh <maxflow> <output.csv> <input.max>...
+
+if [ $# -lt 3 ]; then
+    echo "Usage: $0 <path/to/maxflow> <output.csv> <input.max>..."
+    exit 1
+fi
+
+program_path="$1"
+output_csv="$2"
+shift 2
+
+# Parallele Solver und Threadanzahlen des Sweeps
+solvers=(ppr prs aos)
+threads=(1 2 4 8)
+
+# Serielle Solver, der schnellste davon ist die Referenz fuer speedup_vs_serial
+serial_solvers=(prh ao din)
+
+# Anzahl der Durchlaeufe pro Messpunkt, verglichen wird der Median der Loesungszeit
+runs=5
+
+# Loader von maxflow-master (hash, sort oder csr), wird als "load" eingetragen
+loader="hash"
+
+# maxflow-master rechnet mit uint64_t Kapazitaeten und uint32_t Knoten. bench schreibt die Typen als typeid Namen.
+types="m,m,m,j"
+
+# Median der Loesungszeit in Sekunden fuer einen Solver, gibt "<median> <fluss>" aus
+median_solve_time() {
+    local solver="$1" input_file="$2" thread_count="$3"
+    local times=() flow=""
+    for ((run = 0; run < runs; run++)); do
+        local output
+        if ! output=$("$program_path" "$solver" -f "$input_file" -p "$thread_count" -l "$loader"); then
+            echo "Error running $solver with $thread_count threads on $input_file" >&2
+            return 1
+        fi
+        times+=("$(echo "$output" | grep "time solve:" | awk '{print $3}')")
+        local run_flow
+        run_flow=$(echo "$output" | grep "^flow:" | awk '{print $2}')
+        if [ -n "$flow" ] && [ "$flow" != "$run_flow" ]; then
+            echo "Warning: $solver gives flow $run_flow and $flow on $input_file" >&2
+        fi
+        flow="$run_flow"
+    done
+    # Zeiten sind in ms
+    printf "%s\n" "${times[@]}" | sort -g | awk -v flow="$flow" '
+        { t[NR] = $1 }
+        END {
+            m = NR % 2 ? t[(NR + 1) / 2] : (t[NR / 2] + t[NR / 2 + 1]) / 2
+            printf "%.6f %s\n", m / 1000, flow
+        }'
+}
+
+echo "bench_name,file_name,load,algorithm,cap_type,term_type,flow_type,index_type,num_threads,num_blocks,solve_time_median,speedup,efficiency,best_serial,speedup_vs_serial" > "$output_csv"
+
+for input_file in "$@"; do
+    if [ ! -f "$input_file" ]; then
+        echo "No such file: $input_file" >&2
+        continue
+    fi
+    file_name=$(basename "$input_file")
+
+    # Schnellster serieller Solver als Referenz
+    best_serial=""
+    best_serial_time=""
+    serial_flow=""
+    for solver in "${serial_solvers[@]}"; do
+        read -r time flow < <(median_solve_time "$solver" "$input_file" 1) || continue
+        serial_flow="$flow"
+        if [ -z "$best_serial" ] || awk "BEGIN { exit !($time < $best_serial_time) }"; then
+            best_serial="$solver"
+            best_serial_time="$time"
+        fi
+    done
+
+    for solver in "${solvers[@]}"; do
+        base_threads=""
+        base_time=""
+        echo "Scaling of $solver on $file_name, relative to ${threads[0]} thread(s) and to $best_serial:"
+        for thread_count in "${threads[@]}"; do
+            read -r time flow < <(median_solve_time "$solver" "$input_file" "$thread_count") || continue
+            if [ -n "$serial_flow" ] && [ "$flow" != "$serial_flow" ]; then
+                echo "Warning: $solver with $thread_count threads gives flow $flow, $best_serial gives $serial_flow" >&2
+            fi
+            if [ -z "$base_time" ]; then
+                base_threads="$thread_count"
+                base_time="$time"
+            fi
+            row=$(awk -v base="$base_time" -v t="$time" -v bt="$base_threads" -v th="$thread_count" \
+                -v best="$best_serial" -v best_t="$best_serial_time" '
+                BEGIN {
+                    speedup = t > 0 ? sprintf("%g", base / t) : ""
+                    efficiency = t > 0 ? sprintf("%g", base / t * bt / th) : ""
+                    vs_serial = best != "" && t > 0 ? sprintf("%g", best_t / t) : ""
+                    printf "%s,%s,%s,%s", speedup, efficiency, best, vs_serial
+                }')
+            echo "maxflow-master,$file_name,$loader,$solver,$types,$thread_count,0,$time,$row" >> "$output_csv"
+            echo "    threads: $thread_count, median: $time s, speedup,efficiency,serial,vs_serial: $row"
+        done
+    done
+done